@@ -8,6 +8,9 @@
 
 #pragma once // #include το πολύ μία φορά
 
+#include <stddef.h>
+#include <stdint.h>
+
 #include "common_types.h"
 
 
@@ -23,9 +26,33 @@ typedef struct map* Map;
 
 Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value);
 
+// Όπως η map_create, αλλά το map δημιουργείται με αρκετό χώρο για expected στοιχεία (βλέπε map_reserve).
+
+Map map_create_sized(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value, size_t expected);
+
+// Μεγαλώνει το map (αν χρειάζεται) ώστε να χωράει συνολικά n στοιχεία χωρίς rehash, δηλαδή ο πίνακας
+// δεσμεύεται μία φορά αντί για τα ~log2(n) διαδοχικά rehash των εισαγωγών. Στις UsingHopscotchHash και
+// UsingCuckooHash μπορεί να χρειαστεί ακόμα rehash, αν κάποιο key δε βρίσκει θέση κοντά στη δική του.
+
+void map_reserve(Map map, size_t n);
+
+// Ξαναχτίζει το map στη μικρότερη χωρητικότητα στην οποία χωράνε τα στοιχεία του (χωρίς να μεγαλώσει),
+// αφαιρώντας τις θέσεις που είναι σημαδεμένες ως διαγραμμένες και αποδεσμεύοντας τη μνήμη που δε
+// χρειάζεται πλέον (πχ άδεια blocks αλυσίδων). Ο χώρος που δεσμεύτηκε με τη map_reserve δεν διατηρείται.
+//
+// Επιπλέον, η map_remove μικραίνει αυτόματα το map όταν ο load factor πέσει κάτω από 1/8, σε χωρητικότητα
+// για τα διπλάσια στοιχεία (αλλά όχι κάτω από τον χώρο της map_reserve). Ο νέος load factor είναι έτσι αρκετά
+// μακριά και από τα δύο όρια (1/8 και το μέγιστο της υλοποίησης), ώστε λίγες εισαγωγές και διαγραφές γύρω από
+// κάποιο από αυτά να μην προκαλούν διαδοχικά rehash. Όπως και μετά από map_insert,
+// οι κόμβοι (MapNode) που είχαν επιστραφεί πριν από map_remove ή map_compact δεν είναι πλέον έγκυροι.
+
+void map_compact(Map map);
+
 // Επιστρέφει τον αριθμό στοιχείων που περιέχει το map.
+// Η map_size64 επιστρέφει το ίδιο σε size_t, για maps που μπορεί να έχουν περισσότερα από INT_MAX στοιχεία.
 
 int map_size(Map map);
+size_t map_size64(Map map);
 
 // Προσθέτει το κλειδί key με τιμή value. Αν υπάρχει κλειδί ισοδύναμο με key, τα παλιά key & value αντικαθίσταται από τα νέα.
 //
@@ -35,6 +62,13 @@ int map_size(Map map);
 
 void map_insert(Map map, Pointer key, Pointer value);
 
+// Ισοδύναμο με map_insert(map, keys[i], values[i]) για i = 0, ..., n-1 (με αυτή τη σειρά), αλλά ο χώρος
+// δεσμεύεται μία φορά για όλα τα στοιχεία και τα hash codes υπολογίζονται πριν από τις εισαγωγές, ώστε
+// η θέση κάθε key να φορτώνεται στην cache (prefetch) λίγες εισαγωγές πριν χρειαστεί. Αν values == NULL,
+// όλα τα keys εισάγονται με τιμή NULL.
+
+void map_insert_batch(Map map, Pointer* keys, Pointer* values, size_t n);
+
 // Αφαιρεί το κλειδί που είναι ισοδύναμο με key από το map, αν υπάρχει.
 // Επιστρέφει true αν βρέθηκε τέτοιο κλειδί, διαφορετικά false.
 
@@ -47,6 +81,16 @@ bool map_remove(Map map, Pointer key);
 
 Pointer map_find(Map map, Pointer key);
 
+// Θέτει out_values[i] = map_find(map, keys[i]) για i = 0, ..., n-1. Οι αναζητήσεις εκτελούνται εναλλάξ
+// (λίγα βήματα της καθεμίας τη φορά), ώστε οι αναμονές για τη μνήμη πολλών αναζητήσεων να επικαλύπτονται.
+// Ωφελεί σε maps πολύ μεγαλύτερα από την cache. Σε μικρά maps οι διαδοχικές map_find είναι συνήθως ταχύτερες.
+//
+// Εκτελούνται έως FIND_BATCH_WIDTH αναζητήσεις ταυτόχρονα (AMAC: asynchronous memory access chaining). Κάθε βήμα
+// μιας αναζήτησης κάνει prefetch τη μνήμη που θα χρειαστεί το επόμενό της, και μέχρι να ξαναέρθει η σειρά της
+// εκτελείται ένα βήμα από κάθε άλλη αναζήτηση. Τι ελέγχει κάθε βήμα εξαρτάται από την υλοποίηση.
+
+void map_find_batch(Map map, Pointer* keys, Pointer* out_values, size_t n);
+
 // Αλλάζει τη συνάρτηση που καλείται σε κάθε αφαίρεση/αντικατάσταση key/value.
 // Επιστρέφει την προηγούμενη τιμή της συνάρτησης.
 
@@ -90,6 +134,29 @@ Pointer map_node_value(Map map, MapNode node);
 
 MapNode map_find_node(Map map, Pointer key);
 
+// Επιστρέφει τον κόμβο του key, ή, αν το key δεν υπάρχει, το προσθέτει με τιμή NULL και επιστρέφει τον νέο
+// κόμβο. Αν inserted != NULL, το *inserted γίνεται true αν έγινε εισαγωγή, διαφορετικά false. Ισοδύναμο με
+// map_find_node και (αν δε βρεθεί) map_insert, αλλά το hash code υπολογίζεται μία φορά και ο πίνακας
+// διασχίζεται μία φορά (εκτός αν η εισαγωγή προκαλέσει rehash). Αν το key υπάρχει ήδη, ο κόμβος κρατάει
+// το παλιό key, και για το key που δόθηκε δεν καλείται η destroy_key.
+
+MapNode map_find_or_insert(Map map, Pointer key, bool* inserted);
+
+// Όπως η map_find_or_insert, αλλά ο νέος κόμβος παίρνει τιμή create_value(key). Η create_value καλείται
+// μόνο αν το key δεν υπάρχει, και δεν πρέπει να μεταβάλλει το map. Πχ για μετρητές:
+//
+//   MapNode node = map_find_or_insert_with(map, word, create_zero, NULL);
+//   (*(int*)map_node_value(map, node))++;
+
+typedef Pointer (*CreateValueFunc)(Pointer key);
+
+MapNode map_find_or_insert_with(Map map, Pointer key, CreateValueFunc create_value, bool* inserted);
+
+// Αλλάζει την τιμή του κόμβου node σε value. Αν destroy_value != NULL, καλείται για την παλιά τιμή
+// (αν είναι διαφορετική από τη value).
+
+void map_node_set_value(Map map, MapNode node, Pointer value);
+
 
 //// Επιπλέον συναρτήσεις για υλοποιήσεις βασισμένες σε hashing ////////////////////////////
 
@@ -103,9 +170,95 @@ uint hash_string(Pointer value);		// Χρήση όταν το key είναι cha
 uint hash_int(Pointer value);			// Χρήση όταν το key είναι int*
 uint hash_pointer(Pointer value);		// Χρήση όταν το key είναι pointer που θεωρείται διαφορετικός από οποιονδήποτε άλλο pointer
 
+// Οι hash_int και hash_pointer επιστρέφουν την ίδια την τιμή, οπότε διαδοχικοί ακέραιοι ή ευθυγραμμισμένοι pointers
+// καταλήγουν σε γειτονικές θέσεις και σχηματίζουν clusters. Οι παρακάτω ανακατεύουν πρώτα τα bits της τιμής
+// (κάθε bit της εισόδου επηρεάζει όλα τα bits του αποτελέσματος), με λίγο μεγαλύτερο κόστος.
+
+uint hash_int_mixed(Pointer value);		// Όπως η hash_int (MurmurHash3 finalizer)
+uint hash_pointer_mixed(Pointer value);	// Όπως η hash_pointer (splitmix64 finalizer)
+
+// Η hash_string διαβάζει ένα byte τη φορά. Η hash_string_fast διαβάζει 8 bytes τη φορά (και 64 με AVX2),
+// οπότε είναι πολύ γρηγορότερη για strings μεγαλύτερα από ~16 bytes (πχ URLs, paths), και δίνει καλύτερη
+// διασπορά. Η hash_string_len κάνει το ίδιο για τα length bytes που ξεκινούν από το value (χωρίς strlen),
+// για χρήση μέσα σε συναρτήσεις κατακερματισμού κλειδιών που γνωρίζουν ήδη το μήκος τους.
+
+uint hash_string_fast(Pointer value);					// Χρήση όταν το key είναι char*
+uint hash_string_len(Pointer value, size_t length);
+
 // Ορίζει τη συνάρτηση κατακερματισμού hash για το συγκεκριμένο map
 // Πρέπει να κληθεί μετά την map_create και πριν από οποιαδήποτε άλλη συνάρτηση.
 // Όπως και με την συνάρτηση compare, αλλαγές στο περιεχόμενο των keys δεν θα πρέπει να αλλάζουν την
 // τιμή που επιστρέφει η συνάρτηση κατακερματισμού, διαφορετικά η συμπεριφορά είναι μη ορισμένη.
 
 void map_set_hash_function(Map map, HashFunc hash_func);
+
+// Συναρτήσεις κατακερματισμού 64 bits /////////////////////////////////////////////////////
+//
+// Με hash codes των 32 bits, τα keys ενός map με εκατοντάδες εκατομμύρια στοιχεία έχουν πολλά κοινά
+// hash codes (και ένας πίνακας πάνω από 2^32 θέσεις δεν μπορεί καν να χρησιμοποιήσει όλες τις θέσεις του).
+// Για τόσο μεγάλα maps, ορίζουμε με την map_set_hash_function64 μια συνάρτηση που επιστρέφει 64 bits,
+// αντί για τη map_set_hash_function (ισχύει όποια από τις δύο κλήθηκε τελευταία).
+
+typedef uint64_t (*HashFunc64)(Pointer);
+
+uint64_t hash_string64(Pointer value);					// Όπως η hash_string_fast
+uint64_t hash_string_len64(Pointer value, size_t length);	// Όπως η hash_string_len
+uint64_t hash_int64(Pointer value);						// Όπως η hash_int_mixed
+uint64_t hash_pointer64(Pointer value);					// Όπως η hash_pointer_mixed
+
+void map_set_hash_function64(Map map, HashFunc64 hash_func);
+
+
+//// Πολιτική χωρητικότητας ////////////////////////////////////////////////////////////////
+//
+// Από προεπιλογή οι χωρητικότητες είναι πρώτοι αριθμοί και η θέση ενός key είναι hash % capacity,
+// δηλαδή μια διαίρεση (δεκάδες κύκλοι) σε κάθε πράξη. Με MAP_CAPACITY_POW2 οι χωρητικότητες είναι
+// δυνάμεις του 2 και η θέση είναι τα υψηλότερα bits του hash * 2^64/φ (Fibonacci hashing), δηλαδή
+// ένας πολλαπλασιασμός και ένα shift. Ο πολλαπλασιασμός ανακατεύει τα bits, οπότε και συναρτήσεις
+// όπως η hash_int δίνουν καλή διασπορά. Οι υλοποιήσεις που χρησιμοποιούν ήδη δυνάμεις του 2
+// (UsingSwissTable, UsingCuckooHash, UsingDenseHash) αγνοούν την πολιτική.
+
+typedef enum {
+	MAP_CAPACITY_PRIME,		// Πρώτοι αριθμοί (προεπιλογή)
+	MAP_CAPACITY_POW2,		// Δυνάμεις του 2, με Fibonacci hashing
+} MapCapacityPolicy;
+
+// Ορίζει την πολιτική χωρητικότητας του map (ο χώρος που δεσμεύτηκε με τη map_create_sized διατηρείται).
+// Πρέπει να κληθεί μετά την map_create και πριν από οποιαδήποτε εισαγωγή (σε map με στοιχεία δεν αλλάζει τίποτα).
+
+void map_set_capacity_policy(Map map, MapCapacityPolicy policy);
+
+// Ορίζει το μέγεθος της γειτονιάς (16 έως 32 θέσεις) στις υλοποιήσεις όπου κάθε key αποθηκεύεται σε μία από
+// τις θέσεις που ακολουθούν τη θέση που κάνει hash (UsingHopscotchHash). Με μικρότερη γειτονιά οι αναζητήσεις
+// εξετάζουν λιγότερες θέσεις, αλλά σε υψηλό load factor η εισαγωγή βρίσκει δυσκολότερα θέση (και κάνει rehash).
+// Οι υπόλοιπες υλοποιήσεις την αγνοούν. Πρέπει να κληθεί μετά την map_create και πριν από οποιαδήποτε εισαγωγή.
+
+void map_set_neighbourhood(Map map, int neighbourhood);
+
+
+//// Στατιστικά ///////////////////////////////////////////////////////////////////////////
+//
+// Περιγράφουν την εσωτερική κατάσταση του map, ώστε να φαίνεται αν οι αργές πράξεις οφείλονται
+// πχ σε clustering (κακή συνάρτηση κατακερματισμού) ή σε μεγάλες αλυσίδες. Τα πεδία που δεν έχουν
+// νόημα για μια υλοποίηση είναι 0.
+
+// Πλήθος θέσεων των ιστογραμμάτων του MapStats. Η τελευταία θέση μετράει και όλες τις μεγαλύτερες τιμές.
+#define MAP_STATS_HISTOGRAM 16
+
+typedef struct {
+	size_t size;						// Όσο και η map_size64
+	size_t capacity;					// Θέσεις του κύριου πίνακα
+	double load_factor;					// size / capacity
+	size_t tombstones;					// Θέσεις που είναι σημαδεμένες ως διαγραμμένες
+	size_t probe_lengths[MAP_STATS_HISTOGRAM];	// probe_lengths[i]: πόσα στοιχεία απέχουν i βήματα από την αρχική
+										// τους θέση (θέσεις, groups ή buckets, ανάλογα με την υλοποίηση)
+	size_t chain_lengths[MAP_STATS_HISTOGRAM];	// chain_lengths[i]: πόσες θέσεις έχουν αλυσίδα υπερχείλισης με i στοιχεία
+	long displacements;					// Πόσες φορές μετακινήθηκε στοιχείο για να χωρέσει κάποιο άλλο
+	int rehashes;						// Πόσες φορές έχει ξαναχτιστεί ο πίνακας (rehash)
+	size_t bytes;						// Η μνήμη που δεσμεύει το ίδιο το map (χωρίς τα keys/values)
+} MapStats;
+
+// Συμπληρώνει το stats με τα τρέχοντα στατιστικά του map. Η πολυπλοκότητα είναι γραμμική ως προς τη
+// χωρητικότητα, οπότε δεν προορίζεται για κλήση σε κάθε πράξη.
+
+void map_stats(Map map, MapStats* stats);
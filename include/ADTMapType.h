@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////
+//
+// Typed Map
+//
+// Map με keys και values συγκεκριμένων τύπων, που αποθηκεύονται απευθείας
+// μέσα στον πίνακα (χωρίς Pointer και χωρίς malloc για κάθε στοιχείο).
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "common_types.h"
+
+
+// Στο ADT Map κάθε key και value είναι Pointer, οπότε πχ ένα map int => int δεσμεύει δύο ints για κάθε
+// στοιχείο, και η compare και η hash_function καλούνται μέσω δεικτών σε κάθε βήμα μιας αναζήτησης.
+//
+// Το MAP_TYPE_DECLARE(name, K, V, hash, eq) ορίζει έναν ειδικό τύπο map για keys τύπου K και values
+// τύπου V, όπου:
+//   hash(key)    επιστρέφει το hash code (uint64_t) του key, πχ MAP_TYPE_HASH_INT
+//   eq(a, b)     επιστρέφει true αν τα keys a και b είναι ισοδύναμα, πχ MAP_TYPE_EQ
+// Οι hash και eq μπορεί να είναι συναρτήσεις ή macros, και γίνονται inline στον κώδικα του map.
+//
+// Η υλοποίηση είναι αυτή του UsingRobinHoodHash (Robin Hood linear probing με backward shift διαγραφή,
+// χωρίς DELETED κόμβους), με χωρητικότητες δυνάμεις του 2 και Fibonacci hashing. Οι κόμβοι περιέχουν
+// μόνο το key, το value και την απόσταση από τη θέση του key (δεν αποθηκεύεται το hash code, αφού
+// ο υπολογισμός του είναι inline και φθηνός), οπότε για int => int κάθε κόμβος είναι 12 bytes.
+//
+// Ορίζονται ο τύπος name (pointer σε struct name) και οι παρακάτω συναρτήσεις, με την ίδια σημασία με
+// τις αντίστοιχες map_<foo> του ADTMap.h:
+//
+//   name         name_create(void);
+//   void         name_destroy(name map);
+//   size_t       name_size(name map);
+//   void         name_reserve(name map, size_t n);
+//   void         name_insert(name map, K key, V value);
+//   bool         name_remove(name map, K key);
+//   V*           name_find(name map, K key);          // Δείκτης στο value μέσα στο map, ή NULL αν δεν υπάρχει
+//   nameNode     name_first(name map);                // Διάσχιση: NULL μετά τον τελευταίο κόμβο,
+//   nameNode     name_next(name map, nameNode node);  // τα πεδία node->key και node->value
+//
+// Όπως και στο ADT Map, οι δείκτες που επιστρέφουν οι name_find, name_first και name_next δεν
+// είναι πλέον έγκυροι μετά από name_insert ή name_remove.
+//
+// Παράδειγμα:
+//   MAP_TYPE_DECLARE(IntMap, int, int, MAP_TYPE_HASH_INT, MAP_TYPE_EQ)
+//
+//   IntMap map = IntMap_create();
+//   IntMap_insert(map, 1, 10);
+//   int* value = IntMap_find(map, 1);
+
+// Συναρτήσεις hash και eq για ακέραιους (και οποιονδήποτε τύπο συγκρίνεται με ==)
+
+#define MAP_TYPE_EQ(a, b) ((a) == (b))
+#define MAP_TYPE_HASH_INT(key) map_type_splitmix64((uint64_t)(key))
+
+// Ο finalizer του splitmix64, όπως στη hash_int64
+static inline uint64_t map_type_splitmix64(uint64_t hash) {
+	hash ^= hash >> 30;
+	hash *= 0xbf58476d1ce4e5b9ull;
+	hash ^= hash >> 27;
+	hash *= 0x94d049bb133111ebull;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+// Οι ίδιες σταθερές με το UsingRobinHoodHash
+#define MAP_TYPE_MIN_CAPACITY 64
+#define MAP_TYPE_MAX_LOAD_FACTOR 0.85
+#define MAP_TYPE_MIN_LOAD_FACTOR 0.125
+
+// Η θέση που κάνει hash ένα key σε πίνακα capacity = 2^k θέσεων (Fibonacci hashing)
+static inline size_t map_type_home_pos(uint64_t hash, size_t capacity) {
+	return (hash * 0x9E3779B97F4A7C15ull) >> (64 - __builtin_ctzll(capacity));
+}
+
+// Η μικρότερη χωρητικότητα στην οποία χωράνε n στοιχεία χωρίς rehash
+static inline size_t map_type_capacity_for(size_t n) {
+	size_t capacity = MAP_TYPE_MIN_CAPACITY;
+	while ((double)n / capacity > MAP_TYPE_MAX_LOAD_FACTOR)
+		capacity *= 2;
+	return capacity;
+}
+
+// Οι βοηθητικές συναρτήσεις name_place, name_rehash, name_find_pos, name_next_from δεν ανήκουν στο interface.
+// Στους κόμβους, dist == 0 σημαίνει EMPTY, διαφορετικά ο κόμβος απέχει dist - 1 θέσεις από τη θέση του key.
+
+#define MAP_TYPE_DECLARE(name, K, V, hash, eq)										\
+																					\
+typedef struct name* name;															\
+typedef struct name##_node* name##Node;												\
+																					\
+struct name##_node {																\
+	K key;																			\
+	V value;																		\
+	uint32_t dist;																	\
+};																					\
+																					\
+struct name {																		\
+	name##Node array;																\
+	size_t capacity;		/* Πάντα δύναμη του 2 */								\
+	size_t size;																	\
+	size_t reserved;		/* Ο χώρος της name_reserve (βλέπε name_remove) */		\
+};																					\
+																					\
+/* Τοποθετεί ένα key που σίγουρα δεν υπάρχει ήδη (βλέπε place στο UsingRobinHoodHash) */	\
+static inline void name##_place(name map, K key, V value, uint64_t h) {			\
+	struct name##_node entry = { .key = key, .value = value, .dist = 1 };			\
+	size_t mask = map->capacity - 1;												\
+	for (size_t pos = map_type_home_pos(h, map->capacity); ; pos = (pos + 1) & mask) {	\
+		name##Node node = &map->array[pos];											\
+		if (node->dist == 0) {														\
+			*node = entry;															\
+			return;																	\
+		}																			\
+		if (node->dist < entry.dist) {												\
+			struct name##_node temp = *node;										\
+			*node = entry;															\
+			entry = temp;															\
+		}																			\
+		entry.dist++;																\
+	}																				\
+}																					\
+																					\
+static inline void name##_rehash(name map, size_t new_capacity) {					\
+	name##Node old_array = map->array;												\
+	size_t old_capacity = map->capacity;											\
+	map->array = calloc(new_capacity, sizeof(struct name##_node));					\
+	map->capacity = new_capacity;													\
+	for (size_t i = 0; i < old_capacity; i++)										\
+		if (old_array[i].dist != 0)													\
+			name##_place(map, old_array[i].key, old_array[i].value, hash(old_array[i].key));	\
+	free(old_array);																\
+}																					\
+																					\
+static inline name name##_create(void) {											\
+	name map = malloc(sizeof(*map));												\
+	map->capacity = MAP_TYPE_MIN_CAPACITY;											\
+	map->array = calloc(map->capacity, sizeof(struct name##_node));				\
+	map->size = 0;																	\
+	map->reserved = 0;																\
+	return map;																		\
+}																					\
+																					\
+static inline void name##_destroy(name map) {										\
+	free(map->array);																\
+	free(map);																		\
+}																					\
+																					\
+static inline size_t name##_size(name map) {										\
+	return map->size;																\
+}																					\
+																					\
+static inline void name##_reserve(name map, size_t n) {							\
+	if (n > map->reserved)															\
+		map->reserved = n;															\
+	size_t capacity = map_type_capacity_for(n);										\
+	if (capacity > map->capacity)													\
+		name##_rehash(map, capacity);												\
+}																					\
+																					\
+/* Η θέση του key στον πίνακα, ή -1 αν δεν υπάρχει (βλέπε find_pos στο UsingRobinHoodHash) */	\
+static inline ptrdiff_t name##_find_pos(name map, K key) {							\
+	size_t mask = map->capacity - 1;												\
+	size_t pos = map_type_home_pos(hash(key), map->capacity);						\
+	for (uint32_t dist = 1; map->array[pos].dist >= dist; dist++, pos = (pos + 1) & mask)	\
+		if (eq(map->array[pos].key, key))											\
+			return pos;																\
+	return -1;																		\
+}																					\
+																					\
+static inline V* name##_find(name map, K key) {									\
+	ptrdiff_t pos = name##_find_pos(map, key);										\
+	return pos != -1 ? &map->array[pos].value : NULL;								\
+}																					\
+																					\
+static inline void name##_insert(name map, K key, V value) {						\
+	ptrdiff_t pos = name##_find_pos(map, key);										\
+	if (pos != -1) {																\
+		map->array[pos].key = key;													\
+		map->array[pos].value = value;												\
+		return;																		\
+	}																				\
+	map->size++;																	\
+	if ((double)map->size / map->capacity > MAP_TYPE_MAX_LOAD_FACTOR)				\
+		name##_rehash(map, map->capacity * 2);										\
+	name##_place(map, key, value, hash(key));										\
+}																					\
+																					\
+/* Backward shift διαγραφή, και όπως στο ADT Map ο πίνακας μικραίνει κάτω από MIN_LOAD_FACTOR */	\
+static inline bool name##_remove(name map, K key) {								\
+	ptrdiff_t found = name##_find_pos(map, key);									\
+	if (found == -1)																\
+		return false;																\
+	size_t mask = map->capacity - 1;												\
+	size_t pos = found, next = (pos + 1) & mask;									\
+	while (map->array[next].dist > 1) {												\
+		map->array[pos] = map->array[next];											\
+		map->array[pos].dist--;														\
+		pos = next;																	\
+		next = (next + 1) & mask;													\
+	}																				\
+	map->array[pos].dist = 0;														\
+	map->size--;																	\
+	if (map->size < map->capacity * MAP_TYPE_MIN_LOAD_FACTOR) {						\
+		size_t n = 2 * map->size > map->reserved ? 2 * map->size : map->reserved;	\
+		size_t capacity = map_type_capacity_for(n);									\
+		if (capacity < map->capacity)												\
+			name##_rehash(map, capacity);											\
+	}																				\
+	return true;																	\
+}																					\
+																					\
+static inline name##Node name##_next_from(name map, size_t pos) {					\
+	for (; pos < map->capacity; pos++)												\
+		if (map->array[pos].dist != 0)												\
+			return &map->array[pos];												\
+	return NULL;																	\
+}																					\
+																					\
+static inline name##Node name##_first(name map) {									\
+	return name##_next_from(map, 0);												\
+}																					\
+																					\
+static inline name##Node name##_next(name map, name##Node node) {					\
+	return name##_next_from(map, node - map->array + 1);							\
+}
@@ -0,0 +1,800 @@
+///////////////////////////////////////////////////////////
+//
+// adt::HashMap
+//
+// C++ εκδοχή του ADT Map (header-only). Τα keys και τα values αποθηκεύονται
+// by value μέσα στον πίνακα, και οι Hash / Eq γίνονται inline, οπότε δεν
+// υπάρχουν κλήσεις μέσω δεικτών σε συναρτήσεις ούτε malloc για κάθε στοιχείο.
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+
+// Ο πίνακας (probing) ορίζεται από την παράμετρο Policy, με τους ίδιους αλγορίθμους με τις αντίστοιχες
+// υλοποιήσεις του ADT Map:
+//
+//   adt::LinearProbing   όπως το UsingHashTable (linear probing με DELETED κόμβους, load factor <= 0.5)
+//   adt::Hopscotch       όπως το UsingHopscotchHash (γειτονιές των 32 θέσεων με hop bitmaps, <= 0.9)
+//   adt::Hybrid          όπως το UsingHybridHash (NEIGHBOURS γειτονικές θέσεις και αλυσίδες από blocks, <= 0.5)
+//
+// Οι διαφορές από τις υλοποιήσεις σε C: οι χωρητικότητες είναι πάντα δυνάμεις του 2 με Fibonacci hashing
+// (όπως η MAP_CAPACITY_POW2, ώστε και hash συναρτήσεις όπως η std::hash<int> που επιστρέφει την ίδια
+// την τιμή να δίνουν καλή διασπορά), και το rehash μεταφέρει όλα τα στοιχεία με τη μία (όχι σταδιακά).
+// Όπως και στο ADT Map, ο πίνακας μικραίνει όταν μετά από erase ο load factor πέσει κάτω από 1/8.
+//
+// Κάθε στοιχείο είναι ένα adt::Entry<K, V> με πεδία key και value, οπότε η διάσχιση γίνεται με range-for:
+//
+//   adt::HashMap<int, std::string> map;
+//   map.try_emplace(1, "one");
+//   for (auto& [key, value] : map)
+//       ...
+//
+// ΠΡΟΣΟΧΗ:
+// Όπως και οι MapNode του ADT Map, οι iterators και οι δείκτες σε στοιχεία δεν είναι πλέον έγκυροι μετά
+// από οποιαδήποτε εισαγωγή ή διαγραφή. Επίσης το key ενός στοιχείου δεν πρέπει να αλλάζει με τρόπο που
+// αλλάζει το Hash ή την ισοδυναμία του (Eq) με άλλα keys.
+
+namespace adt {
+
+// Ένα στοιχείο του map
+
+template <class K, class V>
+struct Entry {
+	K key;
+	V value;
+};
+
+namespace detail {
+
+// Οι καταστάσεις των θέσεων του πίνακα (το DELETED χρησιμοποιείται μόνο από το LinearProbing)
+enum State : uint8_t {
+	EMPTY, OCCUPIED, DELETED
+};
+
+// Η ελάχιστη χωρητικότητα, όπως η POW2_MIN_CAPACITY των υλοποιήσεων σε C
+constexpr size_t MIN_CAPACITY = 64;
+
+// Η θέση που κάνει hash ένα key σε πίνακα capacity = 2^k θέσεων (Fibonacci hashing)
+inline size_t home_pos(uint64_t hash, size_t capacity) {
+	return (hash * 0x9E3779B97F4A7C15ull) >> (64 - __builtin_ctzll(capacity));
+}
+
+// Μια θέση του πίνακα. Το στοιχείο κατασκευάζεται μέσα στο storage μόνο όταν η θέση είναι OCCUPIED,
+// οπότε οι τύποι K και V δε χρειάζεται να έχουν default constructor. Το hash code του key
+// αποθηκεύεται (όπως στις υλοποιήσεις σε C), ώστε η Eq να καλείται μόνο για ίδια hash codes.
+template <class E>
+struct Slot {
+	alignas(E) unsigned char storage[sizeof(E)];
+	uint64_t hash;
+	State state;
+
+	E* entry() {
+		return std::launder(reinterpret_cast<E*>(storage));
+	}
+
+	// Κατασκευάζει το στοιχείο με τη make(storage)
+	template <class Make>
+	E* construct(uint64_t h, Make&& make) {
+		make(static_cast<void*>(storage));
+		hash = h;
+		state = OCCUPIED;
+		return entry();
+	}
+
+	// Μετακινεί το στοιχείο του from σε αυτή τη θέση, και η from γίνεται EMPTY
+	void move_from(Slot& from) {
+		::new (static_cast<void*>(storage)) E(std::move(*from.entry()));
+		hash = from.hash;
+		state = OCCUPIED;
+		from.destroy(EMPTY);
+	}
+
+	void destroy(State new_state) {
+		entry()->~E();
+		state = new_state;
+	}
+};
+
+} // namespace detail
+
+
+// Κάθε Policy ορίζει ένα template Table<E> με τον πίνακα και τις πράξεις του πάνω σε hash codes.
+// Οι αναζητήσεις δέχονται το hash code του key και μια συνάρτηση match(const E&) που ελέγχει το key,
+// και η place κατασκευάζει ένα νέο στοιχείο (που σίγουρα δεν υπάρχει ήδη) μέσω της make(void*).
+// Η place επιστρέφει nullptr αν το στοιχείο δε χωράει, οπότε το HashMap μεγαλώνει τον πίνακα.
+
+struct LinearProbing {
+	static constexpr double max_load_factor = 0.5;
+
+	template <class E>
+	class Table {
+		using Slot = detail::Slot<E>;
+
+		std::unique_ptr<Slot[]> array;
+		size_t capacity_ = 0;
+		size_t deleted = 0;			// Πόσες θέσεις είναι DELETED
+
+	public:
+		// Η θέση ενός στοιχείου στη διάσχιση
+		struct Cursor {
+			size_t pos;
+		};
+
+		// Ο default πίνακας δεν έχει θέσεις (είναι η κατάσταση ενός Table μετά από move)
+		Table() = default;
+		explicit Table(size_t capacity) : array(new Slot[capacity]()), capacity_(capacity) {}
+
+		// Με swap, ώστε ο πίνακας που αντικαθίσταται να καταστρέφει τα στοιχεία του
+		Table(Table&& other) noexcept { swap(other); }
+		Table& operator=(Table&& other) noexcept { swap(other); return *this; }
+
+		~Table() {
+			for (size_t i = 0; i < capacity_; i++)
+				if (array[i].state == detail::OCCUPIED)
+					array[i].destroy(detail::EMPTY);
+		}
+
+		size_t capacity() const { return capacity_; }
+
+		// Οι DELETED θέσεις μετράνε στον load factor, αφού μακραίνουν τις αναζητήσεις όπως και τα στοιχεία
+		size_t load(size_t size) const { return size + deleted; }
+
+		template <class Match>
+		E* find(uint64_t hash, Match&& match) const {
+			size_t mask = capacity_ - 1;
+			for (size_t pos = detail::home_pos(hash, capacity_); array[pos].state != detail::EMPTY; pos = (pos + 1) & mask)
+				if (array[pos].state == detail::OCCUPIED && array[pos].hash == hash && match(*array[pos].entry()))
+					return array[pos].entry();
+			return nullptr;
+		}
+
+		// Το στοιχείο μπαίνει στην πρώτη EMPTY ή DELETED θέση μετά τη θέση που κάνει hash
+		template <class Make>
+		E* place(uint64_t hash, Make&& make) {
+			size_t mask = capacity_ - 1;
+			size_t pos = detail::home_pos(hash, capacity_);
+			while (array[pos].state == detail::OCCUPIED)
+				pos = (pos + 1) & mask;
+
+			if (array[pos].state == detail::DELETED)
+				deleted--;
+			return array[pos].construct(hash, make);
+		}
+
+		// Η θέση γίνεται DELETED, ώστε να μη διακόπτεται η αναζήτηση των επόμενων keys
+		void erase(uint64_t, E* entry) {
+			Slot* slot = reinterpret_cast<Slot*>(entry);
+			slot->destroy(detail::DELETED);
+			deleted++;
+		}
+
+		Cursor begin() const { return next_from(0); }
+		Cursor end() const { return Cursor{capacity_}; }
+		Cursor cursor_of(uint64_t, E* entry) const { return Cursor{size_t(reinterpret_cast<Slot*>(entry) - array.get())}; }
+		void advance(Cursor& cursor) const { cursor = next_from(cursor.pos + 1); }
+		E* get(const Cursor& cursor) const { return cursor.pos < capacity_ ? array[cursor.pos].entry() : nullptr; }
+
+		// Καλεί τη f(hash, entry) για κάθε στοιχείο (πχ για να το μετακινήσει σε νέο πίνακα) και μετά το καταστρέφει
+		template <class F>
+		void drain(F&& f) {
+			for (size_t i = 0; i < capacity_; i++) {
+				if (array[i].state == detail::OCCUPIED) {
+					f(array[i].hash, *array[i].entry());
+					array[i].destroy(detail::EMPTY);
+				}
+			}
+		}
+
+	private:
+		void swap(Table& other) noexcept {
+			std::swap(array, other.array);
+			std::swap(capacity_, other.capacity_);
+			std::swap(deleted, other.deleted);
+		}
+
+		Cursor next_from(size_t pos) const {
+			while (pos < capacity_ && array[pos].state != detail::OCCUPIED)
+				pos++;
+			return Cursor{pos};
+		}
+	};
+};
+
+struct Hopscotch {
+	static constexpr double max_load_factor = 0.9;
+
+	// Όπως τα NEIGHBOURHOOD και ADD_RANGE του UsingHopscotchHash. Όπως και εκεί, κάθε θέση χωράει στη γειτονιά της
+	// το πολύ neighbourhood keys, οπότε η Hash δεν πρέπει να δίνει το ίδιο hash code σε περισσότερα keys.
+	static constexpr int neighbourhood = 32;
+	static constexpr size_t add_range = 512;
+
+	template <class E>
+	class Table {
+		// Το bit i του hop είναι 1 αν η θέση (this + i) περιέχει key που κάνει hash σε αυτή τη θέση.
+		// Ανήκει στη θέση και όχι στο στοιχείο, δεν μετακινείται μαζί του.
+		struct Slot : detail::Slot<E> {
+			uint32_t hop;
+		};
+
+		std::unique_ptr<Slot[]> array;
+		size_t capacity_ = 0;
+
+	public:
+		struct Cursor {
+			size_t pos;
+		};
+
+		// Ο default πίνακας δεν έχει θέσεις (είναι η κατάσταση ενός Table μετά από move)
+		Table() = default;
+		explicit Table(size_t capacity) : array(new Slot[capacity]()), capacity_(capacity) {}
+
+		// Με swap, ώστε ο πίνακας που αντικαθίσταται να καταστρέφει τα στοιχεία του
+		Table(Table&& other) noexcept { swap(other); }
+		Table& operator=(Table&& other) noexcept { swap(other); return *this; }
+
+		~Table() {
+			for (size_t i = 0; i < capacity_; i++)
+				if (array[i].state == detail::OCCUPIED)
+					array[i].destroy(detail::EMPTY);
+		}
+
+		size_t capacity() const { return capacity_; }
+		size_t load(size_t size) const { return size; }
+
+		// Εξετάζονται μόνο οι θέσεις της γειτονιάς που δείχνει το hop bitmap
+		template <class Match>
+		E* find(uint64_t hash, Match&& match) const {
+			size_t mask = capacity_ - 1;
+			size_t home = detail::home_pos(hash, capacity_);
+			for (uint32_t hop = array[home].hop; hop != 0; hop &= hop - 1) {
+				Slot& slot = array[(home + __builtin_ctz(hop)) & mask];
+				if (slot.state == detail::OCCUPIED && slot.hash == hash && match(*slot.entry()))
+					return slot.entry();
+			}
+			return nullptr;
+		}
+
+		// Βρίσκουμε την πρώτη κενή θέση, και όσο είναι έξω από τη γειτονιά τη φέρνουμε πιο κοντά
+		// μετακινώντας στοιχεία μέσα στις δικές τους γειτονιές (βλέπε place στο UsingHopscotchHash).
+		template <class Make>
+		E* place(uint64_t hash, Make&& make) {
+			size_t mask = capacity_ - 1;
+			size_t home = detail::home_pos(hash, capacity_);
+
+			size_t empty = home, dist = 0;
+			while (array[empty].state == detail::OCCUPIED) {
+				if (++dist == add_range || dist == capacity_)
+					return nullptr;
+				empty = (empty + 1) & mask;
+			}
+
+			while (dist >= (size_t)neighbourhood) {
+				bool moved = false;
+				for (int offset = neighbourhood - 1; offset > 0 && !moved; offset--) {
+					size_t bucket = (empty - offset) & mask;
+					uint32_t candidates = array[bucket].hop & ((1u << offset) - 1);		// keys του bucket πριν το empty
+					if (candidates == 0)
+						continue;
+
+					int j = __builtin_ctz(candidates);
+					size_t from = (bucket + j) & mask;
+					array[empty].move_from(array[from]);
+					array[bucket].hop = (array[bucket].hop & ~(1u << j)) | (1u << offset);
+
+					empty = from;
+					dist -= offset - j;
+					moved = true;
+				}
+				if (!moved)
+					return nullptr;
+			}
+
+			array[home].hop |= 1u << dist;
+			return array[empty].construct(hash, make);
+		}
+
+		void erase(uint64_t hash, E* entry) {
+			Slot* slot = reinterpret_cast<Slot*>(entry);
+			size_t pos = slot - array.get();
+			size_t home = detail::home_pos(hash, capacity_);
+			array[home].hop &= ~(1u << ((pos - home) & (capacity_ - 1)));
+			slot->destroy(detail::EMPTY);
+		}
+
+		Cursor begin() const { return next_from(0); }
+		Cursor end() const { return Cursor{capacity_}; }
+		Cursor cursor_of(uint64_t, E* entry) const { return Cursor{size_t(reinterpret_cast<Slot*>(entry) - array.get())}; }
+		void advance(Cursor& cursor) const { cursor = next_from(cursor.pos + 1); }
+		E* get(const Cursor& cursor) const { return cursor.pos < capacity_ ? array[cursor.pos].entry() : nullptr; }
+
+		template <class F>
+		void drain(F&& f) {
+			for (size_t i = 0; i < capacity_; i++) {
+				if (array[i].state == detail::OCCUPIED) {
+					f(array[i].hash, *array[i].entry());
+					array[i].destroy(detail::EMPTY);
+				}
+			}
+		}
+
+	private:
+		void swap(Table& other) noexcept {
+			std::swap(array, other.array);
+			std::swap(capacity_, other.capacity_);
+		}
+
+		Cursor next_from(size_t pos) const {
+			while (pos < capacity_ && array[pos].state != detail::OCCUPIED)
+				pos++;
+			return Cursor{pos};
+		}
+	};
+};
+
+struct Hybrid {
+	static constexpr double max_load_factor = 0.5;
+
+	// Όπως τα NEIGHBOURS και CHAIN_NODES του UsingHybridHash
+	static constexpr size_t neighbours = 3;
+	static constexpr int chain_nodes = 3;
+
+	template <class E>
+	class Table {
+		using Slot = detail::Slot<E>;
+
+		// Ένα block μιας αλυσίδας. Ένα block που αδειάζει εντελώς αφαιρείται από την αλυσίδα.
+		struct Chain {
+			Slot nodes[chain_nodes] = {};
+			Chain* next = nullptr;
+		};
+
+		std::unique_ptr<Slot[]> array;
+		std::unique_ptr<Chain*[]> chains;	// Για κάθε θέση, η αλυσίδα με τα στοιχεία που δε χώρεσαν στη γειτονιά της
+		size_t capacity_ = 0;
+
+	public:
+		// Η θέση ενός στοιχείου στη διάσχιση: πρώτα ο πίνακας και μετά οι αλυσίδες (όπως στο UsingHybridHash)
+		struct Cursor {
+			size_t pos;				// Στον πίνακα η θέση, και στις αλυσίδες capacity + η θέση της αλυσίδας
+			Chain* chain;
+			int slot;
+		};
+
+		Table() = default;
+		explicit Table(size_t capacity)
+			: array(new Slot[capacity]()), chains(new Chain*[capacity]()), capacity_(capacity) {}
+
+		Table(Table&& other) noexcept { swap(other); }
+		Table& operator=(Table&& other) noexcept { swap(other); return *this; }
+
+		~Table() {
+			for (size_t i = 0; i < capacity_; i++)
+				if (array[i].state == detail::OCCUPIED)
+					array[i].destroy(detail::EMPTY);
+
+			for (size_t i = 0; i < capacity_; i++) {
+				for (Chain* chain = chains[i]; chain != nullptr; ) {
+					for (Slot& node : chain->nodes)
+						if (node.state == detail::OCCUPIED)
+							node.destroy(detail::EMPTY);
+					Chain* next = chain->next;
+					delete chain;
+					chain = next;
+				}
+			}
+		}
+
+		size_t capacity() const { return capacity_; }
+		size_t load(size_t size) const { return size; }
+
+		template <class Match>
+		E* find(uint64_t hash, Match&& match) const {
+			size_t mask = capacity_ - 1;
+			size_t home = detail::home_pos(hash, capacity_);
+			for (size_t i = 0, pos = home; i <= neighbours; i++, pos = (pos + 1) & mask)
+				if (array[pos].state == detail::OCCUPIED && array[pos].hash == hash && match(*array[pos].entry()))
+					return array[pos].entry();
+
+			// Διαφορετικά το key είναι στην αλυσίδα της θέσης που κάνει hash, ή δεν υπάρχει
+			for (Chain* chain = chains[home]; chain != nullptr; chain = chain->next)
+				for (Slot& node : chain->nodes)
+					if (node.state == detail::OCCUPIED && node.hash == hash && match(*node.entry()))
+						return node.entry();
+			return nullptr;
+		}
+
+		// Σε κενή γειτονική θέση αν υπάρχει, διαφορετικά στην αλυσίδα της θέσης που κάνει hash
+		template <class Make>
+		E* place(uint64_t hash, Make&& make) {
+			size_t mask = capacity_ - 1;
+			size_t home = detail::home_pos(hash, capacity_);
+			for (size_t i = 0, pos = home; i <= neighbours; i++, pos = (pos + 1) & mask)
+				if (array[pos].state == detail::EMPTY)
+					return array[pos].construct(hash, make);
+
+			Chain** link = &chains[home];
+			for (; *link != nullptr; link = &(*link)->next)
+				for (Slot& node : (*link)->nodes)
+					if (node.state == detail::EMPTY)
+						return node.construct(hash, make);
+
+			*link = new Chain();		// Η αλυσίδα είναι γεμάτη (ή δεν υπάρχει), προσθέτουμε ένα block
+			return (*link)->nodes[0].construct(hash, make);
+		}
+
+		void erase(uint64_t hash, E* entry) {
+			Slot* slot = reinterpret_cast<Slot*>(entry);
+			slot->destroy(detail::EMPTY);
+			if (slot >= array.get() && slot < array.get() + capacity_)
+				return;
+
+			// Το στοιχείο ήταν σε αλυσίδα, αν το block του άδειασε εντελώς το αφαιρούμε
+			for (Chain** link = &chains[detail::home_pos(hash, capacity_)]; *link != nullptr; link = &(*link)->next) {
+				Chain* chain = *link;
+				if (slot < chain->nodes || slot >= chain->nodes + chain_nodes)
+					continue;
+
+				for (Slot& node : chain->nodes)
+					if (node.state == detail::OCCUPIED)
+						return;
+				*link = chain->next;
+				delete chain;
+				return;
+			}
+		}
+
+		Cursor begin() const {
+			Cursor cursor{0, nullptr, -1};
+			next_from(cursor);
+			return cursor;
+		}
+
+		Cursor end() const { return Cursor{2 * capacity_, nullptr, -1}; }
+
+		// Για στοιχείο σε αλυσίδα, βρίσκουμε το block του στην αλυσίδα της θέσης που κάνει hash
+		Cursor cursor_of(uint64_t hash, E* entry) const {
+			Slot* slot = reinterpret_cast<Slot*>(entry);
+			if (slot >= array.get() && slot < array.get() + capacity_)
+				return Cursor{size_t(slot - array.get()), nullptr, -1};
+
+			size_t home = detail::home_pos(hash, capacity_);
+			Chain* chain = chains[home];
+			while (slot < chain->nodes || slot >= chain->nodes + chain_nodes)
+				chain = chain->next;
+			return Cursor{capacity_ + home, chain, int(slot - chain->nodes)};
+		}
+
+		void advance(Cursor& cursor) const {
+			if (cursor.chain == nullptr)
+				cursor.pos++;
+			next_from(cursor);
+		}
+
+		E* get(const Cursor& cursor) const {
+			if (cursor.chain != nullptr)
+				return cursor.chain->nodes[cursor.slot].entry();
+			return cursor.pos < capacity_ ? array[cursor.pos].entry() : nullptr;
+		}
+
+		template <class F>
+		void drain(F&& f) {
+			for (size_t i = 0; i < capacity_; i++) {
+				if (array[i].state == detail::OCCUPIED) {
+					f(array[i].hash, *array[i].entry());
+					array[i].destroy(detail::EMPTY);
+				}
+			}
+			for (size_t i = 0; i < capacity_; i++) {
+				while (Chain* chain = chains[i]) {
+					for (Slot& node : chain->nodes) {
+						if (node.state == detail::OCCUPIED) {
+							f(node.hash, *node.entry());
+							node.destroy(detail::EMPTY);
+						}
+					}
+					chains[i] = chain->next;
+					delete chain;
+				}
+			}
+		}
+
+	private:
+		void swap(Table& other) noexcept {
+			std::swap(array, other.array);
+			std::swap(chains, other.chains);
+			std::swap(capacity_, other.capacity_);
+		}
+
+		// Ο πρώτος OCCUPIED κόμβος από το cursor και μετά (ο ίδιος ο κόμβος του cursor αν είναι
+		// στον πίνακα, ή ο επόμενος από το cursor.slot αν είναι σε αλυσίδα)
+		void next_from(Cursor& cursor) const {
+			for (; cursor.pos < capacity_; cursor.pos++)
+				if (array[cursor.pos].state == detail::OCCUPIED)
+					return;
+
+			for (; cursor.pos < 2 * capacity_; cursor.pos++) {
+				if (cursor.chain == nullptr) {
+					cursor.chain = chains[cursor.pos - capacity_];
+					cursor.slot = -1;
+				}
+				for (; cursor.chain != nullptr; cursor.chain = cursor.chain->next, cursor.slot = -1)
+					while (++cursor.slot < chain_nodes)
+						if (cursor.chain->nodes[cursor.slot].state == detail::OCCUPIED)
+							return;
+			}
+		}
+	};
+};
+
+
+// Το map. Η Hash επιστρέφει το hash code ενός key (μετατρέπεται σε uint64_t),
+// και η Eq επιστρέφει true αν δύο keys είναι ισοδύναμα.
+
+template <class K, class V, class Hash = std::hash<K>, class Eq = std::equal_to<K>, class Policy = LinearProbing>
+class HashMap {
+public:
+	using key_type = K;
+	using mapped_type = V;
+	using value_type = Entry<K, V>;
+	using size_type = size_t;
+
+private:
+	using Table = typename Policy::template Table<value_type>;
+	using Cursor = typename Table::Cursor;
+
+	static constexpr double min_load_factor = 0.125;		// όπως το MIN_LOAD_FACTOR των υλοποιήσεων σε C
+
+	Table table{detail::MIN_CAPACITY};
+	size_t size_ = 0;
+	size_t reserved = 0;		// Ο χώρος της reserve, κάτω από τον οποίο ο πίνακας δε μικραίνει
+	Hash hasher;
+	Eq eq;
+
+	template <bool Const>
+	class Iterator {
+		friend class HashMap;
+		using Map = std::conditional_t<Const, const HashMap, HashMap>;
+
+		Map* map;
+		Cursor cursor;
+
+		Iterator(Map* map, Cursor cursor) : map(map), cursor(cursor) {}
+
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Entry<K, V>;
+		using difference_type = std::ptrdiff_t;
+		using pointer = std::conditional_t<Const, const value_type*, value_type*>;
+		using reference = std::conditional_t<Const, const value_type&, value_type&>;
+
+		Iterator() : map(nullptr), cursor() {}
+		operator Iterator<true>() const { return Iterator<true>(map, cursor); }
+
+		reference operator*() const { return *map->table.get(cursor); }
+		pointer operator->() const { return map->table.get(cursor); }
+
+		Iterator& operator++() {
+			map->table.advance(cursor);
+			return *this;
+		}
+
+		Iterator operator++(int) {
+			Iterator old = *this;
+			++*this;
+			return old;
+		}
+
+		// Δύο iterators είναι ίσοι αν δείχνουν στο ίδιο στοιχείο (ή είναι και οι δύο στο τέλος)
+		bool operator==(const Iterator& other) const { return map->table.get(cursor) == other.map->table.get(other.cursor); }
+		bool operator!=(const Iterator& other) const { return !(*this == other); }
+	};
+
+public:
+	using iterator = Iterator<false>;
+	using const_iterator = Iterator<true>;
+
+	HashMap() = default;
+
+	// Όπως η map_create_sized, με αρκετό χώρο για expected στοιχεία
+	explicit HashMap(size_t expected) { reserve(expected); }
+
+	HashMap(const HashMap& other)
+		: table(capacity_for(std::max(other.size_, other.reserved))), reserved(other.reserved), hasher(other.hasher), eq(other.eq) {
+		for (const value_type& entry : other)
+			try_emplace_entry(entry.key, entry.value);
+	}
+
+	// Χωρίς δέσμευση μνήμης: το other μένει ένα κενό map χωρίς πίνακα (που δημιουργείται στην πρώτη εισαγωγή)
+	HashMap(HashMap&& other) noexcept
+		: table(std::move(other.table)), size_(std::exchange(other.size_, 0)), reserved(std::exchange(other.reserved, 0)),
+		  hasher(other.hasher), eq(other.eq) {}
+
+	HashMap& operator=(HashMap other) {
+		swap(other);
+		return *this;
+	}
+
+	void swap(HashMap& other) noexcept {
+		std::swap(table, other.table);
+		std::swap(size_, other.size_);
+		std::swap(reserved, other.reserved);
+		std::swap(hasher, other.hasher);
+		std::swap(eq, other.eq);
+	}
+
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+	size_t capacity() const { return table.capacity(); }
+
+	// Όπως η map_reserve: μεγαλώνει τον πίνακα ώστε να χωράει n στοιχεία χωρίς rehash
+	void reserve(size_t n) {
+		if (n > reserved)
+			reserved = n;
+		size_t capacity = capacity_for(n);
+		if (capacity > table.capacity())
+			rehash(capacity);
+	}
+
+	void clear() {
+		table = Table(capacity_for(reserved));
+		size_ = 0;
+	}
+
+	iterator begin() { return iterator(this, table.begin()); }
+	iterator end() { return iterator(this, table.end()); }
+	const_iterator begin() const { return const_iterator(this, table.begin()); }
+	const_iterator end() const { return const_iterator(this, table.end()); }
+
+	iterator find(const K& key) {
+		uint64_t hash = hash_of(key);
+		value_type* entry = find_entry(key, hash);
+		return entry != nullptr ? iterator(this, table.cursor_of(hash, entry)) : end();
+	}
+
+	const_iterator find(const K& key) const {
+		return const_cast<HashMap*>(this)->find(key);
+	}
+
+	// Ο δείκτης στο value του key, ή nullptr αν δεν υπάρχει (φθηνότερο από τη find, δε χρειάζεται iterator)
+	V* find_value(const K& key) {
+		value_type* entry = find_entry(key, hash_of(key));
+		return entry != nullptr ? &entry->value : nullptr;
+	}
+
+	const V* find_value(const K& key) const {
+		return const_cast<HashMap*>(this)->find_value(key);
+	}
+
+	bool contains(const K& key) const { return find_value(key) != nullptr; }
+
+	// Αν το key δεν υπάρχει, εισάγεται με value κατασκευασμένο από τα args (χωρίς αντιγραφές).
+	// Αν υπάρχει, τα args δε χρησιμοποιούνται. Επιστρέφει το στοιχείο και αν έγινε εισαγωγή.
+	template <class KK, class... Args>
+	std::pair<value_type*, bool> try_emplace_entry(KK&& key, Args&&... args) {
+		uint64_t hash = hash_of(key);
+		if (value_type* entry = find_entry(key, hash))
+			return { entry, false };
+
+		value_type* entry = place(hash, [&](void* storage) {
+			::new (storage) value_type{ K(std::forward<KK>(key)), V(std::forward<Args>(args)...) };
+		});
+		return { entry, true };
+	}
+
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+		return with_iterator(try_emplace_entry(key, std::forward<Args>(args)...));
+	}
+
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(K&& key, Args&&... args) {
+		return with_iterator(try_emplace_entry(std::move(key), std::forward<Args>(args)...));
+	}
+
+	// Κατασκευάζει το στοιχείο από τα args (πχ key, value), και το εισάγει αν το key δεν υπάρχει
+	template <class... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		value_type entry{ std::forward<Args>(args)... };
+		return try_emplace(std::move(entry.key), std::move(entry.value));
+	}
+
+	std::pair<iterator, bool> insert(const value_type& entry) { return try_emplace(entry.key, entry.value); }
+	std::pair<iterator, bool> insert(value_type&& entry) { return try_emplace(std::move(entry.key), std::move(entry.value)); }
+
+	// Όπως η map_insert: αν το key υπάρχει, η τιμή του αντικαθίσταται
+	template <class KK, class VV>
+	std::pair<iterator, bool> insert_or_assign(KK&& key, VV&& value) {
+		auto [entry, inserted] = try_emplace_entry(std::forward<KK>(key), std::forward<VV>(value));
+		if (!inserted)
+			entry->value = std::forward<VV>(value);
+		return with_iterator({ entry, inserted });
+	}
+
+	V& operator[](const K& key) { return try_emplace_entry(key).first->value; }
+	V& operator[](K&& key) { return try_emplace_entry(std::move(key)).first->value; }
+
+	// Επιστρέφει το πλήθος των στοιχείων που αφαιρέθηκαν (0 ή 1)
+	size_t erase(const K& key) {
+		uint64_t hash = hash_of(key);
+		value_type* entry = find_entry(key, hash);
+		if (entry == nullptr)
+			return 0;
+
+		table.erase(hash, entry);
+		size_--;
+		shrink();
+		return 1;
+	}
+
+private:
+	uint64_t hash_of(const K& key) const {
+		return static_cast<uint64_t>(hasher(key));
+	}
+
+	// Ένα κενό map μπορεί να μην έχει πίνακα (μετά από move), οπότε δεν ψάχνουμε καθόλου
+	value_type* find_entry(const K& key, uint64_t hash) const {
+		if (size_ == 0)
+			return nullptr;
+		return table.find(hash, [&](const value_type& entry) { return eq(entry.key, key); });
+	}
+
+	// Η μικρότερη χωρητικότητα στην οποία χωράνε n στοιχεία χωρίς rehash
+	static size_t capacity_for(size_t n) {
+		size_t capacity = detail::MIN_CAPACITY;
+		while ((double)n / capacity > Policy::max_load_factor)
+			capacity *= 2;
+		return capacity;
+	}
+
+	// Νέο στοιχείο. Αν με την εισαγωγή ξεπερνάμε το μέγιστο load factor, κάνουμε πρώτα rehash. Για το
+	// LinearProbing, αν φταίνε οι DELETED θέσεις, το rehash απλά τις αφαιρεί: όπως στο UsingHashTable ο πίνακας
+	// δε μικραίνει εδώ (αυτό γίνεται μόνο στην erase), και ποτέ κάτω από τον χώρο της reserve.
+	template <class Make>
+	value_type* place(uint64_t hash, Make&& make) {
+		if (table.capacity() == 0 || (double)table.load(size_ + 1) / table.capacity() > Policy::max_load_factor)
+			rehash(std::max(capacity_for(std::max(size_ + 1, reserved)), table.capacity()));
+
+		value_type* entry;
+		while ((entry = table.place(hash, make)) == nullptr)
+			rehash(table.capacity() * 2);		// Το Hopscotch δε βρήκε θέση στη γειτονιά
+		size_++;
+		return entry;
+	}
+
+	// Τα στοιχεία μετακινούνται σε νέο πίνακα new_capacity θέσεων. Αν κάποιο δε χωράει (Hopscotch),
+	// ο νέος πίνακας (με όσα έχουν ήδη μετακινηθεί) ξαναχτίζεται σε μεγαλύτερο, και η μετακίνηση συνεχίζει εκεί.
+	void rehash(size_t new_capacity) {
+		Table old = std::exchange(table, Table(new_capacity));
+		old.drain([&](uint64_t hash, value_type& entry) {
+			auto make = [&](void* storage) { ::new (storage) value_type(std::move(entry)); };
+			while (table.place(hash, make) == nullptr)
+				rehash(table.capacity() * 2);
+		});
+	}
+
+	// Όπως η shrink των υλοποιήσεων σε C
+	void shrink() {
+		if (size_ >= table.capacity() * min_load_factor)
+			return;
+
+		size_t capacity = capacity_for(2 * size_ > reserved ? 2 * size_ : reserved);
+		if (capacity < table.capacity())
+			rehash(capacity);
+	}
+
+	std::pair<iterator, bool> with_iterator(std::pair<value_type*, bool> result) {
+		return { iterator(this, table.cursor_of(hash_of(result.first->key), result.first)), result.second };
+	}
+};
+
+} // namespace adt
@@ -0,0 +1,55 @@
+///////////////////////////////////////////////////////////
+//
+// Κοινή υλοποίηση της map_find_batch (βλέπε ADTMap.h)
+//
+// Το αρχείο γίνεται #include από το ADTMap.c κάθε υλοποίησης, αφού αυτό
+// ορίσει τον τύπο Lookup (με πεδία index και hashed) και τη lookup_hash.
+// Μετά το #include το ADTMap.c ορίζει τη lookup_step, η οποία κάνει
+// ένα βήμα της αναζήτησης και επιστρέφει true αν αυτή ολοκληρώθηκε.
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+// Πόσες αναζητήσεις εκτελούνται ταυτόχρονα
+#ifndef FIND_BATCH_WIDTH
+#define FIND_BATCH_WIDTH 16
+#endif
+
+static bool lookup_step(Map map, Lookup* l, Pointer* keys, Pointer* out_values);
+
+// Ξεκινάει την αναζήτηση του keys[index]. Το hash code υπολογίζεται στο επόμενο βήμα, ώστε
+// μέχρι τότε να έχει έρθει στην cache το key (η hash_function διαβάζει το περιεχόμενό του).
+static void lookup_start(Lookup* l, Pointer* keys, size_t index) {
+	l->index = index;
+	l->hashed = false;
+	__builtin_prefetch(keys[index]);
+}
+
+// Ολοκληρώνει την αναζήτηση l με αποτέλεσμα τον κόμβο node (ή MAP_EOF)
+static bool lookup_finish(Lookup* l, Pointer* out_values, MapNode node) {
+	out_values[l->index] = node != MAP_EOF ? node->value : NULL;
+	return true;
+}
+
+void map_find_batch(Map map, Pointer* keys, Pointer* out_values, size_t n) {
+	Lookup lookups[FIND_BATCH_WIDTH];
+	size_t active = 0, next = 0;
+	while (active < FIND_BATCH_WIDTH && next < n)
+		lookup_start(&lookups[active++], keys, next++);
+
+	// Εκτελούμε ένα βήμα από κάθε ενεργή αναζήτηση, και όποια ολοκληρώνεται δίνει τη θέση της στο επόμενο key
+	while (active > 0) {
+		for (size_t i = 0; i < active; ) {
+			if (!lookups[i].hashed) {
+				lookup_hash(map, &lookups[i], keys[lookups[i].index]);
+				lookups[i++].hashed = true;
+			} else if (!lookup_step(map, &lookups[i], keys, out_values))
+				i++;
+			else if (next < n)
+				lookup_start(&lookups[i++], keys, next++);
+			else
+				lookups[i] = lookups[--active];		// η τελευταία ενεργή αναζήτηση παίρνει τη θέση της
+		}
+	}
+}
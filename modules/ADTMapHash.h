@@ -0,0 +1,180 @@
+///////////////////////////////////////////////////////////
+//
+// Κοινές συναρτήσεις κατακερματισμού (βλέπε ADTMap.h)
+//
+// Το αρχείο γίνεται #include από το ADTMap.c κάθε υλοποίησης, οπότε
+// όλες οι υλοποιήσεις δίνουν τα ίδια hash codes για τα ίδια keys.
+//
+///////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "ADTMap.h"
+
+
+uint hash_string(Pointer value) {
+	// djb2 hash function, απλή, γρήγορη, και σε γενικές γραμμές αποδοτική
+    uint hash = 5381;
+    for (char* s = value; *s != '\0'; s++)
+		hash = (hash << 5) + hash + *s;			// hash = (hash * 33) + *s. Το foo << 5 είναι γρηγορότερη εκδοχή του foo * 32.
+    return hash;
+}
+
+uint hash_int(Pointer value) {
+	return *(int*)value;
+}
+
+uint hash_pointer(Pointer value) {
+	return (size_t)value;				// cast σε sizt_t, που έχει το ίδιο μήκος με έναν pointer
+}
+
+uint hash_int_mixed(Pointer value) {
+	// Ο finalizer του MurmurHash3 (fmix32)
+	uint hash = *(int*)value;
+	hash ^= hash >> 16;
+	hash *= 0x85ebca6b;
+	hash ^= hash >> 13;
+	hash *= 0xc2b2ae35;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+uint hash_pointer_mixed(Pointer value) {
+	return (uint)hash_pointer64(value);
+}
+
+// Ο finalizer του splitmix64
+static inline uint64_t splitmix64(uint64_t hash) {
+	hash ^= hash >> 30;
+	hash *= 0xbf58476d1ce4e5b9ull;
+	hash ^= hash >> 27;
+	hash *= 0x94d049bb133111ebull;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+uint64_t hash_int64(Pointer value) {
+	return splitmix64((uint)*(int*)value);
+}
+
+uint64_t hash_pointer64(Pointer value) {
+	return splitmix64((uintptr_t)value);		// όλα τα 64 bits του pointer (όχι μόνο τα χαμηλά 32)
+}
+
+//////// Γρήγορη συνάρτηση κατακερματισμού για strings ////////
+//
+// Στα πρότυπα του wyhash: το string διαβάζεται 8 bytes τη φορά, και κάθε ζευγάρι λέξεων ανακατεύεται με
+// έναν πολλαπλασιασμό 64x64 -> 128 bits (τα δύο μισά του αποτελέσματος γίνονται xor). Τα μεγάλα strings
+// επεξεργάζονται σε κομμάτια (stripes) των 64 bytes με 8 ανεξάρτητους accumulators (όπως στο xxh3), με AVX2
+// όπου είναι διαθέσιμο. Η εκδοχή AVX2 κάνει ακριβώς τις ίδιες πράξεις, οπότε το hash code δεν εξαρτάται από αυτό.
+
+// Τα strings με περισσότερα από τόσα bytes επεξεργάζονται σε stripes
+#define HASH_STRIPE 64
+
+static const uint64_t hash_secret[8] = {
+	0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull,
+	0x1d8e4e27c47d124full, 0xbe4ba423396cfeb8ull, 0xdb979083e96dd4deull, 0x7e3d8b9c4f2a1605ull,
+};
+
+static inline uint64_t read64(const uint8_t* p) {
+	uint64_t v;
+	memcpy(&v, p, 8);		// χωρίς περιορισμούς ευθυγράμμισης, ο compiler το κάνει μία εντολή
+	return v;
+}
+
+static inline uint64_t read32(const uint8_t* p) {
+	uint32_t v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+// Πολλαπλασιασμός 64x64 -> 128 bits, επιστρέφει το xor των δύο μισών
+static inline uint64_t hash_mix(uint64_t a, uint64_t b) {
+	__uint128_t r = (__uint128_t)a * b;
+	return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+// Προσθέτει ένα stripe των 64 bytes στους 8 accumulators
+static inline void hash_stripe(uint64_t acc[8], const uint8_t* p) {
+#ifdef __AVX2__
+	for (int i = 0; i < 8; i += 4) {
+		__m256i data = _mm256_loadu_si256((const __m256i*)(p + 8 * i));
+		__m256i key = _mm256_xor_si256(data, _mm256_loadu_si256((const __m256i*)&hash_secret[i]));
+		__m256i product = _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));
+		__m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+		__m256i sum = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)&acc[i]), swapped);
+		_mm256_storeu_si256((__m256i*)&acc[i], _mm256_add_epi64(product, sum));
+	}
+#else
+	for (int i = 0; i < 8; i++) {
+		uint64_t data = read64(p + 8 * i);
+		uint64_t key = data ^ hash_secret[i];
+		acc[i ^ 1] += data;
+		acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+	}
+#endif
+}
+
+uint64_t hash_string_len64(Pointer value, size_t length) {
+	const uint8_t* p = value;
+	uint64_t seed = hash_secret[0];
+	uint64_t a, b;
+
+	if (length <= 16) {
+		// Τα μικρά strings διαβάζονται με (πιθανώς επικαλυπτόμενα) κομμάτια των 4 bytes
+		if (length >= 4) {
+			size_t middle = (length >> 3) << 2;
+			a = (read32(p) << 32) | read32(p + middle);
+			b = (read32(p + length - 4) << 32) | read32(p + length - 4 - middle);
+		} else if (length > 0) {
+			a = ((uint64_t)p[0] << 16) | ((uint64_t)p[length >> 1] << 8) | p[length - 1];
+			b = 0;
+		} else {
+			a = b = 0;
+		}
+	} else {
+		size_t i = length;
+		if (i > HASH_STRIPE) {
+			uint64_t acc[8];
+			for (int j = 0; j < 8; j++)
+				acc[j] = hash_secret[j];
+
+			for (; i > HASH_STRIPE; i -= HASH_STRIPE, p += HASH_STRIPE)
+				hash_stripe(acc, p);
+
+			for (int j = 0; j < 8; j += 2)
+				seed = hash_mix(acc[j] ^ hash_secret[j], acc[j + 1] ^ seed);
+		}
+
+		// Τα υπόλοιπα (17 έως 64) bytes ανά 16, και τα τελευταία 16 (επικαλυπτόμενα με τα προηγούμενα)
+		for (; i > 16; i -= 16, p += 16)
+			seed = hash_mix(read64(p) ^ hash_secret[1], read64(p + 8) ^ seed);
+
+		a = read64(p + i - 16);
+		b = read64(p + i - 8);
+	}
+
+	a ^= hash_secret[1];
+	b ^= seed;
+	__uint128_t r = (__uint128_t)a * b;
+	return hash_mix((uint64_t)r ^ hash_secret[0] ^ length, (uint64_t)(r >> 64) ^ hash_secret[1]);
+}
+
+uint64_t hash_string64(Pointer value) {
+	return hash_string_len64(value, strlen(value));
+}
+
+uint hash_string_len(Pointer value, size_t length) {
+	return (uint)hash_string_len64(value, length);
+}
+
+uint hash_string_fast(Pointer value) {
+	return (uint)hash_string64(value);
+}
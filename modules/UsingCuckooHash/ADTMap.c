@@ -0,0 +1,677 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// Υλοποίηση του ADT Map μέσω Cuckoo Hashing με buckets των 4 θέσεων
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ADTMap.h"
+
+
+// Κάθε key μπορεί να βρίσκεται μόνο σε 2 buckets (ή στο stash), οπότε η αναζήτηση εξετάζει
+// το πολύ 2 * BUCKET_SLOTS θέσεις, ανεξάρτητα από το πόσο γεμάτος είναι ο πίνακας.
+#define BUCKET_SLOTS 4
+
+// Κάθε θέση έχει ένα tag 8 bits (fingerprint) από το hash του key της, σε ξεχωριστό πίνακα.
+// Τα tags ενός bucket είναι 4 συνεχόμενα bytes, οπότε η αναζήτηση διαβάζει τα tags των 2 buckets
+// και συγκρίνει (με την compare) μόνο τα keys των οποίων το tag ταιριάζει. Το tag 0 σημαίνει κενή θέση.
+#define EMPTY_TAG 0
+
+// Λίγα keys για τα οποία δε βρέθηκε θέση στα buckets τους αποθηκεύονται εδώ, ώστε μια άτυχη
+// εισαγωγή να μην προκαλεί αμέσως rehash.
+#define STASH_SIZE 8
+
+// Μέγιστο πλήθος buckets που εξετάζει η αναζήτηση σε πλάτος (BFS) για μονοπάτι μετακινήσεων
+// που καταλήγει σε κενή θέση. Με 2 αρχικά buckets και 4 παιδιά το καθένα, 170 buckets είναι
+// όλα τα μονοπάτια μήκους μέχρι 4 μετακινήσεις.
+#define MAX_BFS 170
+
+// Τα buckets των 4 θέσεων επιτρέπουν πολύ μεγαλύτερο load factor από το απλό cuckoo hashing.
+#define MAX_LOAD_FACTOR 0.9
+
+// Κάτω από αυτόν τον load factor (ως προς όλες τις θέσεις των buckets, το stash δε μετράει)
+// ο πίνακας μικραίνει, βλέπε map_compact στο ADTMap.h.
+#define MIN_LOAD_FACTOR 0.125
+
+// Το πλήθος των buckets είναι πάντα δύναμη του 2, ώστε η επιλογή bucket να γίνεται με &.
+#define MIN_BUCKETS 16
+
+// Δομή του κάθε κόμβου. Οι κόμβοι ενός bucket είναι συνεχόμενοι (4 * 16 = 64 bytes, ένα cache line),
+// γι' αυτό το hash code κάθε key δεν αποθηκεύεται στον κόμβο αλλά σε έναν ακόμα παράλληλο πίνακα (hashes).
+// Τον διαβάζουν μόνο οι μετακινήσεις και το rehash, η αναζήτηση αρκείται στο tag (δύο cache lines ανά bucket).
+struct map_node {
+	Pointer key;		// Το κλειδί που χρησιμοποιείται για να hash-αρουμε
+	Pointer value;		// Η τιμή που αντισοιχίζεται στο παραπάνω κλειδί
+};
+
+// Δομή του Map
+struct map {
+	uint8_t* tags;				// Τα tags όλων των θέσεων (BUCKET_SLOTS ανά bucket)
+	MapNode array;				// Οι κόμβοι όλων των θέσεων (παράλληλος πίνακας με τα tags)
+	uint64_t* hashes;			// Το hash code του key κάθε θέσης, υπολογίζεται μία φορά κατά την εισαγωγή
+	size_t buckets;				// Πλήθος buckets (δύναμη του 2)
+	size_t size;				// Πόσα στοιχεία έχουμε προσθέσει (μαζί με το stash)
+	size_t reserved;			// Ο χώρος (σε στοιχεία) της map_reserve, κάτω από τον οποίο ο πίνακας δε μικραίνει
+	struct map_node stash[STASH_SIZE];	// Τα στοιχεία του stash, πάντα στις πρώτες stash_size θέσεις
+	uint64_t stash_hashes[STASH_SIZE];
+	int stash_size;
+	int rehashes;				// Πόσα rehash έχουν γίνει και πόσα keys έχουν μετακινηθεί στο άλλο bucket τους (για τη map_stats)
+	long displacements;
+	CompareFunc compare;		// Συνάρτηση για σύγκριση δεικτών, που πρέπει να δίνεται απο τον χρήστη
+	HashFunc hash_function;		// Συνάρτηση για να παίρνουμε το hash code του κάθε αντικειμένου.
+	HashFunc64 hash_function64;	// Η συνάρτηση 64 bits, αν έχει οριστεί (διαφορετικά NULL και χρησιμοποιείται η hash_function)
+	DestroyFunc destroy_key;	// Συναρτήσεις που καλούνται όταν διαγράφουμε έναν κόμβο απο το map.
+	DestroyFunc destroy_value;
+};
+
+// Οι δύο θέσεις ενός key, και το tag του
+typedef struct {
+	size_t bucket1, bucket2;
+	uint8_t tag;
+} Location;
+
+
+//////////////////////// Hashing ////////////////////////
+
+// Οι δύο συναρτήσεις κατακερματισμού προκύπτουν από το hash του χρήστη: το ανακατεύουμε με έναν
+// πολλαπλασιασμό (Fibonacci hashing), τα υψηλότερα bits δίνουν το tag και τα μεσαία το πρώτο bucket.
+// Το δεύτερο bucket εξαρτάται μόνο από το πρώτο και το tag (partial-key cuckoo hashing), οπότε
+// κατά τις μετακινήσεις βρίσκουμε το εναλλακτικό bucket ενός key χωρίς να καλέσουμε τη hash_function.
+static size_t alt_bucket(Map map, size_t bucket, uint8_t tag) {
+	size_t diff = (tag * 0x5bd1e995u) & (map->buckets - 1);
+	return bucket ^ (diff != 0 ? diff : 1);		// ποτέ το ίδιο bucket (το xor είναι συμμετρικό: alt(alt(b)) == b)
+}
+
+static Location locate(Map map, uint64_t hash) {
+	uint64_t mixed = hash * 0x9E3779B97F4A7C15ull;
+
+	Location loc;
+	loc.tag = (uint8_t)(mixed >> 56);
+	if (loc.tag == EMPTY_TAG)
+		loc.tag = 1;
+	loc.bucket1 = (size_t)(mixed >> 32 | mixed << 32) & (map->buckets - 1);	// τα μεσαία bits (και τα χαμηλά για > 2^32 buckets)
+	loc.bucket2 = alt_bucket(map, loc.bucket1, loc.tag);
+	return loc;
+}
+
+// Επιστρέφει μια κενή θέση του bucket, ή -1 αν είναι γεμάτο
+static ptrdiff_t free_slot(Map map, size_t bucket) {
+	for (int i = 0; i < BUCKET_SLOTS; i++)
+		if (map->tags[bucket * BUCKET_SLOTS + i] == EMPTY_TAG)
+			return bucket * BUCKET_SLOTS + i;
+	return -1;
+}
+
+// Αναζήτηση του key σε ένα bucket, επιστρέφει τη θέση του ή -1.
+// Η compare καλείται μόνο για θέσεις με ίδιο tag (το tag απορρίπτει τα 255/256 των διαφορετικών keys).
+static ptrdiff_t find_in_bucket(Map map, size_t bucket, uint8_t tag, Pointer key) {
+	const uint8_t* tags = &map->tags[bucket * BUCKET_SLOTS];
+	for (int i = 0; i < BUCKET_SLOTS; i++)
+		if (tags[i] == tag && map->compare(map->array[bucket * BUCKET_SLOTS + i].key, key) == 0)
+			return bucket * BUCKET_SLOTS + i;
+	return -1;
+}
+
+// Δεσμεύει κενούς πίνακες για buckets buckets
+static void allocate_arrays(Map map, size_t buckets) {
+	map->buckets = buckets;
+	map->tags = calloc(buckets * BUCKET_SLOTS, sizeof(uint8_t));		// όλα EMPTY_TAG
+	map->array = aligned_alloc(BUCKET_SLOTS * sizeof(struct map_node), buckets * BUCKET_SLOTS * sizeof(struct map_node));
+	map->hashes = malloc(buckets * BUCKET_SLOTS * sizeof(uint64_t));
+}
+
+
+Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value) {
+	// Δεσμεύουμε κατάλληλα τον χώρο που χρειαζόμαστε για το hash table
+	Map map = malloc(sizeof(*map));
+	allocate_arrays(map, MIN_BUCKETS);
+
+	map->size = 0;
+	map->stash_size = 0;
+	map->reserved = 0;
+	map->rehashes = 0;
+	map->displacements = 0;
+	map->compare = compare;
+	map->hash_function = NULL;
+	map->hash_function64 = NULL;
+	map->destroy_key = destroy_key;
+	map->destroy_value = destroy_value;
+
+	return map;
+}
+
+Map map_create_sized(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value, size_t expected) {
+	Map map = map_create(compare, destroy_key, destroy_value);
+	map_reserve(map, expected);
+	return map;
+}
+
+// Επιστρέφει τον αριθμό των entries του map σε μία χρονική στιγμή.
+int map_size(Map map) {
+	return map->size;
+}
+
+size_t map_size64(Map map) {
+	return map->size;
+}
+
+// Το hash code του key, από όποια από τις δύο συναρτήσεις κατακερματισμού έχει οριστεί
+static inline uint64_t hash_of(Map map, Pointer key) {
+	return map->hash_function64 != NULL ? map->hash_function64(key) : map->hash_function(key);
+}
+
+// Ένα βήμα του μονοπατιού μετακινήσεων της make_room
+typedef struct {
+	size_t bucket;		// Το bucket του βήματος
+	int parent;			// Το προηγούμενο βήμα του μονοπατιού (-1 για τα αρχικά buckets)
+	size_t slot;		// Η θέση του parent της οποίας το key έχει εναλλακτικό bucket το bucket
+} PathStep;
+
+// Ψάχνει (BFS) ένα μονοπάτι μετακινήσεων από τα buckets του key μέχρι κάποιο bucket με κενή θέση,
+// και εκτελεί τις μετακινήσεις από το τέλος προς την αρχή, ώστε να αδειάσει μια θέση στα buckets του key.
+// Επιστρέφει τη θέση που άδειασε, ή -1 αν δε βρέθηκε μονοπάτι.
+static ptrdiff_t make_room(Map map, Location loc) {
+	PathStep queue[MAX_BFS];
+
+	int head = 0, tail = 0;
+	queue[tail++] = (PathStep){ loc.bucket1, -1, 0 };
+	queue[tail++] = (PathStep){ loc.bucket2, -1, 0 };
+
+	for (; head < tail; head++) {
+		ptrdiff_t empty = free_slot(map, queue[head].bucket);
+		if (empty == -1) {
+			// Γεμάτο bucket, προσθέτουμε στην ουρά τα εναλλακτικά buckets όλων των keys του
+			for (int i = 0; i < BUCKET_SLOTS && tail < MAX_BFS; i++) {
+				size_t slot = queue[head].bucket * BUCKET_SLOTS + i;
+				queue[tail++] = (PathStep){ alt_bucket(map, queue[head].bucket, map->tags[slot]), head, slot };
+			}
+			continue;
+		}
+
+		// Βρέθηκε κενή θέση, μετακινούμε κάθε key του μονοπατιού στην κενή θέση του επόμενου bucket
+		for (int step = head; queue[step].parent != -1; step = queue[step].parent) {
+			size_t from = queue[step].slot;
+
+			// Αν το μονοπάτι περνάει δύο φορές από το ίδιο bucket, κάποια θέση μπορεί να έχει ήδη αλλάξει.
+			// Οι μετακινήσεις που έγιναν είναι σωστές (κάθε key πήγε στο άλλο bucket του), απλά σταματάμε.
+			uint8_t tag = map->tags[from];
+			if (tag == EMPTY_TAG || alt_bucket(map, from / BUCKET_SLOTS, tag) != queue[step].bucket)
+				return -1;		// LCOV_EXCL_LINE
+
+			map->tags[empty] = tag;
+			map->array[empty] = map->array[from];
+			map->hashes[empty] = map->hashes[from];
+			map->tags[from] = EMPTY_TAG;
+			empty = from;
+			map->displacements++;
+		}
+		return empty;
+	}
+	return -1;
+}
+
+// Τοποθετεί στο hash table ένα key που σίγουρα δεν υπάρχει ήδη, και επιστρέφει τον κόμβο του. Επιστρέφει NULL αν
+// δεν υπάρχει θέση ούτε στα buckets του (μετά από μετακινήσεις) ούτε στο stash, οπότε πρέπει να γίνει rehash.
+static MapNode place(Map map, Pointer key, Pointer value, uint64_t hash, Location loc) {
+	ptrdiff_t pos = free_slot(map, loc.bucket1);
+	if (pos == -1)
+		pos = free_slot(map, loc.bucket2);
+	if (pos == -1)
+		pos = make_room(map, loc);
+
+	if (pos != -1) {
+		map->tags[pos] = loc.tag;
+		map->array[pos].key = key;
+		map->array[pos].value = value;
+		map->hashes[pos] = hash;
+		return &map->array[pos];
+	}
+
+	if (map->stash_size < STASH_SIZE) {
+		MapNode node = &map->stash[map->stash_size];
+		node->key = key;
+		node->value = value;
+		map->stash_hashes[map->stash_size] = hash;
+		map->stash_size++;
+		return node;
+	}
+	return NULL;
+}
+
+// Ξανατοποθετεί όλα τα στοιχεία (και αυτά του stash) σε new_buckets buckets
+static void rehash(Map map, size_t new_buckets) {
+	// Αποθήκευση των παλιών δεδομένων
+	size_t old_buckets = map->buckets;
+	uint8_t* old_tags = map->tags;
+	MapNode old_array = map->array;
+	uint64_t* old_hashes = map->hashes;
+
+	struct map_node old_stash[STASH_SIZE];
+	uint64_t old_stash_hashes[STASH_SIZE];
+	int old_stash_size = map->stash_size;
+	for (int i = 0; i < old_stash_size; i++) {
+		old_stash[i] = map->stash[i];
+		old_stash_hashes[i] = map->stash_hashes[i];
+	}
+
+	// Στην (απίθανη) περίπτωση που κάποιο key δε χωράει ούτε στον νέο πίνακα, διπλασιάζουμε ξανά
+	bool placed_all = false;
+	for (size_t buckets = new_buckets; !placed_all; buckets *= 2) {
+		allocate_arrays(map, buckets);
+		map->stash_size = 0;
+		map->rehashes++;
+
+		placed_all = true;
+		// Οι θέσεις υπολογίζονται από τα αποθηκευμένα hash codes, χωρίς να ξανακαλέσουμε την hash_function
+		for (size_t i = 0; i < old_buckets * BUCKET_SLOTS && placed_all; i++)
+			if (old_tags[i] != EMPTY_TAG)
+				placed_all = place(map, old_array[i].key, old_array[i].value, old_hashes[i], locate(map, old_hashes[i])) != NULL;
+
+		for (int i = 0; i < old_stash_size && placed_all; i++)
+			placed_all = place(map, old_stash[i].key, old_stash[i].value, old_stash_hashes[i], locate(map, old_stash_hashes[i])) != NULL;
+
+		if (!placed_all) {
+			free(map->tags);		// LCOV_EXCL_LINE
+			free(map->array);		// LCOV_EXCL_LINE
+			free(map->hashes);		// LCOV_EXCL_LINE
+		}
+	}
+
+	//Αποδεσμεύουμε τους παλιούς πίνακες ώστε να μήν έχουμε leaks
+	free(old_tags);
+	free(old_array);
+	free(old_hashes);
+}
+
+// Το μικρότερο πλήθος buckets (δύναμη του 2) στο οποίο χωράνε n στοιχεία χωρίς rehash
+static size_t buckets_for(size_t n) {
+	size_t buckets = MIN_BUCKETS;
+	while ((float)n / (buckets * BUCKET_SLOTS) > MAX_LOAD_FACTOR)
+		buckets *= 2;
+	return buckets;
+}
+
+// Μεγαλώνει τον πίνακα (αν χρειάζεται) ώστε να χωράει n στοιχεία
+static void reserve(Map map, size_t n) {
+	size_t buckets = buckets_for(n);
+	if (buckets > map->buckets)
+		rehash(map, buckets);
+}
+
+// Ο χώρος της map_reserve διατηρείται και όταν ο πίνακας μικραίνει (βλέπε shrink)
+void map_reserve(Map map, size_t n) {
+	if (n > map->reserved)
+		map->reserved = n;
+	reserve(map, n);
+}
+
+// Μικραίνει τον πίνακα αν ο load factor έπεσε κάτω από MIN_LOAD_FACTOR
+static void shrink(Map map) {
+	if (map->size >= map->buckets * BUCKET_SLOTS * MIN_LOAD_FACTOR)
+		return;
+
+	size_t buckets = buckets_for(2 * map->size > map->reserved ? 2 * map->size : map->reserved);
+	if (buckets < map->buckets)
+		rehash(map, buckets);
+}
+
+void map_compact(Map map) {
+	// Δεν υπάρχουν DELETED θέσεις, οπότε το rehash χρειάζεται μόνο αν ο πίνακας μικραίνει. Στην (απίθανη)
+	// περίπτωση που τα keys δε χωράνε στα λιγότερα buckets, η rehash διπλασιάζει ξανά το πλήθος τους.
+	map->reserved = 0;
+	size_t buckets = buckets_for(map->size);
+	if (buckets < map->buckets)
+		rehash(map, buckets);
+}
+
+// Επιστρέφει τον κόμβο του key (με hash code hash) στα buckets ή στο stash, ή MAP_EOF
+static MapNode find_node(Map map, Pointer key, uint64_t hash) {
+	Location loc = locate(map, hash);
+	ptrdiff_t pos = find_in_bucket(map, loc.bucket1, loc.tag, key);
+	if (pos == -1)
+		pos = find_in_bucket(map, loc.bucket2, loc.tag, key);
+	if (pos != -1)
+		return &map->array[pos];
+
+	for (int i = 0; i < map->stash_size; i++)
+		if (map->stash_hashes[i] == hash && map->compare(map->stash[i].key, key) == 0)
+			return &map->stash[i];
+
+	return MAP_EOF;
+}
+
+// Η map_find_or_insert για key με ήδη υπολογισμένο hash code: επιστρέφει τον κόμβο του key, ή αν δεν
+// υπάρχει το τοποθετεί με τιμή NULL. Η αναζήτηση στα δύο buckets σημειώνει την πρώτη κενή θέση τους,
+// οπότε στη συνήθη περίπτωση η εισαγωγή γίνεται χωρίς να ξαναδιαβάσουμε τα buckets.
+static MapNode find_or_insert_hashed(Map map, Pointer key, uint64_t hash, bool* inserted) {
+	*inserted = false;
+	Location loc = locate(map, hash);
+	ptrdiff_t empty = -1;
+	size_t buckets[2] = { loc.bucket1, loc.bucket2 };
+	for (int b = 0; b < 2; b++) {
+		for (int i = 0; i < BUCKET_SLOTS; i++) {
+			size_t pos = buckets[b] * BUCKET_SLOTS + i;
+			if (map->tags[pos] == EMPTY_TAG) {
+				if (empty == -1)
+					empty = pos;
+			} else if (map->tags[pos] == loc.tag && map->compare(map->array[pos].key, key) == 0) {
+				return &map->array[pos];
+			}
+		}
+	}
+
+	for (int i = 0; i < map->stash_size; i++)
+		if (map->stash_hashes[i] == hash && map->compare(map->stash[i].key, key) == 0)
+			return &map->stash[i];
+
+	// Νέο στοιχείο. Αν με την εισαγωγή ξεπερνάμε το μέγιστο load factor, κάνουμε πρώτα rehash.
+	*inserted = true;
+	map->size++;
+	float load_factor = (float)map->size / (map->buckets * BUCKET_SLOTS);
+	if (empty != -1 && load_factor <= MAX_LOAD_FACTOR) {
+		map->tags[empty] = loc.tag;
+		map->array[empty].key = key;
+		map->array[empty].value = NULL;
+		map->hashes[empty] = hash;
+		return &map->array[empty];
+	}
+
+	if (load_factor > MAX_LOAD_FACTOR)
+		rehash(map, map->buckets * 2);
+
+	MapNode node;
+	while ((node = place(map, key, NULL, hash, locate(map, hash))) == NULL)
+		rehash(map, map->buckets * 2);
+	return node;
+}
+
+// Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει,
+// ανανέωση του με ένα νέο value.
+// Η map_insert για key με ήδη υπολογισμένο hash code
+static void insert_hashed(Map map, Pointer key, Pointer value, uint64_t hash) {
+	bool inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash, &inserted);
+	if (!inserted) {
+		// Αν αντικαθιστούμε παλιά key/value, τa κάνουμε destroy
+		if (node->key != key && map->destroy_key != NULL)
+			map->destroy_key(node->key);
+		if (node->value != value && map->destroy_value != NULL)
+			map->destroy_value(node->value);
+
+		node->key = key;
+	}
+	node->value = value;
+}
+
+void map_insert(Map map, Pointer key, Pointer value) {
+	insert_hashed(map, key, value, hash_of(map, key));
+}
+
+// Η map_insert_batch υπολογίζει τα hash codes σε ομάδες των BATCH_SIZE keys, και φορτώνει στην cache
+// τη θέση κάθε key PREFETCH_DISTANCE εισαγωγές πριν από αυτή, ώστε οι αναμονές για τη μνήμη να επικαλύπτονται.
+#define BATCH_SIZE 64
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 8
+#endif
+
+// Φορτώνει στην cache (χωρίς να περιμένει) τα tags των δύο buckets του hash και τους κόμβους του πρώτου
+static inline void prefetch(Map map, uint64_t hash) {
+	Location loc = locate(map, hash);
+	__builtin_prefetch(&map->tags[loc.bucket1 * BUCKET_SLOTS], 1);
+	__builtin_prefetch(&map->tags[loc.bucket2 * BUCKET_SLOTS], 1);
+	__builtin_prefetch(&map->array[loc.bucket1 * BUCKET_SLOTS], 1);
+}
+
+void map_insert_batch(Map map, Pointer* keys, Pointer* values, size_t n) {
+	// Δεσμεύουμε μία φορά χώρο για όλα τα στοιχεία (αν κάποια keys υπάρχουν ήδη, απλά περισσεύει χώρος)
+	reserve(map, map->size + n);
+
+	uint64_t hashes[BATCH_SIZE];
+	for (size_t start = 0; start < n; start += BATCH_SIZE) {
+		size_t count = n - start < BATCH_SIZE ? n - start : BATCH_SIZE;
+		for (size_t i = 0; i < count; i++) {
+			hashes[i] = hash_of(map, keys[start + i]);
+			if (i < PREFETCH_DISTANCE)
+				prefetch(map, hashes[i]);
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			if (i + PREFETCH_DISTANCE < count)
+				prefetch(map, hashes[i + PREFETCH_DISTANCE]);
+
+			insert_hashed(map, keys[start + i], values != NULL ? values[start + i] : NULL, hashes[i]);
+		}
+	}
+}
+
+// Διαργραφή απο το Hash Table του κλειδιού με τιμή key
+bool map_remove(Map map, Pointer key) {
+	MapNode node = find_node(map, key, hash_of(map, key));
+	if (node == MAP_EOF)
+		return false;
+
+	// destroy
+	if (map->destroy_key != NULL)
+		map->destroy_key(node->key);
+	if (map->destroy_value != NULL)
+		map->destroy_value(node->value);
+
+	// Στο stash μεταφέρουμε το τελευταίο στοιχείο στη θέση του node, στα buckets απλά αδειάζουμε το tag
+	if (node >= map->stash && node < map->stash + STASH_SIZE) {
+		map->stash_size--;
+		*node = map->stash[map->stash_size];
+		map->stash_hashes[node - map->stash] = map->stash_hashes[map->stash_size];
+	} else {
+		map->tags[node - map->array] = EMPTY_TAG;
+	}
+
+	map->size--;
+	shrink(map);
+	return true;
+}
+
+// Αναζήτηση στο map, με σκοπό να επιστραφεί το value του κλειδιού που περνάμε σαν όρισμα.
+Pointer map_find(Map map, Pointer key) {
+	MapNode node = map_find_node(map, key);
+	if (node != MAP_EOF)
+		return node->value;
+	else
+		return NULL;
+}
+
+// Στη map_find_batch (βλέπε ADTMap.h) το πρώτο βήμα ελέγχει τα tags των δύο buckets του key, και το δεύτερο
+// τους κόμβους με ίδιο tag και το stash.
+
+// Η κατάσταση μιας αναζήτησης της map_find_batch
+typedef struct {
+	size_t index;		// Η θέση του key στον πίνακα keys
+	uint64_t hash;
+	bool hashed;		// Έχει υπολογιστεί το hash code (στο πρώτο βήμα, αφού γίνει prefetch στο key)
+	Location loc;		// Τα buckets του key (έχει ήδη γίνει prefetch στα tags τους)
+	bool nodes;			// Έγινε ο πρώτος γύρος (prefetch στους κόμβους των buckets με ίδιο tag)
+} Lookup;
+
+// Υπολογίζει το hash code του key της l και κάνει prefetch στη θέση του
+static void lookup_hash(Map map, Lookup* l, Pointer key) {
+	l->hash = hash_of(map, key);
+	l->loc = locate(map, l->hash);
+	l->nodes = false;
+	__builtin_prefetch(&map->tags[l->loc.bucket1 * BUCKET_SLOTS]);
+	__builtin_prefetch(&map->tags[l->loc.bucket2 * BUCKET_SLOTS]);
+}
+
+// Αν κάποια θέση του bucket έχει το tag, κάνει prefetch στους κόμβους του
+static bool prefetch_matching(Map map, size_t bucket, uint8_t tag) {
+	for (int i = 0; i < BUCKET_SLOTS; i++)
+		if (map->tags[bucket * BUCKET_SLOTS + i] == tag) {
+			__builtin_prefetch(&map->array[bucket * BUCKET_SLOTS]);
+			return true;
+		}
+	return false;
+}
+
+#include "../ADTMapFindBatch.h"
+
+// Ένα βήμα της αναζήτησης l (σε δύο γύρους: τα tags και οι κόμβοι), επιστρέφει true αν ολοκληρώθηκε
+static bool lookup_step(Map map, Lookup* l, Pointer* keys, Pointer* out_values) {
+	if (!l->nodes) {
+		// Ο | (όχι ||) ώστε να γίνει prefetch και στα δύο buckets
+		bool matching = prefetch_matching(map, l->loc.bucket1, l->loc.tag) | prefetch_matching(map, l->loc.bucket2, l->loc.tag);
+		if (!matching && map->stash_size == 0)
+			return lookup_finish(l, out_values, MAP_EOF);	// κανένα tag δεν ταιριάζει και το stash είναι άδειο
+
+		l->nodes = true;
+		return false;
+	}
+	return lookup_finish(l, out_values, find_node(map, keys[l->index], l->hash));
+}
+
+
+DestroyFunc map_set_destroy_key(Map map, DestroyFunc destroy_key) {
+	DestroyFunc old = map->destroy_key;
+	map->destroy_key = destroy_key;
+	return old;
+}
+
+DestroyFunc map_set_destroy_value(Map map, DestroyFunc destroy_value) {
+	DestroyFunc old = map->destroy_value;
+	map->destroy_value = destroy_value;
+	return old;
+}
+
+// Απελευθέρωση μνήμης που δεσμεύει το map
+void map_destroy(Map map) {
+	if (map->destroy_key != NULL || map->destroy_value != NULL) {
+		for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node)) {
+			if (map->destroy_key != NULL)
+				map->destroy_key(node->key);
+			if (map->destroy_value != NULL)
+				map->destroy_value(node->value);
+		}
+	}
+
+	free(map->tags);
+	free(map->array);
+	free(map->hashes);
+	free(map);
+}
+
+/////////////////////// Διάσχιση του map μέσω κόμβων ///////////////////////////
+//
+// Διασχίζουμε πρώτα όλες τις θέσεις των buckets και μετά το stash.
+
+// Επιστρέφει τον πρώτο κόμβο με θέση >= pos (στα buckets ή στο stash). Τα tags είναι ήδη ένα πυκνό
+// bitmap κατάληψης (ένα byte ανά θέση), οπότε τα διαβάζουμε 8 τη φορά και προσπερνάμε με μία σύγκριση
+// τις 8 κενές θέσεις, χωρίς να αγγίξουμε τους κόμβους τους (ο αριθμός των θέσεων είναι πολλαπλάσιο του 8).
+static MapNode first_from(Map map, size_t pos) {
+	size_t slots = map->buckets * BUCKET_SLOTS;
+	size_t i = pos;
+	for (; i < slots && i % 8 != 0; i++)		// μέχρι την αρχή μιας λέξης, μία θέση τη φορά
+		if (map->tags[i] != EMPTY_TAG)
+			return &map->array[i];
+
+	for (; i < slots; i += 8) {
+		uint64_t word;
+		memcpy(&word, &map->tags[i], sizeof(word));
+		if (word != 0)
+			for (int j = 0; ; j++)				// EMPTY_TAG == 0, οπότε κάποιο από τα 8 tags δεν είναι EMPTY_TAG
+				if (map->tags[i + j] != EMPTY_TAG)
+					return &map->array[i + j];
+	}
+
+	return map->stash_size > 0 ? &map->stash[0] : MAP_EOF;
+}
+
+MapNode map_first(Map map) {
+	return first_from(map, 0);
+}
+
+MapNode map_next(Map map, MapNode node) {
+	if (node >= map->stash && node < map->stash + STASH_SIZE) {
+		int i = node - map->stash + 1;
+		return i < map->stash_size ? &map->stash[i] : MAP_EOF;
+	}
+
+	// Το node είναι pointer στο i-οστό στοιχείο του array, οπότε node - array == i  (pointer arithmetic!)
+	return first_from(map, node - map->array + 1);
+}
+
+Pointer map_node_key(Map map, MapNode node) {
+	return node->key;
+}
+
+Pointer map_node_value(Map map, MapNode node) {
+	return node->value;
+}
+
+MapNode map_find_node(Map map, Pointer key) {
+	return find_node(map, key, hash_of(map, key));
+}
+
+MapNode map_find_or_insert(Map map, Pointer key, bool* inserted) {
+	bool was_inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash_of(map, key), &was_inserted);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+MapNode map_find_or_insert_with(Map map, Pointer key, CreateValueFunc create_value, bool* inserted) {
+	bool was_inserted;
+	MapNode node = map_find_or_insert(map, key, &was_inserted);
+	if (was_inserted)
+		node->value = create_value(key);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	node->value = value;
+}
+
+// Αρχικοποίηση της συνάρτησης κατακερματισμού του συγκεκριμένου map.
+void map_set_hash_function(Map map, HashFunc func) {
+	map->hash_function = func;
+	map->hash_function64 = NULL;
+}
+
+void map_set_hash_function64(Map map, HashFunc64 func) {
+	map->hash_function64 = func;
+}
+
+// Οι χωρητικότητες είναι πάντα δυνάμεις του 2 (με Fibonacci hashing), οπότε η πολιτική δεν αλλάζει κάτι
+void map_set_capacity_policy(Map map, MapCapacityPolicy policy) {
+}
+
+// Κάθε key έχει δύο buckets (όχι γειτονιά), οπότε η map_set_neighbourhood δεν αλλάζει κάτι
+void map_set_neighbourhood(Map map, int neighbourhood) {
+}
+
+#include "../ADTMapHash.h"
+
+/////////////////////// Στατιστικά ///////////////////////////
+
+void map_stats(Map map, MapStats* stats) {
+	size_t slots = map->buckets * BUCKET_SLOTS;
+	*stats = (MapStats){
+		.size = map->size,
+		.capacity = slots,
+		.load_factor = (double)map->size / slots,
+		.displacements = map->displacements,
+		.rehashes = map->rehashes,
+		.bytes = sizeof(*map) + slots * (sizeof(uint8_t) + sizeof(struct map_node) + sizeof(uint64_t)),
+	};
+
+	// Το probe length είναι 0 για τα keys στο πρώτο τους bucket, 1 στο δεύτερο και 2 στο stash
+	for (size_t pos = 0; pos < slots; pos++)
+		if (map->tags[pos] != EMPTY_TAG)
+			stats->probe_lengths[locate(map, map->hashes[pos]).bucket1 == pos / BUCKET_SLOTS ? 0 : 1]++;
+
+	stats->probe_lengths[2] += map->stash_size;
+}
@@ -0,0 +1,571 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// Υλοποίηση του ADT Map μέσω "compact" hash table (όπως το dict της CPython):
+// ένας μικρός πίνακας από indices με open addressing, που δείχνουν σε έναν
+// συνεχόμενο πίνακα με τα στοιχεία στη σειρά εισαγωγής
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ADTMap.h"
+
+
+// Οι θέσεις του hash table δεν περιέχουν τα ίδια τα στοιχεία, αλλά τη θέση τους (index) στον πίνακα
+// entries, ή EMPTY_INDEX / DELETED_INDEX. Τα indices είναι ακέραιοι των 1, 2, 4 ή 8 bytes, ανάλογα με
+// το μέγεθος του πίνακα, οπότε κάθε κενή θέση κοστίζει 1-4 bytes αντί για έναν ολόκληρο κόμβο.
+// Όπως στο UsingHashTable, η αναζήτηση σταματάει στις EMPTY θέσεις και συνεχίζει στις DELETED.
+#define EMPTY_INDEX		-1
+#define DELETED_INDEX	-2
+
+// Το μέγεθος του πίνακα των indices είναι πάντα δύναμη του 2
+#define MIN_CAPACITY 8
+
+// Σε κάθε βήμα της αναζήτησης, PERTURB_SHIFT ακόμα bits του hash επηρεάζουν την επόμενη θέση
+#define PERTURB_SHIFT 5
+
+// Ο πίνακας indices μικραίνει κάτω από αυτόν τον load factor (βλέπε map_compact στο ADTMap.h). Το άνω όριο εδώ
+// δεν είναι κάποιο MAX_LOAD_FACTOR αλλά το 2/3 της usable, στο οποίο μετράνε και τα διαγραμμένα entries.
+#define MIN_LOAD_FACTOR 0.125
+
+// Δομή του κάθε στοιχείου. Τα στοιχεία αποθηκεύονται το ένα μετά το άλλο στον πίνακα entries, με τη σειρά
+// εισαγωγής, χωρίς κενές θέσεις ανάμεσά τους. Τα διαγραμμένα στοιχεία έχουν key == DELETED_KEY και
+// αφαιρούνται από τον πίνακα στο επόμενο rehash.
+struct map_node {
+	uint64_t hash;		// Το hash code του key, ώστε το rehash να μην ξανακαλεί την hash_function
+	Pointer key;		// Το κλειδί που χρησιμοποιείται για να hash-αρουμε
+	Pointer value;		// Η τιμή που αντισοιχίζεται στο παραπάνω κλειδί
+};
+
+// Η διεύθυνση της deleted_key δεν μπορεί να είναι key κάποιου στοιχείου
+static char deleted_key;
+#define DELETED_KEY ((Pointer)&deleted_key)
+
+// Δομή του Map
+struct map {
+	void* indices;				// Ο πίνακας του hash table, capacity indices των width bytes
+	int width;					// Τα bytes κάθε index (1, 2, 4 ή 8)
+	size_t capacity;			// Πόσες θέσεις έχει ο πίνακας indices (δύναμη του 2)
+	MapNode entries;			// Τα στοιχεία με τη σειρά εισαγωγής (χώρος για usable(capacity) στοιχεία)
+	size_t used;				// Πόσα entries έχουν χρησιμοποιηθεί (μαζί με τα διαγραμμένα)
+	size_t size;				// Πόσα στοιχεία έχουμε προσθέσει
+	size_t reserved;			// Ο χώρος (σε στοιχεία) της map_reserve, κάτω από τον οποίο ο πίνακας δε μικραίνει
+	int rehashes;				// Πόσα rehash έχουν γίνει (για τη map_stats)
+	CompareFunc compare;		// Συνάρτηση για σύγκριση δεικτών, που πρέπει να δίνεται απο τον χρήστη
+	HashFunc hash_function;		// Συνάρτηση για να παίρνουμε το hash code του κάθε αντικειμένου.
+	HashFunc64 hash_function64;	// Η συνάρτηση 64 bits, αν έχει οριστεί (διαφορετικά NULL και χρησιμοποιείται η hash_function)
+	DestroyFunc destroy_key;	// Συναρτήσεις που καλούνται όταν διαγράφουμε έναν κόμβο απο το map.
+	DestroyFunc destroy_value;
+};
+
+
+//////////////////////// Ο πίνακας των indices ////////////////////////
+
+// Πόσα entries χωράνε σε πίνακα indices capacity θέσεων. Μετράνε και τα διαγραμμένα, οπότε ο load factor
+// είναι το πολύ 2/3 και το hash table έχει πάντα EMPTY θέσεις (τα indices είναι μικρά, οπότε οι κενές θέσεις κοστίζουν λίγο).
+static inline size_t usable(size_t capacity) {
+	return capacity * 2 / 3;
+}
+
+// Τα bytes που χρειάζεται κάθε index σε πίνακα capacity θέσεων (τα indices είναι μικρότερα από usable(capacity))
+static int index_width(size_t capacity) {
+	if (capacity <= 128)
+		return 1;
+	if (capacity <= 1ull << 15)
+		return 2;
+	if (capacity <= 1ull << 31)
+		return 4;
+	return 8;
+}
+
+static inline int64_t get_index(Map map, size_t pos) {
+	switch (map->width) {
+	case 1:  return ((int8_t*)map->indices)[pos];
+	case 2:  return ((int16_t*)map->indices)[pos];
+	case 4:  return ((int32_t*)map->indices)[pos];
+	default: return ((int64_t*)map->indices)[pos];
+	}
+}
+
+static inline void set_index(Map map, size_t pos, int64_t index) {
+	switch (map->width) {
+	case 1:  ((int8_t*)map->indices)[pos] = index; break;
+	case 2:  ((int16_t*)map->indices)[pos] = index; break;
+	case 4:  ((int32_t*)map->indices)[pos] = index; break;
+	default: ((int64_t*)map->indices)[pos] = index; break;
+	}
+}
+
+// Η διεύθυνση της θέσης pos του πίνακα indices (για prefetch)
+static inline void* index_address(Map map, size_t pos) {
+	return (char*)map->indices + pos * map->width;
+}
+
+// Δεσμεύει πίνακες χωρητικότητας capacity, με όλα τα indices EMPTY_INDEX
+static void allocate_arrays(Map map, size_t capacity) {
+	map->capacity = capacity;
+	map->width = index_width(capacity);
+	map->indices = malloc(capacity * map->width);
+	memset(map->indices, 0xFF, capacity * map->width);		// όλα τα bytes 0xFF, δηλαδή -1 για κάθε width
+	map->entries = malloc(usable(capacity) * sizeof(struct map_node));
+	map->used = 0;
+}
+
+
+//////////////////////// Hashing και probing ////////////////////////
+//
+// Το hash που δίνει ο χρήστης μπορεί να είναι πολύ "φτωχό" (πχ το hash_int είναι η ίδια η τιμή), οπότε το
+// ανακατεύουμε με έναν πολλαπλασιασμό (Fibonacci hashing), και η αρχική θέση είναι τα χαμηλά bits του
+// αποτελέσματος μετά από περιστροφή κατά 32 bits (όπως το H1 του UsingSwissTable). Οι επόμενες θέσεις
+// ακολουθούν την αναδρομή της CPython pos = 5 * pos + 1 + perturb, όπου το perturb είναι τα bits του hash που
+// απομένουν: στα πρώτα βήματα τα keys με ίδια αρχική θέση ακολουθούν διαφορετικές ακολουθίες, και όταν
+// μηδενιστεί το perturb η αναδρομή επισκέπτεται όλες τις θέσεις του πίνακα.
+
+typedef struct {
+	size_t pos;			// Η τρέχουσα θέση του πίνακα indices
+	uint64_t perturb;
+} Probe;
+
+static inline Probe probe_start(Map map, uint64_t hash) {
+	uint64_t mixed = hash * 0x9E3779B97F4A7C15ull;
+	uint64_t perturb = mixed >> 32 | mixed << 32;
+	return (Probe){ .pos = perturb & (map->capacity - 1), .perturb = perturb };
+}
+
+static inline void probe_next(Map map, Probe* probe) {
+	probe->perturb >>= PERTURB_SHIFT;
+	probe->pos = (probe->pos * 5 + probe->perturb + 1) & (map->capacity - 1);
+}
+
+// Βρίσκει την πρώτη ελεύθερη (EMPTY ή DELETED) θέση στην ακολουθία αναζήτησης του hash.
+// Ο load factor εγγυάται ότι υπάρχει τουλάχιστον μία EMPTY θέση, οπότε η επανάληψη τερματίζει.
+static size_t find_free_slot(Map map, uint64_t hash) {
+	Probe probe = probe_start(map, hash);
+	while (get_index(map, probe.pos) >= 0)
+		probe_next(map, &probe);
+	return probe.pos;
+}
+
+// Αναζήτηση του key. Επιστρέφει τη θέση του πίνακα indices που δείχνει στο entry του, ή -1 αν δεν υπάρχει.
+// Η compare καλείται μόνο για entries με ίδιο hash code.
+static ptrdiff_t find_slot(Map map, Pointer key, uint64_t hash) {
+	for (Probe probe = probe_start(map, hash); ; probe_next(map, &probe)) {
+		int64_t index = get_index(map, probe.pos);
+		if (index == EMPTY_INDEX)
+			return -1;
+
+		if (index >= 0 && map->entries[index].hash == hash && map->compare(map->entries[index].key, key) == 0)
+			return probe.pos;
+	}
+}
+
+
+Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value) {
+	// Δεσμεύουμε κατάλληλα τον χώρο που χρειαζόμαστε για το hash table
+	Map map = malloc(sizeof(*map));
+	allocate_arrays(map, MIN_CAPACITY);
+
+	map->size = 0;
+	map->reserved = 0;
+	map->rehashes = 0;
+	map->compare = compare;
+	map->hash_function = NULL;
+	map->hash_function64 = NULL;
+	map->destroy_key = destroy_key;
+	map->destroy_value = destroy_value;
+
+	return map;
+}
+
+Map map_create_sized(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value, size_t expected) {
+	Map map = map_create(compare, destroy_key, destroy_value);
+	map_reserve(map, expected);
+	return map;
+}
+
+// Επιστρέφει τον αριθμό των entries του map σε μία χρονική στιγμή.
+int map_size(Map map) {
+	return map->size;
+}
+
+size_t map_size64(Map map) {
+	return map->size;
+}
+
+// Το hash code του key, από όποια από τις δύο συναρτήσεις κατακερματισμού έχει οριστεί
+static inline uint64_t hash_of(Map map, Pointer key) {
+	return map->hash_function64 != NULL ? map->hash_function64(key) : map->hash_function(key);
+}
+
+// Ξαναχτίζει το hash table σε πίνακα new_capacity θέσεων. Τα entries μεταφέρονται με την ίδια σειρά,
+// χωρίς τα διαγραμμένα, οπότε και ο νέος πίνακας entries δεν έχει κενά.
+static void resize(Map map, size_t new_capacity) {
+	// Αποθήκευση των παλιών δεδομένων
+	void* old_indices = map->indices;
+	MapNode old_entries = map->entries;
+	size_t old_used = map->used;
+	map->rehashes++;
+	allocate_arrays(map, new_capacity);
+
+	// Τα keys είναι σίγουρα διαφορετικά μεταξύ τους, οπότε τα τοποθετούμε χωρίς αναζήτηση
+	// (και χωρίς να ξανακαλέσουμε την hash_function, το hash code είναι αποθηκευμένο στο entry)
+	for (size_t i = 0; i < old_used; i++) {
+		if (old_entries[i].key == DELETED_KEY)
+			continue;
+
+		set_index(map, find_free_slot(map, old_entries[i].hash), map->used);
+		map->entries[map->used++] = old_entries[i];
+	}
+
+	//Αποδεσμεύουμε τους παλιούς πίνακες ώστε να μήν έχουμε leaks
+	free(old_indices);
+	free(old_entries);
+}
+
+// Η μικρότερη χωρητικότητα στην οποία χωράνε n στοιχεία χωρίς rehash
+static size_t capacity_for(size_t n) {
+	size_t capacity = MIN_CAPACITY;
+	while (usable(capacity) < n)
+		capacity *= 2;
+	return capacity;
+}
+
+// Μεγαλώνει τον πίνακα (αν χρειάζεται) ώστε να χωράει n στοιχεία
+static void reserve(Map map, size_t n) {
+	size_t capacity = capacity_for(n);
+	if (capacity > map->capacity)
+		resize(map, capacity);
+}
+
+// Ο χώρος της map_reserve διατηρείται και όταν ο πίνακας μικραίνει (βλέπε shrink)
+void map_reserve(Map map, size_t n) {
+	if (n > map->reserved)
+		map->reserved = n;
+	reserve(map, n);
+}
+
+// Μικραίνει τους πίνακες αν ο load factor έπεσε κάτω από MIN_LOAD_FACTOR
+static void shrink(Map map) {
+	if (map->size >= map->capacity * MIN_LOAD_FACTOR)
+		return;
+
+	size_t capacity = capacity_for(2 * map->size > map->reserved ? 2 * map->size : map->reserved);
+	if (capacity < map->capacity)
+		resize(map, capacity);
+}
+
+void map_compact(Map map) {
+	// Ο νέος πίνακας entries (χωρίς τα διαγραμμένα) δημιουργείται ακόμα και αν η χωρητικότητα δεν αλλάζει
+	map->reserved = 0;
+	resize(map, capacity_for(map->size));
+}
+
+// Η map_find_or_insert για key με ήδη υπολογισμένο hash code: επιστρέφει τον κόμβο του key, ή αν δεν
+// υπάρχει τον προσθέτει στο τέλος του entries με τιμή NULL. Η αναζήτηση (όπως στη find_slot) σημειώνει
+// την πρώτη ελεύθερη θέση των indices, αυτή που θα έβρισκε η find_free_slot, ώστε να μη γίνει δεύτερη διάσχιση.
+static MapNode find_or_insert_hashed(Map map, Pointer key, uint64_t hash, bool* inserted) {
+	ptrdiff_t free_slot = -1;
+	for (Probe probe = probe_start(map, hash); ; probe_next(map, &probe)) {
+		int64_t index = get_index(map, probe.pos);
+		if (index < 0 && free_slot == -1)
+			free_slot = probe.pos;
+		if (index == EMPTY_INDEX)
+			break;
+
+		if (index >= 0 && map->entries[index].hash == hash && map->compare(map->entries[index].key, key) == 0) {
+			*inserted = false;
+			return &map->entries[index];
+		}
+	}
+
+	// Νέο στοιχείο. Αν ο πίνακας entries είναι γεμάτος κάνουμε πρώτα rehash, σε πίνακα με χώρο για τα διπλάσια
+	// (μη διαγραμμένα) στοιχεία. Αν πολλά entries είναι διαγραμμένα, αυτό απλά τα αφαιρεί χωρίς να μεγαλώσει τον πίνακα.
+	if (map->used == usable(map->capacity)) {
+		size_t capacity = capacity_for(2 * map->size);
+		resize(map, capacity > map->capacity ? capacity : map->capacity);
+		free_slot = find_free_slot(map, hash);
+	}
+
+	set_index(map, free_slot, map->used);
+	map->entries[map->used] = (struct map_node){ .hash = hash, .key = key, .value = NULL };
+	map->size++;
+	*inserted = true;
+	return &map->entries[map->used++];
+}
+
+// Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει,
+// ανανέωση του με ένα νέο value.
+// Η map_insert για key με ήδη υπολογισμένο hash code
+static void insert_hashed(Map map, Pointer key, Pointer value, uint64_t hash) {
+	bool inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash, &inserted);
+	if (!inserted) {
+		// Αν αντικαθιστούμε παλιά key/value, τa κάνουμε destroy
+		if (node->key != key && map->destroy_key != NULL)
+			map->destroy_key(node->key);
+
+		if (node->value != value && map->destroy_value != NULL)
+			map->destroy_value(node->value);
+
+		node->key = key;
+	}
+	node->value = value;
+}
+
+void map_insert(Map map, Pointer key, Pointer value) {
+	insert_hashed(map, key, value, hash_of(map, key));
+}
+
+// Η map_insert_batch υπολογίζει τα hash codes σε ομάδες των BATCH_SIZE keys, και φορτώνει στην cache
+// τη θέση κάθε key PREFETCH_DISTANCE εισαγωγές πριν από αυτή, ώστε οι αναμονές για τη μνήμη να επικαλύπτονται.
+#define BATCH_SIZE 64
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 8
+#endif
+
+// Φορτώνει στην cache (χωρίς να περιμένει) την αρχική θέση του hash στον πίνακα indices. Τα νέα entries
+// γράφονται στο τέλος του πίνακα entries, που είναι ήδη στην cache.
+static inline void prefetch(Map map, uint64_t hash) {
+	__builtin_prefetch(index_address(map, probe_start(map, hash).pos), 1);
+}
+
+void map_insert_batch(Map map, Pointer* keys, Pointer* values, size_t n) {
+	// Δεσμεύουμε μία φορά χώρο για όλα τα στοιχεία (αν κάποια keys υπάρχουν ήδη, απλά περισσεύει χώρος)
+	reserve(map, map->size + n);
+
+	uint64_t hashes[BATCH_SIZE];
+	for (size_t start = 0; start < n; start += BATCH_SIZE) {
+		size_t count = n - start < BATCH_SIZE ? n - start : BATCH_SIZE;
+		for (size_t i = 0; i < count; i++) {
+			hashes[i] = hash_of(map, keys[start + i]);
+			if (i < PREFETCH_DISTANCE)
+				prefetch(map, hashes[i]);
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			if (i + PREFETCH_DISTANCE < count)
+				prefetch(map, hashes[i + PREFETCH_DISTANCE]);
+
+			insert_hashed(map, keys[start + i], values != NULL ? values[start + i] : NULL, hashes[i]);
+		}
+	}
+}
+
+// Διαργραφή απο το Hash Table του κλειδιού με τιμή key
+bool map_remove(Map map, Pointer key) {
+	ptrdiff_t slot = find_slot(map, key, hash_of(map, key));
+	if (slot == -1)
+		return false;
+
+	// destroy
+	MapNode node = &map->entries[get_index(map, slot)];
+	if (map->destroy_key != NULL)
+		map->destroy_key(node->key);
+	if (map->destroy_value != NULL)
+		map->destroy_value(node->value);
+
+	// Τα υπόλοιπα entries δε μετακινούνται (οι MapNode τους μένουν έγκυροι), το entry
+	// μένει κενό μέχρι το επόμενο rehash και η θέση του hash table γίνεται DELETED.
+	node->key = DELETED_KEY;
+	node->value = NULL;
+	set_index(map, slot, DELETED_INDEX);
+	map->size--;
+	shrink(map);
+
+	return true;
+}
+
+// Αναζήτηση στο map, με σκοπό να επιστραφεί το value του κλειδιού που περνάμε σαν όρισμα.
+Pointer map_find(Map map, Pointer key) {
+	MapNode node = map_find_node(map, key);
+	if (node != MAP_EOF)
+		return node->value;
+	else
+		return NULL;
+}
+
+// Στη map_find_batch (βλέπε ADTMap.h) κάθε θέση του πίνακα indices ελέγχεται σε δύο βήματα: το index και το
+// entry στο οποίο δείχνει.
+
+// Η κατάσταση μιας αναζήτησης της map_find_batch
+typedef struct {
+	size_t index;		// Η θέση του key στον πίνακα keys
+	uint64_t hash;
+	bool hashed;		// Έχει υπολογιστεί το hash code (στο πρώτο βήμα, αφού γίνει prefetch στο key)
+	Probe probe;		// Η θέση του πίνακα indices που ελέγχεται στο επόμενο βήμα (έχει ήδη γίνει prefetch)
+	int64_t entry;		// Αν >= 0, το entry που ελέγχεται στο επόμενο βήμα (έχει ήδη γίνει prefetch)
+} Lookup;
+
+// Υπολογίζει το hash code του key της l και κάνει prefetch στη θέση του
+static void lookup_hash(Map map, Lookup* l, Pointer key) {
+	l->hash = hash_of(map, key);
+	l->probe = probe_start(map, l->hash);
+	l->entry = EMPTY_INDEX;
+	__builtin_prefetch(index_address(map, l->probe.pos));
+}
+
+#include "../ADTMapFindBatch.h"
+
+// Ένα βήμα της αναζήτησης l (σε δύο γύρους για κάθε θέση: index και entry), επιστρέφει true αν ολοκληρώθηκε
+static bool lookup_step(Map map, Lookup* l, Pointer* keys, Pointer* out_values) {
+	if (l->entry < 0) {
+		// Πρώτος γύρος: διαβάζουμε το index και κάνουμε prefetch στο entry του
+		l->entry = get_index(map, l->probe.pos);
+		if (l->entry == EMPTY_INDEX)
+			return lookup_finish(l, out_values, MAP_EOF);
+		if (l->entry >= 0) {
+			__builtin_prefetch(&map->entries[l->entry]);
+			return false;
+		}
+	} else {
+		// Δεύτερος γύρος: ελέγχουμε το entry
+		MapNode node = &map->entries[l->entry];
+		if (node->hash == l->hash && map->compare(node->key, keys[l->index]) == 0)
+			return lookup_finish(l, out_values, node);
+	}
+
+	l->entry = EMPTY_INDEX;
+	probe_next(map, &l->probe);
+	__builtin_prefetch(index_address(map, l->probe.pos));
+	return false;
+}
+
+
+DestroyFunc map_set_destroy_key(Map map, DestroyFunc destroy_key) {
+	DestroyFunc old = map->destroy_key;
+	map->destroy_key = destroy_key;
+	return old;
+}
+
+DestroyFunc map_set_destroy_value(Map map, DestroyFunc destroy_value) {
+	DestroyFunc old = map->destroy_value;
+	map->destroy_value = destroy_value;
+	return old;
+}
+
+// Απελευθέρωση μνήμης που δεσμεύει το map
+void map_destroy(Map map) {
+	if (map->destroy_key != NULL || map->destroy_value != NULL) {
+		for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node)) {
+			if (map->destroy_key != NULL)
+				map->destroy_key(node->key);
+			if (map->destroy_value != NULL)
+				map->destroy_value(node->value);
+		}
+	}
+
+	free(map->indices);
+	free(map->entries);
+	free(map);
+}
+
+/////////////////////// Διάσχιση του map μέσω κόμβων ///////////////////////////
+//
+// Τα entries διασχίζονται με τη σειρά του πίνακα, δηλαδή με τη σειρά εισαγωγής, χωρίς να διαβάσουμε το hash table.
+
+// Επιστρέφει το πρώτο (μη διαγραμμένο) entry με θέση >= pos
+static MapNode first_from(Map map, size_t pos) {
+	for (; pos < map->used; pos++)
+		if (map->entries[pos].key != DELETED_KEY)
+			return &map->entries[pos];
+
+	return MAP_EOF;
+}
+
+MapNode map_first(Map map) {
+	return first_from(map, 0);
+}
+
+MapNode map_next(Map map, MapNode node) {
+	// Το node είναι pointer στο i-οστό στοιχείο του entries, οπότε node - entries == i  (pointer arithmetic!)
+	return first_from(map, node - map->entries + 1);
+}
+
+Pointer map_node_key(Map map, MapNode node) {
+	return node->key;
+}
+
+Pointer map_node_value(Map map, MapNode node) {
+	return node->value;
+}
+
+MapNode map_find_node(Map map, Pointer key) {
+	ptrdiff_t slot = find_slot(map, key, hash_of(map, key));
+	return slot != -1 ? &map->entries[get_index(map, slot)] : MAP_EOF;
+}
+
+MapNode map_find_or_insert(Map map, Pointer key, bool* inserted) {
+	bool was_inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash_of(map, key), &was_inserted);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+MapNode map_find_or_insert_with(Map map, Pointer key, CreateValueFunc create_value, bool* inserted) {
+	bool was_inserted;
+	MapNode node = map_find_or_insert(map, key, &was_inserted);
+	if (was_inserted)
+		node->value = create_value(key);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	node->value = value;
+}
+
+// Αρχικοποίηση της συνάρτησης κατακερματισμού του συγκεκριμένου map.
+void map_set_hash_function(Map map, HashFunc func) {
+	map->hash_function = func;
+	map->hash_function64 = NULL;
+}
+
+void map_set_hash_function64(Map map, HashFunc64 func) {
+	map->hash_function64 = func;
+}
+
+// Οι χωρητικότητες του πίνακα indices είναι πάντα δυνάμεις του 2 (με Fibonacci hashing), οπότε η πολιτική δεν αλλάζει κάτι
+void map_set_capacity_policy(Map map, MapCapacityPolicy policy) {
+}
+
+// Τα indices χρησιμοποιούν probing χωρίς γειτονιά σταθερού μεγέθους, οπότε η map_set_neighbourhood δεν αλλάζει κάτι
+void map_set_neighbourhood(Map map, int neighbourhood) {
+}
+
+#include "../ADTMapHash.h"
+
+
+/////////////////////// Στατιστικά ///////////////////////////
+
+void map_stats(Map map, MapStats* stats) {
+	*stats = (MapStats){
+		.size = map->size,
+		.capacity = map->capacity,
+		.load_factor = (double)map->size / map->capacity,
+		.rehashes = map->rehashes,
+		.bytes = sizeof(*map) + map->capacity * map->width + usable(map->capacity) * sizeof(struct map_node),
+	};
+
+	for (size_t pos = 0; pos < map->capacity; pos++)
+		if (get_index(map, pos) == DELETED_INDEX)
+			stats->tombstones++;
+
+	// Το probe length κάθε στοιχείου είναι πόσες θέσεις εξετάζει η find_slot πριν φτάσει στη θέση του
+	for (size_t i = 0; i < map->used; i++) {
+		if (map->entries[i].key == DELETED_KEY)
+			continue;
+
+		Probe probe = probe_start(map, map->entries[i].hash);
+		size_t steps = 0;
+		for (; get_index(map, probe.pos) != (int64_t)i; steps++)
+			probe_next(map, &probe);
+
+		stats->probe_lengths[steps < MAP_STATS_HISTOGRAM ? steps : MAP_STATS_HISTOGRAM - 1]++;
+	}
+}
@@ -5,6 +5,8 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "ADTMap.h"
 
@@ -18,34 +20,92 @@ typedef enum {
 
 // Το μέγεθος του Hash Table ιδανικά θέλουμε να είναι πρώτος αριθμός σύμφωνα με την θεωρία.
 // Η παρακάτω λίστα περιέχει πρώτους οι οποίοι έχουν αποδεδιγμένα καλή συμπεριφορά ως μεγέθη.
-// Κάθε re-hash θα γίνεται βάσει αυτής της λίστας. Αν χρειάζονται παραπάνω απο 1610612741 στοχεία, τότε σε καθε rehash διπλασιάζουμε το μέγεθος.
-int prime_sizes[] = {53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
-	786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741};
+// Κάθε re-hash θα γίνεται βάσει αυτής της λίστας. Αν χρειάζονται παραπάνω απο 824633720837 στοχεία, τότε σε καθε rehash διπλασιάζουμε το μέγεθος.
+// (Κάθε πρώτος είναι ο μικρότερος μετά το 1.5 * 2^k, οπότε οι τιμές μετά το 1610612741 συνεχίζουν με τον ίδιο κανόνα.)
+size_t prime_sizes[] = {53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
+	786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741,
+	3221225473, 6442450967, 12884901893, 25769803799, 51539607599, 103079215111, 206158430209, 412316860441, 824633720837};
+
+// Με MAP_CAPACITY_POW2 η χωρητικότητα ξεκινάει από POW2_MIN_CAPACITY και διπλασιάζεται σε κάθε rehash
+#define POW2_MIN_CAPACITY 64
 
 // Χρησιμοποιούμε open addressing, οπότε σύμφωνα με την θεωρία, πρέπει πάντα να διατηρούμε
 // τον load factor του  hash table μικρότερο ή ίσο του 0.5, για να έχουμε αποδoτικές πράξεις
 #define MAX_LOAD_FACTOR 0.5
 
+// Κάτω από αυτόν τον load factor η map_remove μικραίνει τον πίνακα (βλέπε map_compact στο ADTMap.h). Εδώ μετράνε
+// μόνο τα στοιχεία και όχι οι DELETED θέσεις, τις οποίες έτσι κι αλλιώς αφαιρεί το rehash.
+#define MIN_LOAD_FACTOR 0.125
+
+// Το rehash δε μεταφέρει όλα τα στοιχεία με τη μία, κάτι που σε μεγάλους πίνακες θα καθυστερούσε πολύ
+// τη μία map_insert που το προκαλεί. Ο παλιός πίνακας κρατιέται δίπλα στον νέο, κάθε map_insert / map_remove
+// μεταφέρει REHASH_STEP θέσεις του στον νέο, και μέχρι να ολοκληρωθεί η μεταφορά οι αναζητήσεις ελέγχουν
+// και τους δύο πίνακες. Με make CFLAGS=-DREHASH_STEP=0 όλες οι θέσεις μεταφέρονται αμέσως κατά το rehash.
+#ifndef REHASH_STEP
+#define REHASH_STEP 64
+#endif
+
 // Δομή του κάθε κόμβου που έχει το hash table (με το οποίο υλοιποιούμε το map)
 struct map_node{
 	Pointer key;		// Το κλειδί που χρησιμοποιείται για να hash-αρουμε
 	Pointer value;  	// Η τιμή που αντισοιχίζεται στο παραπάνω κλειδί
 	State state;		// Μεταβλητή για να μαρκάρουμε την κατάσταση των κόμβων (βλέπε διαγραφή)
+	uint64_t hash;		// Το hash code του key, υπολογίζεται μία φορά κατά την εισαγωγή
 };
 
 // Δομή του Map (περιέχει όλες τις πληροφορίες που χρεαζόμαστε για το HashTable)
 struct map {
 	MapNode array;				// Ο πίνακας που θα χρησιμοποιήσουμε για το map (remember, φτιάχνουμε ένα hash table)
-	int capacity;				// Πόσο χώρο έχουμε δεσμεύσει.
-	int size;					// Πόσα στοιχεία έχουμε προσθέσει
-	int deleted;				// Πόσα κελιά είναι DELETED
+	size_t capacity;			// Πόσο χώρο έχουμε δεσμεύσει.
+	size_t size;				// Πόσα στοιχεία έχουμε προσθέσει
+	size_t reserved;			// Ο χώρος (σε στοιχεία) της map_reserve, κάτω από τον οποίο ο πίνακας δε μικραίνει
+	size_t deleted;				// Πόσα κελιά είναι DELETED
+	uint64_t* occupied;			// Bitmap με τις OCCUPIED θέσεις του array (βλέπε bitmap_next)
+	MapNode old_array;			// Ο παλιός πίνακας όσο διαρκεί ένα rehash, διαφορετικά NULL
+	uint64_t* old_occupied;		// και το bitmap του
+	size_t old_capacity;
+	size_t migrated;				// Πόσες θέσεις του old_array έχουν ήδη μεταφερθεί στο array
+	int rehashes;				// Πόσα rehash έχουν γίνει (για τη map_stats)
+	MapCapacityPolicy capacity_policy;	// Πρώτοι αριθμοί ή δυνάμεις του 2 ως χωρητικότητες
 	CompareFunc compare;		// Συνάρτηση για σύγκριση δεικτών, που πρέπει να δίνεται απο τον χρήστη
 	HashFunc hash_function;		// Συνάρτηση για να παίρνουμε το hash code του κάθε αντικειμένου.
+	HashFunc64 hash_function64;	// Η συνάρτηση 64 bits, αν έχει οριστεί (διαφορετικά NULL και χρησιμοποιείται η hash_function)
 	DestroyFunc destroy_key;	// Συναρτήσεις που καλούνται όταν διαγράφουμε έναν κόμβο απο το map.
 	DestroyFunc destroy_value;
 };
 
 
+// Bitmap με ένα bit για κάθε θέση ενός πίνακα (το bit pos % 64 της λέξης pos / 64), που είναι 1 για τις
+// OCCUPIED θέσεις. Η διάσχιση και η map_destroy διαβάζουν 64 θέσεις με κάθε λέξη του bitmap, αντί για
+// τους ίδιους τους κόμβους, οπότε σε αραιούς πίνακες το κόστος τους εξαρτάται από τα στοιχεία και όχι τη χωρητικότητα.
+static uint64_t* bitmap_create(size_t capacity) {
+	return calloc((capacity + 63) / 64, sizeof(uint64_t));
+}
+
+static inline void bitmap_set(uint64_t* bitmap, size_t pos) {
+	bitmap[pos / 64] |= 1ull << (pos % 64);
+}
+
+static inline void bitmap_clear(uint64_t* bitmap, size_t pos) {
+	bitmap[pos / 64] &= ~(1ull << (pos % 64));
+}
+
+// Η πρώτη θέση >= start με bit 1 στο bitmap ενός πίνακα capacity θέσεων, ή capacity αν δεν υπάρχει
+static size_t bitmap_next(const uint64_t* bitmap, size_t capacity, size_t start) {
+	if (start >= capacity)
+		return capacity;
+
+	size_t word = start / 64, words = (capacity + 63) / 64;
+	uint64_t bits = bitmap[word] & (~0ull << (start % 64));		// αγνοούμε τις θέσεις πριν από την start
+	while (bits == 0) {
+		if (++word == words)
+			return capacity;
+		bits = bitmap[word];
+	}
+	return word * 64 + __builtin_ctzll(bits);
+}
+
+
 Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value) {
 	// Δεσμεύουμε κατάλληλα τον χώρο που χρειαζόμαστε για το hash table
 	Map map = malloc(sizeof(*map));
@@ -53,68 +113,257 @@ Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy
 	map->array = malloc(map->capacity * sizeof(struct map_node));
 
 	// Αρχικοποιούμε τους κόμβους που έχουμε σαν διαθέσιμους.
-	for (int i = 0; i < map->capacity; i++)
+	for (size_t i = 0; i < map->capacity; i++)
 		map->array[i].state = EMPTY;
 
+	map->occupied = bitmap_create(map->capacity);
 	map->size = 0;
 	map->deleted = 0;
+	map->old_array = NULL;
+	map->old_occupied = NULL;
+	map->old_capacity = 0;
+	map->migrated = 0;
+	map->reserved = 0;
+	map->rehashes = 0;
+	map->capacity_policy = MAP_CAPACITY_PRIME;
 	map->compare = compare;
+	map->hash_function = NULL;
+	map->hash_function64 = NULL;
 	map->destroy_key = destroy_key;
 	map->destroy_value = destroy_value;
 
 	return map;
 }
 
+Map map_create_sized(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value, size_t expected) {
+	Map map = map_create(compare, destroy_key, destroy_value);
+	map_reserve(map, expected);
+	return map;
+}
+
 // Επιστρέφει τον αριθμό των entries του map σε μία χρονική στιγμή.
 int map_size(Map map) {
 	return map->size;
 }
 
-// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ.
-static void rehash(Map map) {
-	// Αποθήκευση των παλιών δεδομένων
-	int old_capacity = map->capacity;
-	MapNode old_array = map->array;
-
-	// Βρίσκουμε τη νέα χωρητικότητα, διασχίζοντας τη λίστα των πρώτων ώστε να βρούμε τον επόμενο. 
-	int prime_no = sizeof(prime_sizes) / sizeof(int);	// το μέγεθος του πίνακα
-	for (int i = 0; i < prime_no; i++) {					// LCOV_EXCL_LINE
-		if (prime_sizes[i] > old_capacity) {
-			map->capacity = prime_sizes[i]; 
+size_t map_size64(Map map) {
+	return map->size;
+}
+
+// Το hash code του key, από όποια από τις δύο συναρτήσεις κατακερματισμού έχει οριστεί
+static inline uint64_t hash_of(Map map, Pointer key) {
+	return map->hash_function64 != NULL ? map->hash_function64(key) : map->hash_function(key);
+}
+
+// Η θέση που κάνει hash ένα key σε πίνακα capacity θέσεων. Οι χωρητικότητες της MAP_CAPACITY_POW2 είναι οι
+// μόνες δυνάμεις του 2, και για αυτές παίρνουμε τα υψηλότερα bits του hash * 2^64/φ (Fibonacci hashing).
+// Διαφορετικά, η διαίρεση των 64 bits είναι αρκετά πιο αργή από αυτή των 32 bits, οπότε για πίνακες κάτω
+// από 2^32 θέσεις "διπλώνουμε" πρώτα το hash code σε 32 bits (τα hash codes των 32 bits δεν αλλάζουν).
+static inline size_t home_pos(uint64_t hash, size_t capacity) {
+	if ((capacity & (capacity - 1)) == 0)
+		return (hash * 0x9E3779B97F4A7C15ull) >> (64 - __builtin_ctzll(capacity));
+	if (capacity <= UINT32_MAX)
+		return (uint32_t)(hash ^ hash >> 32) % (uint32_t)capacity;
+	return hash % capacity;
+}
+
+// Για pos < 2 * capacity, η θέση pos "γυρνώντας" στην αρχή του πίνακα (χωρίς διαίρεση)
+static inline size_t wrap(size_t pos, size_t capacity) {
+	return pos < capacity ? pos : pos - capacity;
+}
+
+// Αναζήτηση του key (με hash code hash) σε έναν από τους δύο πίνακες (array ή old_array)
+static MapNode find_in(Map map, MapNode array, size_t capacity, Pointer key, uint64_t hash) {
+	// Διασχίζουμε τον πίνακα, ξεκινώντας από τη θέση που κάνει hash το key, και για όσο δε βρίσκουμε EMPTY
+	size_t count = 0;
+	for (size_t pos = home_pos(hash, capacity);				// ξεκινώντας από τη θέση που κάνει hash το key
+		array[pos].state != EMPTY;							// αν φτάσουμε σε EMPTY σταματάμε
+		pos = wrap(pos + 1, capacity)) {					// linear probing, γυρνώντας στην αρχή όταν φτάσουμε στη τέλος του πίνακα
+
+		// Μόνο σε OCCUPIED θέσεις (όχι DELETED), ελέγχουμε αν το key είναι εδώ. Κλειδιά με διαφορετικό
+		// hash code σίγουρα διαφέρουν, οπότε η compare καλείται μόνο όταν τα hash codes ταυτίζονται.
+		if (array[pos].state == OCCUPIED && array[pos].hash == hash && map->compare(array[pos].key, key) == 0)
+			return &array[pos];
+
+		// Αν διασχίσουμε ολόκληρο τον πίνακα σταματάμε. Εφόσον ο πίνακας δεν μπορεί να είναι όλος OCCUPIED,
+		// αυτό μπορεί να συμβεί μόνο στην ακραία περίπτωση που ο πίνακας έχει γεμίσει DELETED τιμές!
+		count++;
+		if (count == capacity)
 			break;
+	}
+
+	return MAP_EOF;
+}
+
+// Τοποθετεί στο array ένα key που σίγουρα δεν υπάρχει στο map, στην πρώτη θέση που δεν είναι OCCUPIED
+static void place(Map map, Pointer key, Pointer value, uint64_t hash) {
+	size_t pos = home_pos(hash, map->capacity);
+	while (map->array[pos].state == OCCUPIED)
+		pos = wrap(pos + 1, map->capacity);
+
+	if (map->array[pos].state == DELETED)
+		map->deleted--;
+
+	map->array[pos].state = OCCUPIED;
+	map->array[pos].key = key;
+	map->array[pos].value = value;
+	map->array[pos].hash = hash;
+	bitmap_set(map->occupied, pos);
+}
+
+// Μεταφέρει έως count θέσεις του old_array στο array (αν υπάρχει rehash σε εξέλιξη)
+static void migrate(Map map, size_t count) {
+	if (map->old_array == NULL)
+		return;
+
+	for (; count > 0 && map->migrated < map->old_capacity; count--, map->migrated++) {
+		MapNode node = &map->old_array[map->migrated];
+		if (node->state == OCCUPIED) {
+			place(map, node->key, node->value, node->hash);		// χωρίς να ξανακαλέσουμε την hash_function
+			node->state = DELETED;		// όχι EMPTY, ώστε να μη διακόπτονται οι αναζητήσεις στο old_array
+			bitmap_clear(map->old_occupied, map->migrated);
 		}
 	}
+
+	// Ολοκληρώθηκε η μεταφορά, αποδεσμεύουμε τον παλιό πίνακα ώστε να μήν έχουμε leaks
+	if (map->migrated == map->old_capacity) {
+		free(map->old_array);
+		free(map->old_occupied);
+		map->old_array = NULL;
+		map->old_occupied = NULL;
+	}
+}
+
+// Η χωρητικότητα που ακολουθεί την capacity: ο επόμενος πρώτος της λίστας, ή το διπλάσιο για τη MAP_CAPACITY_POW2
+static size_t next_capacity(Map map, size_t capacity) {
+	if (map->capacity_policy == MAP_CAPACITY_POW2)
+		return capacity * 2;
+
+	// Διασχίζουμε τη λίστα των πρώτων ώστε να βρούμε τον επόμενο.
+	size_t prime_no = sizeof(prime_sizes) / sizeof(prime_sizes[0]);	// το μέγεθος του πίνακα
+	for (size_t i = 0; i < prime_no; i++)					// LCOV_EXCL_LINE
+		if (prime_sizes[i] > capacity)
+			return prime_sizes[i];
+
 	// Αν έχουμε εξαντλήσει όλους τους πρώτους, διπλασιάζουμε
-	if (map->capacity == old_capacity)					// LCOV_EXCL_LINE
-		map->capacity *= 2;								// LCOV_EXCL_LINE
+	return capacity * 2;								// LCOV_EXCL_LINE
+}
 
-	// Δημιουργούμε ένα μεγαλύτερο hash table
-	map->array = malloc(map->capacity * sizeof(struct map_node));
-	for (int i = 0; i < map->capacity; i++)
-		map->array[i].state = EMPTY;
+// Η μικρότερη χωρητικότητα (της πολιτικής του map) στην οποία χωράνε n στοιχεία χωρίς rehash
+static size_t capacity_for(Map map, size_t n) {
+	size_t capacity = map->capacity_policy == MAP_CAPACITY_POW2 ? POW2_MIN_CAPACITY : prime_sizes[0];
+	while ((float)n / capacity > MAX_LOAD_FACTOR)
+		capacity = next_capacity(map, capacity);
+	return capacity;
+}
 
-	// Τοποθετούμε ΜΟΝΟ τα entries που όντως περιέχουν ένα στοιχείο (το rehash είναι και μία ευκαιρία να ξεφορτωθούμε τα deleted nodes)
-	map->size = 0;
-	for (int i = 0; i < old_capacity; i++)
-		if (old_array[i].state == OCCUPIED)
-			map_insert(map, old_array[i].key, old_array[i].value);
+// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ.
+// Δημιουργεί τον νέο πίνακα new_capacity θέσεων, και η μεταφορά των στοιχείων γίνεται σταδιακά από τη migrate.
+static void rehash(Map map, size_t new_capacity) {
+	// Αν δεν έχει ολοκληρωθεί το προηγούμενο rehash, μεταφέρουμε πρώτα ό,τι έχει απομείνει
+	migrate(map, map->old_capacity);
+
+	// Ο τρέχων πίνακας γίνεται ο παλιός
+	map->old_array = map->array;
+	map->old_occupied = map->occupied;
+	map->old_capacity = map->capacity;
+	map->migrated = 0;
+	map->rehashes++;
+
+	map->capacity = new_capacity;
+
+	// Δημιουργούμε ένα μεγαλύτερο hash table. Σε αυτό μεταφέρονται ΜΟΝΟ τα entries που όντως
+	// περιέχουν ένα στοιχείο (το rehash είναι και μία ευκαιρία να ξεφορτωθούμε τα deleted nodes)
+	// Το calloc δίνει απευθείας κόμβους με state == EMPTY (0), χωρίς να διατρέχουμε όλο τον πίνακα
+	// μέσα στο ίδιο το rehash (το λειτουργικό μηδενίζει τις σελίδες όταν τις χρησιμοποιήσουμε)
+	map->array = calloc(map->capacity, sizeof(struct map_node));
+	map->occupied = bitmap_create(map->capacity);
+	map->deleted = 0;
 
-	//Αποδεσμεύουμε τον παλιό πίνακα ώστε να μήν έχουμε leaks
-	free(old_array);
+	migrate(map, REHASH_STEP > 0 ? REHASH_STEP : map->old_capacity);
 }
 
-// Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει,
-// ανανέωση του με ένα νέο value, και η συνάρτηση επιστρέφει true.
+// Μεγαλώνει τον πίνακα (αν χρειάζεται) ώστε να χωράει n στοιχεία
+static void reserve(Map map, size_t n) {
+	size_t capacity = capacity_for(map, n);
+	if (capacity <= map->capacity)
+		return;
+
+	// Μεταφέρουμε αμέσως όλα τα στοιχεία, ώστε οι επόμενες εισαγωγές να μην πληρώνουν τη μεταφορά
+	rehash(map, capacity);
+	migrate(map, map->old_capacity);
+}
+
+// Ο χώρος της map_reserve διατηρείται και όταν ο πίνακας μικραίνει (βλέπε shrink)
+void map_reserve(Map map, size_t n) {
+	if (n > map->reserved)
+		map->reserved = n;
+	reserve(map, n);
+}
+
+// Μικραίνει τον πίνακα αν ο load factor έπεσε κάτω από MIN_LOAD_FACTOR. Όπως και στη μεγέθυνση,
+// τα στοιχεία μεταφέρονται σταδιακά στον νέο πίνακα από τη migrate.
+static void shrink(Map map) {
+	if (map->size >= map->capacity * MIN_LOAD_FACTOR)
+		return;
+
+	size_t n = 2 * map->size > map->reserved ? 2 * map->size : map->reserved;
+	size_t capacity = capacity_for(map, n);
+	if (capacity < map->capacity)
+		rehash(map, capacity);
+}
+
+void map_compact(Map map) {
+	// Ο νέος πίνακας (χωρίς DELETED θέσεις) δημιουργείται ακόμα και αν η χωρητικότητα δεν αλλάζει,
+	// και τα στοιχεία μεταφέρονται αμέσως
+	map->reserved = 0;
+	rehash(map, capacity_for(map, map->size));
+	migrate(map, map->old_capacity);
+}
+
+// Αντικατάσταση των key/value ενός κόμβου που υπάρχει ήδη, κάνοντας destroy τα παλιά
+static void replace(Map map, MapNode node, Pointer key, Pointer value) {
+	if (node->key != key && map->destroy_key != NULL)
+		map->destroy_key(node->key);
+
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+
+	node->key = key;
+	node->value = value;
+}
+
+// Αναζήτηση του key σε όποιον πίνακα βρίσκεται
+static MapNode find_node(Map map, Pointer key, uint64_t hash) {
+	MapNode node = find_in(map, map->array, map->capacity, key, hash);
+
+	// Όσο διαρκεί ένα rehash, το key μπορεί να μην έχει μεταφερθεί ακόμα
+	if (node == MAP_EOF && map->old_array != NULL)
+		node = find_in(map, map->old_array, map->old_capacity, key, hash);
+
+	return node;
+}
+
+// Η map_find_or_insert για key με ήδη υπολογισμένο hash code: επιστρέφει τον κόμβο του key, ή αν δεν
+// υπάρχει το τοποθετεί με τιμή NULL. Η αναζήτηση και η εισαγωγή γίνονται με την ίδια διάσχιση του πίνακα.
+static MapNode find_or_insert_hashed(Map map, Pointer key, uint64_t hash, bool* inserted) {
+	*inserted = false;
+
+	// Αν το key βρίσκεται ακόμα στον παλιό πίνακα, το αφήνουμε εκεί (θα μεταφερθεί αργότερα)
+	if (map->old_array != NULL) {
+		MapNode old_node = find_in(map, map->old_array, map->old_capacity, key, hash);
+		if (old_node != MAP_EOF)
+			return old_node;
+	}
 
-void map_insert(Map map, Pointer key, Pointer value) {
 	// Σκανάρουμε το Hash Table μέχρι να βρούμε διαθέσιμη θέση για να τοποθετήσουμε το ζευγάρι,
 	// ή μέχρι να βρούμε το κλειδί ώστε να το αντικαταστήσουμε.
 	bool already_in_map = false;
 	MapNode node = NULL;
-	uint pos;
-	for (pos = map->hash_function(key) % map->capacity;		// ξεκινώντας από τη θέση που κάνει hash το key
+	size_t pos;
+	for (pos = home_pos(hash, map->capacity);				// ξεκινώντας από τη θέση που κάνει hash το key
 		map->array[pos].state != EMPTY;						// αν φτάσουμε σε EMPTY σταματάμε
-		pos = (pos + 1) % map->capacity) {					// linear probing, γυρνώντας στην αρχή όταν φτάσουμε στη τέλος του πίνακα
+		pos = wrap(pos + 1, map->capacity)) {				// linear probing, γυρνώντας στην αρχή όταν φτάσουμε στη τέλος του πίνακα
 
 		if (map->array[pos].state == DELETED) {
 			// Βρήκαμε DELETED θέση. Θα μπορούσαμε να βάλουμε το ζευγάρι εδώ, αλλά _μόνο_ αν το key δεν υπάρχει ήδη.
@@ -122,7 +371,7 @@ void map_insert(Map map, Pointer key, Pointer value) {
 			if (node == NULL)
 				node = &map->array[pos];
 
-		} else if (map->compare(map->array[pos].key, key) == 0) {
+		} else if (map->array[pos].hash == hash && map->compare(map->array[pos].key, key) == 0) {
 			already_in_map = true;
 			node = &map->array[pos];						// βρήκαμε το key, το ζευγάρι θα μπει αναγκαστικά εδώ (ακόμα και αν είχαμε προηγουμένως βρει DELETED θέση)
 			break;											// και δε χρειάζεται να συνεχίζουμε την αναζήτηση.
@@ -132,36 +381,93 @@ void map_insert(Map map, Pointer key, Pointer value) {
 		node = &map->array[pos];
 
 	// Σε αυτό το σημείο, το node είναι ο κόμβος στον οποίο θα γίνει εισαγωγή.
-	if (already_in_map) {
-		// Αν αντικαθιστούμε παλιά key/value, τa κάνουμε destropy
-		if (node->key != key && map->destroy_key != NULL)
-			map->destroy_key(node->key);
+	if (already_in_map)
+		return node;
 
-		if (node->value != value && map->destroy_value != NULL)
-			map->destroy_value(node->value);
-
-	} else {
-		// Νέο στοιχείο, αυξάνουμε τα συνολικά στοιχεία του map
-		map->size++;
+	// Νέο στοιχείο, αυξάνουμε τα συνολικά στοιχεία του map
+	*inserted = true;
+	map->size++;
 
-		if (node->state == DELETED)							// αν βρήκαμε DELETED, θα αλλάξει σε OCCUPIED
-			map->deleted--;
-	}
+	if (node->state == DELETED)							// αν βρήκαμε DELETED, θα αλλάξει σε OCCUPIED
+		map->deleted--;
 
 	// Προσθήκη τιμών στον κόμβο
 	node->state = OCCUPIED;
 	node->key = key;
-	node->value = value;
+	node->value = NULL;
+	node->hash = hash;
+	bitmap_set(map->occupied, node - map->array);
 
 	// Αν με την νέα εισαγωγή ξεπερνάμε το μέγιστο load factor, πρέπει να κάνουμε rehash.
 	// Στο load factor μετράμε και τα DELETED, γιατί και αυτά επηρρεάζουν τις αναζητήσεις.
+	// Το rehash μπορεί να μεταφέρει τον κόμβο, οπότε τον ξαναβρίσκουμε.
 	float load_factor = (float)(map->size + map->deleted) / map->capacity;
-	if (load_factor > MAX_LOAD_FACTOR)
-		rehash(map);
+	if (load_factor > MAX_LOAD_FACTOR) {
+		rehash(map, next_capacity(map, map->capacity));
+		node = find_node(map, key, hash);
+	}
+	return node;
+}
+
+// Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει, ανανέωση του με ένα νέο value.
+// Η map_insert για key με ήδη υπολογισμένο hash code
+static void insert_hashed(Map map, Pointer key, Pointer value, uint64_t hash) {
+	bool inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash, &inserted);
+	if (inserted)
+		node->value = value;
+	else
+		replace(map, node, key, value);		// Αν αντικαθιστούμε παλιά key/value, τa κάνουμε destroy
+}
+
+void map_insert(Map map, Pointer key, Pointer value) {
+	// Κάθε εισαγωγή προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
+
+	// Το hash code του key υπολογίζεται μόνο εδώ, στη συνέχεια αποθηκεύεται στον κόμβο
+	insert_hashed(map, key, value, hash_of(map, key));
+}
+
+// Η map_insert_batch υπολογίζει τα hash codes σε ομάδες των BATCH_SIZE keys, και φορτώνει στην cache
+// τη θέση κάθε key PREFETCH_DISTANCE εισαγωγές πριν από αυτή, ώστε οι αναμονές για τη μνήμη να επικαλύπτονται.
+#define BATCH_SIZE 64
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 8
+#endif
+
+// Φορτώνει στην cache (χωρίς να περιμένει) τον κόμβο από τον οποίο ξεκινάει η αναζήτηση του hash
+static inline void prefetch(Map map, uint64_t hash) {
+	__builtin_prefetch(&map->array[home_pos(hash, map->capacity)], 1);
+}
+
+void map_insert_batch(Map map, Pointer* keys, Pointer* values, size_t n) {
+	// Δεσμεύουμε μία φορά χώρο για όλα τα στοιχεία (αν κάποια keys υπάρχουν ήδη, απλά περισσεύει χώρος)
+	reserve(map, map->size + n);
+
+	uint64_t hashes[BATCH_SIZE];
+	for (size_t start = 0; start < n; start += BATCH_SIZE) {
+		size_t count = n - start < BATCH_SIZE ? n - start : BATCH_SIZE;
+		for (size_t i = 0; i < count; i++) {
+			hashes[i] = hash_of(map, keys[start + i]);
+			if (i < PREFETCH_DISTANCE)
+				prefetch(map, hashes[i]);
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			if (i + PREFETCH_DISTANCE < count)
+				prefetch(map, hashes[i + PREFETCH_DISTANCE]);
+
+			migrate(map, REHASH_STEP);
+			insert_hashed(map, keys[start + i], values != NULL ? values[start + i] : NULL, hashes[i]);
+		}
+	}
 }
 
 // Διαργραφή απο το Hash Table του κλειδιού με τιμή key
 bool map_remove(Map map, Pointer key) {
+	// Κάθε διαγραφή προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
+
 	MapNode node = map_find_node(map, key);
 	if (node == MAP_EOF)
 		return false;
@@ -173,9 +479,16 @@ bool map_remove(Map map, Pointer key) {
 		map->destroy_value(node->value);
 
 	// θέτουμε ως "deleted", ώστε να μην διακόπτεται η αναζήτηση, αλλά ταυτόχρονα να γίνεται ομαλά η εισαγωγή
+	// (τα DELETED του old_array δεν μετράνε, ο load factor αφορά μόνο το array)
 	node->state = DELETED;
-	map->deleted++;
+	if (node >= map->array && node < map->array + map->capacity) {
+		map->deleted++;
+		bitmap_clear(map->occupied, node - map->array);
+	} else {
+		bitmap_clear(map->old_occupied, node - map->old_array);
+	}
 	map->size--;
+	shrink(map);
 
 	return true;
 }
@@ -189,6 +502,56 @@ Pointer map_find(Map map, Pointer key) {
 		return NULL;
 }
 
+// Στη map_find_batch (βλέπε ADTMap.h) ένα βήμα ελέγχει τις θέσεις ενός cache line του array. Όσο διαρκεί
+// ένα rehash, το τελευταίο βήμα μιας αναζήτησης που δε βρήκε το key ελέγχει και το old_array.
+
+// Η κατάσταση μιας αναζήτησης της map_find_batch
+typedef struct {
+	size_t index;		// Η θέση του key στον πίνακα keys
+	uint64_t hash;
+	bool hashed;		// Έχει υπολογιστεί το hash code (στο πρώτο βήμα, αφού γίνει prefetch στο key)
+	size_t pos;			// Η θέση του array που ελέγχεται στο επόμενο βήμα (έχει ήδη γίνει prefetch)
+	size_t count;		// Πόσες θέσεις έχουν ελεγχθεί
+} Lookup;
+
+// Υπολογίζει το hash code του key της l και κάνει prefetch στη θέση του
+static void lookup_hash(Map map, Lookup* l, Pointer key) {
+	l->hash = hash_of(map, key);
+	l->pos = home_pos(l->hash, map->capacity);
+	l->count = 0;
+	__builtin_prefetch(&map->array[l->pos]);
+}
+
+#include "../ADTMapFindBatch.h"
+
+// Ένα βήμα της αναζήτησης l: ελέγχει τις θέσεις του cache line στο οποίο βρίσκεται, επιστρέφει true αν ολοκληρώθηκε
+static bool lookup_step(Map map, Lookup* l, Pointer* keys, Pointer* out_values) {
+	for (;;) {
+		MapNode node = &map->array[l->pos];
+		if (node->state == EMPTY)
+			break;
+
+		if (node->state == OCCUPIED && node->hash == l->hash && map->compare(node->key, keys[l->index]) == 0)
+			return lookup_finish(l, out_values, node);
+
+		if (++l->count == map->capacity)
+			break;
+
+		// Όσο η επόμενη θέση είναι στο ίδιο cache line συνεχίζουμε, διαφορετικά περιμένουμε τον επόμενο γύρο
+		l->pos = wrap(l->pos + 1, map->capacity);
+		if ((uintptr_t)&map->array[l->pos] / 64 != (uintptr_t)node / 64) {
+			__builtin_prefetch(&map->array[l->pos]);
+			return false;
+		}
+	}
+
+	// Δε βρέθηκε στο array. Όσο διαρκεί ένα rehash, το key μπορεί να μην έχει μεταφερθεί ακόμα.
+	MapNode node = MAP_EOF;
+	if (map->old_array != NULL)
+		node = find_in(map, map->old_array, map->old_capacity, keys[l->index], l->hash);
+	return lookup_finish(l, out_values, node);
+}
+
 
 DestroyFunc map_set_destroy_key(Map map, DestroyFunc destroy_key) {
 	DestroyFunc old = map->destroy_key;
@@ -204,37 +567,51 @@ DestroyFunc map_set_destroy_value(Map map, DestroyFunc destroy_value) {
 
 // Απελευθέρωση μνήμης που δεσμεύει το map
 void map_destroy(Map map) {
-	for (int i = 0; i < map->capacity; i++) {
-		if (map->array[i].state == OCCUPIED) {
+	if (map->destroy_key != NULL || map->destroy_value != NULL) {
+		for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node)) {
 			if (map->destroy_key != NULL)
-				map->destroy_key(map->array[i].key);
+				map->destroy_key(node->key);
 			if (map->destroy_value != NULL)
-				map->destroy_value(map->array[i].value);
+				map->destroy_value(node->value);
 		}
 	}
 
+	free(map->old_array);
+	free(map->old_occupied);
 	free(map->array);
+	free(map->occupied);
 	free(map);
 }
 
 /////////////////////// Διάσχιση του map μέσω κόμβων ///////////////////////////
 
+// Όσο διαρκεί ένα rehash, διασχίζουμε πρώτα το array και μετά ό,τι έχει μείνει στο old_array.
+
+// Επιστρέφει τον πρώτο OCCUPIED κόμβο του πίνακα array (με bitmap occupied) με θέση >= start, ή MAP_EOF
+static MapNode first_occupied(MapNode array, const uint64_t* occupied, size_t capacity, size_t start) {
+	size_t pos = bitmap_next(occupied, capacity, start);
+	return pos < capacity ? &array[pos] : MAP_EOF;
+}
+
 MapNode map_first(Map map) {
 	//Ξεκινάμε την επανάληψή μας απο το 1ο στοιχείο, μέχρι να βρούμε κάτι όντως τοποθετημένο
-	for (int i = 0; i < map->capacity; i++)
-		if (map->array[i].state == OCCUPIED)
-			return &map->array[i];
-
-	return MAP_EOF;
+	MapNode node = first_occupied(map->array, map->occupied, map->capacity, 0);
+	if (node == MAP_EOF && map->old_array != NULL)
+		node = first_occupied(map->old_array, map->old_occupied, map->old_capacity, 0);
+	return node;
 }
 
 MapNode map_next(Map map, MapNode node) {
 	// Το node είναι pointer στο i-οστό στοιχείο του array, οπότε node - array == i  (pointer arithmetic!)
-	for (int i = node - map->array + 1; i < map->capacity; i++)
-		if (map->array[i].state == OCCUPIED)
-			return &map->array[i];
+	if (node >= map->array && node < map->array + map->capacity) {
+		MapNode next = first_occupied(map->array, map->occupied, map->capacity, node - map->array + 1);
+		if (next == MAP_EOF && map->old_array != NULL)
+			next = first_occupied(map->old_array, map->old_occupied, map->old_capacity, 0);
+		return next;
+	}
 
-	return MAP_EOF;
+	// Διαφορετικά το node ανήκει στο old_array
+	return first_occupied(map->old_array, map->old_occupied, map->old_capacity, node - map->old_array + 1);
 }
 
 Pointer map_node_key(Map map, MapNode node) {
@@ -246,43 +623,101 @@ Pointer map_node_value(Map map, MapNode node) {
 }
 
 MapNode map_find_node(Map map, Pointer key) {
-	// Διασχίζουμε τον πίνακα, ξεκινώντας από τη θέση που κάνει hash το key, και για όσο δε βρίσκουμε EMPTY
-	int count = 0;
-	for (uint pos = map->hash_function(key) % map->capacity;		// ξεκινώντας από τη θέση που κάνει hash το key
-		map->array[pos].state != EMPTY;							// αν φτάσουμε σε EMPTY σταματάμε
-		pos = (pos + 1) % map->capacity) {						// linear probing, γυρνώντας στην αρχή όταν φτάσουμε στη τέλος του πίνακα
+	return find_node(map, key, hash_of(map, key));
+}
 
-		// Μόνο σε OCCUPIED θέσεις (όχι DELETED), ελέγχουμε αν το key είναι εδώ
-		if (map->array[pos].state == OCCUPIED && map->compare(map->array[pos].key, key) == 0)
-			return &map->array[pos];
+MapNode map_find_or_insert(Map map, Pointer key, bool* inserted) {
+	// Όπως η map_insert, προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
 
-		// Αν διασχίσουμε ολόκληρο τον πίνακα σταματάμε. Εφόσον ο πίνακας δεν μπορεί να είναι όλος OCCUPIED,
-		// αυτό μπορεί να συμβεί μόνο στην ακραία περίπτωση που ο πίνακας έχει γεμίσει DELETED τιμές!
-		count++;
-		if (count == map->capacity)
-			break;
-	}
+	bool was_inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash_of(map, key), &was_inserted);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
 
-	return MAP_EOF;
+MapNode map_find_or_insert_with(Map map, Pointer key, CreateValueFunc create_value, bool* inserted) {
+	bool was_inserted;
+	MapNode node = map_find_or_insert(map, key, &was_inserted);
+	if (was_inserted)
+		node->value = create_value(key);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	node->value = value;
 }
 
 // Αρχικοποίηση της συνάρτησης κατακερματισμού του συγκεκριμένου map.
 void map_set_hash_function(Map map, HashFunc func) {
 	map->hash_function = func;
+	map->hash_function64 = NULL;
+}
+
+void map_set_hash_function64(Map map, HashFunc64 func) {
+	map->hash_function64 = func;
+}
+
+void map_set_capacity_policy(Map map, MapCapacityPolicy policy) {
+	// Τα στοιχεία ενός μη κενού map θα χάνονταν μαζί με τον πίνακα
+	if (map->size != 0)
+		return;
+
+	map->capacity_policy = policy;
+
+	// Το map είναι άδειο, οπότε απλά αντικαθιστούμε τον αρχικό πίνακα με έναν της νέας πολιτικής
+	// που χωράει όσα στοιχεία και ο παλιός (ώστε να διατηρείται ο χώρος της map_create_sized)
+	free(map->array);
+	free(map->occupied);
+	map->capacity = capacity_for(map, map->capacity * MAX_LOAD_FACTOR);
+	map->array = calloc(map->capacity, sizeof(struct map_node));
+	map->occupied = bitmap_create(map->capacity);
 }
 
-uint hash_string(Pointer value) {
-	// djb2 hash function, απλή, γρήγορη, και σε γενικές γραμμές αποδοτική
-    uint hash = 5381;
-    for (char* s = value; *s != '\0'; s++)
-		hash = (hash << 5) + hash + *s;			// hash = (hash * 33) + *s. Το foo << 5 είναι γρηγορότερη εκδοχή του foo * 32.
-    return hash;
+// Το linear probing δεν έχει γειτονιά σταθερού μεγέθους, οπότε η map_set_neighbourhood δεν αλλάζει κάτι
+void map_set_neighbourhood(Map map, int neighbourhood) {
 }
 
-uint hash_int(Pointer value) {
-	return *(int*)value;
+#include "../ADTMapHash.h"
+
+/////////////////////// Στατιστικά ///////////////////////////
+
+// Προσθέτει την τιμή value στο ιστόγραμμα hist (οι μεγάλες τιμές μετράνε στην τελευταία θέση)
+static void histogram_add(size_t hist[], size_t value) {
+	hist[value < MAP_STATS_HISTOGRAM ? value : MAP_STATS_HISTOGRAM - 1]++;
 }
 
-uint hash_pointer(Pointer value) {
-	return (size_t)value;				// cast σε sizt_t, που έχει το ίδιο μήκος με έναν pointer
+// Το probe length κάθε στοιχείου είναι η απόστασή του από τη θέση που κάνει hash (με linear probing)
+static void add_probe_lengths(MapStats* stats, MapNode array, size_t capacity) {
+	for (size_t pos = 0; pos < capacity; pos++) {
+		if (array[pos].state != OCCUPIED)
+			continue;
+
+		size_t home = home_pos(array[pos].hash, capacity);
+		histogram_add(stats->probe_lengths, pos >= home ? pos - home : pos - home + capacity);
+	}
+}
+
+void map_stats(Map map, MapStats* stats) {
+	*stats = (MapStats){
+		.size = map->size,
+		.capacity = map->capacity,
+		.load_factor = (double)map->size / map->capacity,
+		.tombstones = map->deleted,
+		.rehashes = map->rehashes,
+		.bytes = sizeof(*map) + map->capacity * sizeof(struct map_node) + (map->capacity + 63) / 64 * sizeof(uint64_t),
+	};
+
+	add_probe_lengths(stats, map->array, map->capacity);
+
+	// Όσο διαρκεί ένα rehash, μετράμε και ό,τι δεν έχει μεταφερθεί ακόμα από το old_array
+	if (map->old_array != NULL) {
+		add_probe_lengths(stats, map->old_array, map->old_capacity);
+		stats->bytes += map->old_capacity * sizeof(struct map_node) + (map->old_capacity + 63) / 64 * sizeof(uint64_t);
+	}
 }
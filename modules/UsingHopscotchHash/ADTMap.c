@@ -1,204 +1,536 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// Υλοποίηση του ADT Map μέσω Hopscotch Hashing
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 
 #include "ADTMap.h"
 
-// Κάθε θέση i θεωρείται γεινοτική με όλες τις θέσεις μέχρι και την i + NEIGHBOURS
-#define NEIGHBOURS 3
+// Κάθε key αποθηκεύεται σε μία από τις NEIGHBOURHOOD θέσεις που ξεκινούν από τη θέση που κάνει hash
+// (τη "γειτονιά" της θέσης). Κάθε θέση έχει ένα bitmap (hop) 32 bits που δείχνει ποιες θέσεις της
+// γειτονιάς της περιέχουν keys που κάνουν hash σε αυτήν, οπότε η μέγιστη γειτονιά είναι 32.
+// Το NEIGHBOURHOOD είναι η προεπιλογή της map_create (αλλάζει κατά το compile, πχ make CFLAGS=-DNEIGHBOURHOOD=16),
+// και κάθε map μπορεί να ορίσει τη δική του γειτονιά με τη map_set_neighbourhood πριν από την πρώτη εισαγωγή.
+#ifndef NEIGHBOURHOOD
+#define NEIGHBOURHOOD 32
+#endif
+
+// Η μικρότερη γειτονιά που δέχεται η map_set_neighbourhood. Σε μικρότερη γειτονιά ήδη λίγα keys με την ίδια θέση
+// δε χωράνε, και ο πίνακας μεγαλώνει μέχρι σχεδόν κανένα key να μη μοιράζεται θέση (χωρητικότητα ~ n^2).
+#define MIN_NEIGHBOURHOOD 16
+
+// Όταν ένα key δε χωράει στη γειτονιά του ο πίνακας μεγαλώνει. Αν έτσι ο load factor πέφτει κάτω από
+// MIN_PLACE_LOAD_FACTOR, πολλά keys έχουν το ίδιο hash code και κανένας πίνακας δε θα τα χωρέσει.
+#define MIN_PLACE_LOAD_FACTOR 0.05
+
+// Η αναζήτηση κενής θέσης κατά την εισαγωγή σταματάει μετά από τόσες θέσεις (και τότε γίνεται rehash),
+// ώστε να μη διασχίζουμε ολόκληρο τον πίνακα.
+#define ADD_RANGE 512
 
-// Οι κόμβοι του map στην υλοποίηση με hash table, μπορούν να είναι σε 3 διαφορετικές καταστάσεις,
-// ώστε αν διαγράψουμε κάποιον κόμβο, αυτός να μην είναι empty, ώστε να μην επηρεάζεται η αναζήτηση
-// αλλά ούτε occupied, ώστε η εισαγωγή να μπορεί να το κάνει overwrite.
 typedef enum {
 	EMPTY, OCCUPIED
 } State;
 
 // Το μέγεθος του Hash Table ιδανικά θέλουμε να είναι πρώτος αριθμός σύμφωνα με την θεωρία.
 // Η παρακάτω λίστα περιέχει πρώτους οι οποίοι έχουν αποδεδιγμένα καλή συμπεριφορά ως μεγέθη.
-// Κάθε re-hash θα γίνεται βάσει αυτής της λίστας. Αν χρειάζονται παραπάνω απο 1610612741 στοχεία, τότε σε καθε rehash διπλασιάζουμε το μέγεθος.
-int prime_sizes[] = {53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
-	786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741};
-
-// Χρησιμοποιούμε open addressing, οπότε σύμφωνα με την θεωρία, πρέπει πάντα να διατηρούμε
-// τον load factor του  hash table μικρότερο ή ίσο του 0.5, για να έχουμε αποδoτικές πράξεις
-#define MAX_LOAD_FACTOR 0.5
+// Κάθε re-hash θα γίνεται βάσει αυτής της λίστας. Αν χρειάζονται παραπάνω απο 824633720837 στοχεία, τότε σε καθε rehash διπλασιάζουμε το μέγεθος.
+// (Κάθε πρώτος είναι ο μικρότερος μετά το 1.5 * 2^k, οπότε οι τιμές μετά το 1610612741 συνεχίζουν με τον ίδιο κανόνα.)
+size_t prime_sizes[] = {53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
+	786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741,
+	3221225473, 6442450967, 12884901893, 25769803799, 51539607599, 103079215111, 206158430209, 412316860441, 824633720837};
+
+// Με MAP_CAPACITY_POW2 η χωρητικότητα ξεκινάει από POW2_MIN_CAPACITY και διπλασιάζεται σε κάθε rehash
+#define POW2_MIN_CAPACITY 64
+
+// Η αναζήτηση εξετάζει μόνο τη γειτονιά, οπότε το κόστος της δεν εξαρτάται από το πόσο γεμάτος
+// είναι ο πίνακας. Οι μετακινήσεις της εισαγωγής επιτυγχάνουν σχεδόν πάντα μέχρι και 0.9.
+#define MAX_LOAD_FACTOR 0.9
+
+// Με load factor κάτω από MIN_LOAD_FACTOR ο πίνακας μικραίνει (βλέπε map_compact στο ADTMap.h), με σταδιακή
+// μεταφορά των στοιχείων από τη migrate, όπως και στη μεγέθυνση.
+#define MIN_LOAD_FACTOR 0.125
+
+// Το rehash δε μεταφέρει όλα τα στοιχεία με τη μία, κάτι που σε μεγάλους πίνακες θα καθυστερούσε πολύ
+// τη μία map_insert που το προκαλεί. Ο παλιός πίνακας κρατιέται δίπλα στον νέο, κάθε map_insert / map_remove
+// μεταφέρει REHASH_STEP θέσεις του στον νέο, και μέχρι να ολοκληρωθεί η μεταφορά οι αναζητήσεις ελέγχουν
+// και τους δύο πίνακες. Με make CFLAGS=-DREHASH_STEP=0 όλες οι θέσεις μεταφέρονται αμέσως κατά το rehash.
+#ifndef REHASH_STEP
+#define REHASH_STEP 64
+#endif
 
 // Δομή του κάθε κόμβου που έχει το hash table (με το οποίο υλοιποιούμε το map)
 struct map_node{
 	Pointer key;		// Το κλειδί που χρησιμοποιείται για να hash-αρουμε
 	Pointer value;  	// Η τιμή που αντισοιχίζεται στο παραπάνω κλειδί
-	State state;		// Μεταβλητή για να μαρκάρουμε την κατάσταση των κόμβων (βλέπε διαγραφή)
+	uint64_t hash;		// Το hash code του key, υπολογίζεται μία φορά κατά την εισαγωγή και μετακινείται μαζί του
+	State state;		// Μεταβλητή για να μαρκάρουμε την κατάσταση των κόμβων
+	uint hop;			// Το bit i είναι 1 αν η θέση (this + i) περιέχει key που κάνει hash σε αυτή τη θέση.
+						// Ανήκει στη θέση και όχι στο key, δεν μετακινείται μαζί με τα key/value.
 };
 
 // Δομή του Map (περιέχει όλες τις πληροφορίες που χρεαζόμαστε για το HashTable)
 struct map {
 	MapNode array;				// Ο πίνακας που θα χρησιμοποιήσουμε για το map (remember, φτιάχνουμε ένα hash table)
-	int capacity;				// Πόσο χώρο έχουμε δεσμεύσει.
-	int size;					// Πόσα στοιχεία έχουμε προσθέσει
+	size_t capacity;			// Πόσο χώρο έχουμε δεσμεύσει.
+	size_t size;				// Πόσα στοιχεία έχουμε προσθέσει
+	size_t reserved;			// Ο χώρος (σε στοιχεία) της map_reserve, κάτω από τον οποίο ο πίνακας δε μικραίνει
+	int neighbourhood;			// Το μέγεθος της γειτονιάς (<= 32)
+	uint64_t* occupied;			// Bitmap με τις OCCUPIED θέσεις του array (βλέπε bitmap_next)
+	MapNode old_array;			// Ο παλιός πίνακας όσο διαρκεί ένα rehash, διαφορετικά NULL
+	uint64_t* old_occupied;		// και το bitmap του
+	size_t old_capacity;
+	size_t migrated;				// Πόσες θέσεις του old_array έχουν ήδη μεταφερθεί στο array
+	int rehashes;				// Πόσα rehash έχουν γίνει και πόσα keys έχουν μετακινηθεί στη γειτονιά τους (για τη map_stats)
+	long displacements;
+	MapCapacityPolicy capacity_policy;	// Πρώτοι αριθμοί ή δυνάμεις του 2 ως χωρητικότητες
 	CompareFunc compare;		// Συνάρτηση για σύγκριση δεικτών, που πρέπει να δίνεται απο τον χρήστη
 	HashFunc hash_function;		// Συνάρτηση για να παίρνουμε το hash code του κάθε αντικειμένου.
+	HashFunc64 hash_function64;	// Η συνάρτηση 64 bits, αν έχει οριστεί (διαφορετικά NULL και χρησιμοποιείται η hash_function)
 	DestroyFunc destroy_key;	// Συναρτήσεις που καλούνται όταν διαγράφουμε έναν κόμβο απο το map.
 	DestroyFunc destroy_value;
 };
 
 
+// Bitmap με ένα bit για κάθε θέση ενός πίνακα (το bit pos % 64 της λέξης pos / 64), που είναι 1 για τις
+// OCCUPIED θέσεις. Η διάσχιση και η map_destroy διαβάζουν 64 θέσεις με κάθε λέξη του bitmap, αντί για
+// τους ίδιους τους κόμβους, οπότε σε αραιούς πίνακες το κόστος τους εξαρτάται από τα στοιχεία και όχι τη χωρητικότητα.
+static uint64_t* bitmap_create(size_t capacity) {
+	return calloc((capacity + 63) / 64, sizeof(uint64_t));
+}
+
+static inline void bitmap_set(uint64_t* bitmap, size_t pos) {
+	bitmap[pos / 64] |= 1ull << (pos % 64);
+}
+
+static inline void bitmap_clear(uint64_t* bitmap, size_t pos) {
+	bitmap[pos / 64] &= ~(1ull << (pos % 64));
+}
+
+// Η πρώτη θέση >= start με bit 1 στο bitmap ενός πίνακα capacity θέσεων, ή capacity αν δεν υπάρχει
+static size_t bitmap_next(const uint64_t* bitmap, size_t capacity, size_t start) {
+	if (start >= capacity)
+		return capacity;
+
+	size_t word = start / 64, words = (capacity + 63) / 64;
+	uint64_t bits = bitmap[word] & (~0ull << (start % 64));		// αγνοούμε τις θέσεις πριν από την start
+	while (bits == 0) {
+		if (++word == words)
+			return capacity;
+		bits = bitmap[word];
+	}
+	return word * 64 + __builtin_ctzll(bits);
+}
+
+
+// Δεσμεύει έναν κενό πίνακα χωρητικότητας capacity (και το bitmap του). Το calloc δίνει απευθείας
+// state == EMPTY (0) και hop == 0, ώστε το rehash να μη διατρέχει όλο τον νέο πίνακα.
+static void allocate_array(Map map, size_t capacity) {
+	map->capacity = capacity;
+	map->array = calloc(capacity, sizeof(struct map_node));
+	map->occupied = bitmap_create(capacity);
+	if (map->array == NULL || map->occupied == NULL) {
+		fprintf(stderr, "map: cannot allocate a table of %zu positions\n", capacity);	// LCOV_EXCL_LINE
+		abort();																	// LCOV_EXCL_LINE
+	}
+}
+
 Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value) {
 	// Δεσμεύουμε κατάλληλα τον χώρο που χρειαζόμαστε για το hash table
 	Map map = malloc(sizeof(*map));
-	map->capacity = prime_sizes[0];
-	map->array = malloc(map->capacity * sizeof(struct map_node));
-
-	// Αρχικοποιούμε τους κόμβους που έχουμε σαν διαθέσιμους.
-	for (int i = 0; i < map->capacity; i++)
-		map->array[i].state = EMPTY;
+	allocate_array(map, prime_sizes[0]);
 
 	map->size = 0;
+	map->old_array = NULL;
+	map->old_occupied = NULL;
+	map->old_capacity = 0;
+	map->migrated = 0;
+	map->reserved = 0;
+	map->rehashes = 0;
+	map->capacity_policy = MAP_CAPACITY_PRIME;
+	map->displacements = 0;
+	map_set_neighbourhood(map, NEIGHBOURHOOD);
 	map->compare = compare;
+	map->hash_function = NULL;
+	map->hash_function64 = NULL;
 	map->destroy_key = destroy_key;
 	map->destroy_value = destroy_value;
 
 	return map;
 }
 
+Map map_create_sized(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value, size_t expected) {
+	Map map = map_create(compare, destroy_key, destroy_value);
+	map_reserve(map, expected);
+	return map;
+}
+
 // Επιστρέφει τον αριθμό των entries του map σε μία χρονική στιγμή.
 int map_size(Map map) {
 	return map->size;
 }
 
-// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ.
-static void rehash(Map map) {
-	// Αποθήκευση των παλιών δεδομένων
-	int old_capacity = map->capacity;
-	MapNode old_array = map->array;
+size_t map_size64(Map map) {
+	return map->size;
+}
+
+// Το hash code του key, από όποια από τις δύο συναρτήσεις κατακερματισμού έχει οριστεί
+static inline uint64_t hash_of(Map map, Pointer key) {
+	return map->hash_function64 != NULL ? map->hash_function64(key) : map->hash_function(key);
+}
 
-	// Βρίσκουμε τη νέα χωρητικότητα, διασχίζοντας τη λίστα των πρώτων ώστε να βρούμε τον επόμενο. 
-	int prime_no = sizeof(prime_sizes) / sizeof(int);	// το μέγεθος του πίνακα
-	for (int i = 0; i < prime_no; i++) {					// LCOV_EXCL_LINE
-		if (prime_sizes[i] > old_capacity) {
-			map->capacity = prime_sizes[i]; 
-			break;
+// Η θέση που κάνει hash ένα key σε πίνακα capacity θέσεων. Οι χωρητικότητες της MAP_CAPACITY_POW2 είναι οι
+// μόνες δυνάμεις του 2, και για αυτές παίρνουμε τα υψηλότερα bits του hash * 2^64/φ (Fibonacci hashing).
+// Διαφορετικά, η διαίρεση των 64 bits είναι αρκετά πιο αργή από αυτή των 32 bits, οπότε για πίνακες κάτω
+// από 2^32 θέσεις "διπλώνουμε" πρώτα το hash code σε 32 bits (τα hash codes των 32 bits δεν αλλάζουν).
+static inline size_t home_pos(uint64_t hash, size_t capacity) {
+	if ((capacity & (capacity - 1)) == 0)
+		return (hash * 0x9E3779B97F4A7C15ull) >> (64 - __builtin_ctzll(capacity));
+	if (capacity <= UINT32_MAX)
+		return (uint32_t)(hash ^ hash >> 32) % (uint32_t)capacity;
+	return hash % capacity;
+}
+
+// Για pos < 2 * capacity, η θέση pos "γυρνώντας" στην αρχή του πίνακα (χωρίς διαίρεση)
+static inline size_t wrap(size_t pos, size_t capacity) {
+	return pos < capacity ? pos : pos - capacity;
+}
+
+// Τοποθετεί στο hash table ένα key που σίγουρα δεν υπάρχει ήδη, και επιστρέφει τον κόμβο του.
+// Επιστρέφει NULL αν δεν ήταν δυνατόν να φέρουμε κενή θέση στη γειτονιά, οπότε πρέπει να γίνει rehash
+// (όσες μετακινήσεις έγιναν ήδη κρατούν κάθε key μέσα στη γειτονιά του, οπότε το map παραμένει σωστό).
+static MapNode place(Map map, Pointer key, Pointer value, uint64_t hash) {
+	size_t capacity = map->capacity;
+	int neighbourhood = map->neighbourhood;
+	size_t home = home_pos(hash, capacity);
+
+	// Βρίσκουμε την πρώτη κενή θέση (empty) μετά το home, σε απόσταση dist από αυτό
+	size_t empty = home;
+	int dist = 0;
+	while (map->array[empty].state == OCCUPIED) {
+		if (++dist == ADD_RANGE || (size_t)dist == capacity)
+			return NULL;
+		empty = wrap(empty + 1, capacity);
+	}
+
+	// Όσο η κενή θέση είναι έξω από τη γειτονιά του home, τη φέρνουμε πιο κοντά: ψάχνουμε στις θέσεις πριν
+	// από αυτήν (ξεκινώντας από την πιο μακρινή) μια θέση bucket που έχει στη γειτονιά της key πριν το empty.
+	// Το key αυτό μπορεί να μετακινηθεί στο empty χωρίς να βγει από τη γειτονιά του, και η θέση του γίνεται το νέο empty.
+	// Οι θέσεις που μετακινούνται φαίνονται από τα hop bitmaps, οπότε δε χρειάζεται να καλέσουμε τη hash_function.
+	while (dist >= neighbourhood) {
+		bool moved = false;
+		for (int offset = neighbourhood - 1; offset > 0 && !moved; offset--) {
+			size_t bucket = wrap(empty + capacity - offset, capacity);
+			uint candidates = map->array[bucket].hop & ((1u << offset) - 1);	// keys του bucket πριν το empty
+			if (candidates == 0)
+				continue;
+
+			int j = __builtin_ctz(candidates);
+			size_t from = wrap(bucket + j, capacity);
+
+			map->array[empty].key = map->array[from].key;
+			map->array[empty].value = map->array[from].value;
+			map->array[empty].hash = map->array[from].hash;
+			map->array[empty].state = OCCUPIED;
+			map->array[from].state = EMPTY;
+			bitmap_set(map->occupied, empty);
+			bitmap_clear(map->occupied, from);
+			map->array[bucket].hop = (map->array[bucket].hop & ~(1u << j)) | (1u << offset);
+
+			empty = from;
+			dist -= offset - j;
+			moved = true;
+			map->displacements++;
 		}
+		if (!moved)
+			return NULL;
 	}
+
+	map->array[empty].key = key;
+	map->array[empty].value = value;
+	map->array[empty].hash = hash;
+	map->array[empty].state = OCCUPIED;
+	map->array[home].hop |= 1u << dist;
+	bitmap_set(map->occupied, empty);
+	return &map->array[empty];
+}
+
+// Επιστρέφει την επόμενη χωρητικότητα μετά την capacity: τον επόμενο πρώτο της λίστας, ή το διπλάσιο για τη MAP_CAPACITY_POW2.
+static size_t next_capacity(Map map, size_t capacity) {
+	if (map->capacity_policy == MAP_CAPACITY_POW2)
+		return capacity * 2;
+
+	size_t prime_no = sizeof(prime_sizes) / sizeof(prime_sizes[0]);	// το μέγεθος του πίνακα
+	for (size_t i = 0; i < prime_no; i++)						// LCOV_EXCL_LINE
+		if (prime_sizes[i] > capacity)
+			return prime_sizes[i];
+
 	// Αν έχουμε εξαντλήσει όλους τους πρώτους, διπλασιάζουμε
-	if (map->capacity == old_capacity)					// LCOV_EXCL_LINE
-		map->capacity *= 2;								// LCOV_EXCL_LINE
+	return capacity * 2;									// LCOV_EXCL_LINE
+}
 
-	// Δημιουργούμε ένα μεγαλύτερο hash table
-	map->array = malloc(map->capacity * sizeof(struct map_node));
-	for (int i = 0; i < map->capacity; i++)
-		map->array[i].state = EMPTY;
+// Η επόμενη χωρητικότητα όταν κάποιο key δε χωράει στη γειτονιά του. Αν με αυτήν ο load factor πέφτει κάτω από
+// MIN_PLACE_LOAD_FACTOR, σταματάει το πρόγραμμα αντί να δεσμεύει όλο και μεγαλύτερους πίνακες.
+static size_t grow_capacity(Map map, size_t capacity) {
+	size_t new_capacity = next_capacity(map, capacity);
+	if ((double)(map->size + 1) / new_capacity < MIN_PLACE_LOAD_FACTOR) {
+		fprintf(stderr, "map: too many keys with the same hash code for a neighbourhood of %d\n", map->neighbourhood);	// LCOV_EXCL_LINE
+		abort();																											// LCOV_EXCL_LINE
+	}
+	return new_capacity;
+}
 
-	// Τοποθετούμε ΜΟΝΟ τα entries που όντως περιέχουν ένα στοιχείο (το rehash είναι και μία ευκαιρία να ξεφορτωθούμε τα deleted nodes)
-	map->size = 0;
-	for (int i = 0; i < old_capacity; i++)
-		if (old_array[i].state == OCCUPIED)
-			map_insert(map, old_array[i].key, old_array[i].value);
+// Η μικρότερη χωρητικότητα (της πολιτικής του map) στην οποία χωράνε n στοιχεία χωρίς rehash
+static size_t capacity_for(Map map, size_t n) {
+	size_t capacity = map->capacity_policy == MAP_CAPACITY_POW2 ? POW2_MIN_CAPACITY : prime_sizes[0];
+	while ((float)n / capacity > MAX_LOAD_FACTOR)
+		capacity = next_capacity(map, capacity);
+	return capacity;
+}
+
+// Ξαναχτίζει με τη μία ολόκληρο το hash table (μαζί με ό,τι δεν έχει μεταφερθεί ακόμα από το old_array)
+// σε μεγαλύτερο πίνακα. Χρειάζεται μόνο στην (απίθανη) περίπτωση που η place αποτύχει κατά τη μεταφορά.
+static void rebuild(Map map) {
+	MapNode arrays[2] = { map->array, map->old_array };
+	uint64_t* bitmaps[2] = { map->occupied, map->old_occupied };
+	size_t capacities[2] = { map->capacity, map->old_array != NULL ? map->old_capacity : 0 };
+
+	// Στην (απίθανη) περίπτωση που κάποιο key δε χωράει ούτε στον νέο πίνακα, δοκιμάζουμε ακόμα μεγαλύτερο
+	// (η grow_capacity σταματάει το πρόγραμμα αν η μεγέθυνση δεν μπορεί να βοηθήσει).
+	size_t new_capacity = map->capacity;
+	bool placed_all = false;
+	while (!placed_all) {
+		new_capacity = grow_capacity(map, new_capacity);
+		allocate_array(map, new_capacity);
+		map->rehashes++;
+
+		placed_all = true;
+		for (int t = 0; t < 2 && placed_all; t++)
+			for (size_t i = 0; i < capacities[t] && placed_all; i++)
+				if (arrays[t][i].state == OCCUPIED)
+					placed_all = place(map, arrays[t][i].key, arrays[t][i].value, arrays[t][i].hash) != NULL;
+
+		if (!placed_all) {
+			free(map->array);		// LCOV_EXCL_LINE
+			free(map->occupied);	// LCOV_EXCL_LINE
+		}
+	}
+
+	//Αποδεσμεύουμε τους παλιούς πίνακες ώστε να μήν έχουμε leaks
+	for (int t = 0; t < 2; t++) {
+		free(arrays[t]);
+		free(bitmaps[t]);
+	}
+	map->old_array = NULL;
+	map->old_occupied = NULL;
+}
+
+// Μεταφέρει έως count θέσεις του old_array στο array (αν υπάρχει rehash σε εξέλιξη).
+// Επιστρέφει true αν κάποια place απέτυχε και ολόκληρο το hash table ξαναχτίστηκε (rebuild) σε μεγαλύτερο πίνακα.
+static bool migrate(Map map, size_t count) {
+	if (map->old_array == NULL)
+		return false;
+
+	for (; count > 0 && map->migrated < map->old_capacity; count--, map->migrated++) {
+		MapNode node = &map->old_array[map->migrated];
+		if (node->state != OCCUPIED)
+			continue;
+
+		if (place(map, node->key, node->value, node->hash) == NULL) {
+			rebuild(map);		// LCOV_EXCL_LINE
+			return true;		// LCOV_EXCL_LINE
+		}
+		// Το hop bit του κόμβου στο old_array μένει, η αναζήτηση αγνοεί τους EMPTY κόμβους
+		node->state = EMPTY;
+		bitmap_clear(map->old_occupied, map->migrated);
+	}
+
+	// Ολοκληρώθηκε η μεταφορά, αποδεσμεύουμε τον παλιό πίνακα ώστε να μήν έχουμε leaks
+	if (map->migrated == map->old_capacity) {
+		free(map->old_array);
+		free(map->old_occupied);
+		map->old_array = NULL;
+		map->old_occupied = NULL;
+	}
+	return false;
+}
+
+// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ,
+// ή που δεν υπάρχει τρόπος να φέρουμε κενή θέση στη γειτονιά ενός key.
+// Δημιουργεί τον νέο πίνακα new_capacity θέσεων, και η μεταφορά των στοιχείων γίνεται σταδιακά από τη migrate.
+static void rehash(Map map, size_t new_capacity) {
+	// Αν δεν έχει ολοκληρωθεί το προηγούμενο rehash, μεταφέρουμε πρώτα ό,τι έχει απομείνει. Αν η μεταφορά
+	// έκανε rebuild, ο πίνακας μόλις μεγάλωσε και δεν υπάρχει μεταφορά σε εξέλιξη, οπότε δε χρειάζεται νέο rehash
+	// (αν δεν είναι ακόμα αρκετά μεγάλος, πχ για τη reserve, ο caller θα ξανακαλέσει τη rehash).
+	if (migrate(map, map->old_capacity))
+		return;		// LCOV_EXCL_LINE
+
+	// Ο τρέχων πίνακας γίνεται ο παλιός, και δημιουργούμε ένα μεγαλύτερο hash table
+	map->old_array = map->array;
+	map->old_occupied = map->occupied;
+	map->old_capacity = map->capacity;
+	map->migrated = 0;
+	map->rehashes++;
+	allocate_array(map, new_capacity);
+
+	migrate(map, REHASH_STEP > 0 ? REHASH_STEP : map->old_capacity);
+}
+
+// Μεγαλώνει τον πίνακα (αν χρειάζεται) ώστε να χωράει n στοιχεία
+static void reserve(Map map, size_t n) {
+	// Μεταφέρουμε αμέσως όλα τα στοιχεία, ώστε οι επόμενες εισαγωγές να μην πληρώνουν τη μεταφορά
+	// (αν η μεταφορά αποτύχει, η rebuild δημιουργεί ακόμα μεγαλύτερο πίνακα)
+	size_t capacity = capacity_for(map, n);
+	while (capacity > map->capacity) {
+		rehash(map, capacity);
+		migrate(map, map->old_capacity);
+	}
+}
+
+// Ο χώρος της map_reserve διατηρείται και όταν ο πίνακας μικραίνει (βλέπε shrink)
+void map_reserve(Map map, size_t n) {
+	if (n > map->reserved)
+		map->reserved = n;
+	reserve(map, n);
+}
+
+// Μικραίνει τον πίνακα αν ο load factor έπεσε κάτω από MIN_LOAD_FACTOR. Όπως και στη μεγέθυνση,
+// τα στοιχεία μεταφέρονται σταδιακά στον νέο πίνακα από τη migrate.
+static void shrink(Map map) {
+	if (map->size >= map->capacity * MIN_LOAD_FACTOR)
+		return;
+
+	size_t n = 2 * map->size > map->reserved ? 2 * map->size : map->reserved;
+	size_t capacity = capacity_for(map, n);
+	if (capacity < map->capacity)
+		rehash(map, capacity);
+}
+
+void map_compact(Map map) {
+	// Τα στοιχεία μεταφέρονται αμέσως. Στην (απίθανη) περίπτωση που κάποιο key δε βρει θέση στη γειτονιά
+	// του, η rebuild δημιουργεί μεγαλύτερο πίνακα, οπότε η χωρητικότητα μπορεί να μη μικρύνει όσο η capacity_for.
+	map->reserved = 0;
+	rehash(map, capacity_for(map, map->size));
+	migrate(map, map->old_capacity);
+}
 
-	//Αποδεσμεύουμε τον παλιό πίνακα ώστε να μήν έχουμε leaks
-	free(old_array);
+// Επιστρέφει τον κόμβο του key σε έναν από τους δύο πίνακες (array ή old_array), ή MAP_EOF.
+// Εξετάζονται μόνο οι θέσεις της γειτονιάς που έχουν keys με το ίδιο home, σύμφωνα με το hop bitmap,
+// και η compare καλείται μόνο για keys με ίδιο hash code.
+static MapNode find_in(Map map, MapNode array, size_t capacity, Pointer key, uint64_t hash) {
+	size_t home = home_pos(hash, capacity);
+	for (uint hop = array[home].hop; hop != 0; hop &= hop - 1) {
+		MapNode node = &array[wrap(home + __builtin_ctz(hop), capacity)];
+		if (node->state == OCCUPIED && node->hash == hash && map->compare(node->key, key) == 0)
+			return node;
+	}
+	return MAP_EOF;
+}
+
+// Όπως η find_in, αλλά σε όποιον πίνακα βρίσκεται το key
+static MapNode find_node(Map map, Pointer key, uint64_t hash) {
+	MapNode node = find_in(map, map->array, map->capacity, key, hash);
+
+	// Όσο διαρκεί ένα rehash, το key μπορεί να μην έχει μεταφερθεί ακόμα
+	if (node == MAP_EOF && map->old_array != NULL)
+		node = find_in(map, map->old_array, map->old_capacity, key, hash);
+
+	return node;
+}
+
+// Η map_find_or_insert για key με ήδη υπολογισμένο hash code: επιστρέφει τον κόμβο του key, ή αν δεν
+// υπάρχει το τοποθετεί με τιμή NULL. Η αναζήτηση εξετάζει μόνο τη γειτονιά του home, και η place ξεκινάει
+// από το ίδιο home (που είναι ήδη στην cache), χωρίς να ξαναϋπολογιστεί το hash code.
+static MapNode find_or_insert_hashed(Map map, Pointer key, uint64_t hash, bool* inserted) {
+	MapNode node = find_node(map, key, hash);
+	*inserted = node == MAP_EOF;
+	if (node != MAP_EOF)
+		return node;
+
+	// Αν με την νέα εισαγωγή ξεπερνάμε το μέγιστο load factor, κάνουμε πρώτα rehash.
+	float load_factor = (float)(map->size + 1) / map->capacity;
+	if (load_factor > MAX_LOAD_FACTOR)
+		rehash(map, next_capacity(map, map->capacity));
+
+	// Αν δεν υπάρχει τρόπος να φέρουμε κενή θέση στη γειτονιά, μεγαλώνουμε τον πίνακα και ξαναδοκιμάζουμε
+	while ((node = place(map, key, NULL, hash)) == NULL)
+		rehash(map, grow_capacity(map, map->capacity));
+	map->size++;
+	return node;
 }
 
 // Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει,
-// ανανέωση του με ένα νέο value, και η συνάρτηση επιστρέφει true.
+// ανανέωση του με ένα νέο value.
+// Η map_insert για key με ήδη υπολογισμένο hash code
+static void insert_hashed(Map map, Pointer key, Pointer value, uint64_t hash) {
+	bool inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash, &inserted);
+	if (!inserted) {
+		// Αν αντικαθιστούμε παλιά key/value, τa κάνουμε destroy
+		if (node->key != key && map->destroy_key != NULL)
+			map->destroy_key(node->key);
+		if (node->value != value && map->destroy_value != NULL)
+			map->destroy_value(node->value);
+
+		node->key = key;
+	}
+	node->value = value;
+}
+
+
 void map_insert(Map map, Pointer key, Pointer value) {
-    // Σκανάρουμε το Hash Table μέχρι να βρούμε διαθέσιμη θέση για να τοποθετήσουμε το ζευγάρι,
-    // ή μέχρι να βρούμε το κλειδί ώστε να το αντικαταστήσουμε.
-    MapNode node = map_find_node(map, key);
-    if(node != MAP_EOF){
-        if (map->destroy_key != NULL)
-            map->destroy_key(node->key);
-        if (map->destroy_value != NULL)
-            map->destroy_value(node->value);
-        node->key = key;
-        node->value = value;
-        return;
-    }
-
-    uint pos = map->hash_function(key) % map->capacity;		// Βρίσκουμε τη θέση που χασάρει το key
-    if(map->array[pos].state == EMPTY){						// Αν στη θέση αυτη ο κόμβοσ είναι κενός τοποθετούμε το στοιχείο
-        map->array[pos].key = key;
-        map->array[pos].value = value;
-        map->array[pos].state = OCCUPIED;
-        map->size++;										// Αυξάνουμε το μέγεθος του map
-		float load_factor = (float)(map->size ) / map->capacity;// Πριν επιστρέψουμε ελέγχουμε αν χρειάζεται rehash
-   			if (load_factor > MAX_LOAD_FACTOR)
-        		rehash(map);
-        return;
-    }
-    // Διαφορετικά ψάχνουμε την επόμενη κενή θέση , η οποία βρίσκεται στη μεταβλητή e
-    uint e = pos +1;
-    while(e!=pos){
-        if(map->array[e].state == EMPTY){
-            break;
-        }
-        e = (e + 1) % map->capacity;
-    }
-    
-    while(1){   					// Η επανάληψη συνεχίζεται μέχρι να γίνει κάποιο return μέσα στο loop
-        if(e<pos) e = e + map->capacity;	// Για να γίνει σωστά η παρακάτω πράξη με το απόλυτο
-       // Αν η διαφόρα της κενής θέσης και της θέσης που χασάρει το key είναι μικρότερη ή ίση απο NEIGHBOURS 
-	   // τότε η θέση e είναι γειτονική και το στοιχείο θα εισαχθεί εκεί
-	    if(abs(e - pos) <= NEIGHBOURS){	
-            e = e % map->capacity;	// Επαναφέρουμε το e στη πραγματική θέση που αντιστοιχεί στο map
-            map->array[e].key = key;
-            map->array[e].value = value;
-            map->array[e].state = OCCUPIED;
-            map->size++;
-			float load_factor = (float)(map->size ) / map->capacity;
-   				if (load_factor > MAX_LOAD_FACTOR)
-        			rehash(map);
-            return;
-        }
-		// Ψάχνουμε να βρούμε αν μπορεί να γίνει swap με κάποιο απο τα NEIGHBOURS γειτονικά στοιχεία
-        uint count = 0;				
-        while(count<NEIGHBOURS){					// To loop θα γίνει όσες φορές και τα γειτονικά στοιχεία
-            uint i = (e - NEIGHBOURS + count) % map->capacity; // i η θέση του εκάστοτε γειτονικού στοιχείου
-            uint hashi = map->hash_function(map->array[i].key) % map->capacity ; // hashi η θέση που χασάρει το στοιχείο που βρίσκεται στη θέση i
-			if(e<pos) e = e + map->capacity;				// Για να γίνει σωστά η παρακάτω πράξη με το απόλυτο
-			if(hashi<pos) hashi = hashi + map->capacity;	// Για να γίνει σωστά η παρακάτω πράξη με το απόλυτο
-             
-			 // Αν η διαφόρα της κενής θέσης(e) και της θέσης που χασάρει το στοιχείο που βρίσκεται στη θέση i(hashi), 
-			 // είναι μικρότερη ή ίση απο NEIGHBOURS , τότε μπορούμε να κάνουμε swap τα δύο στοιχεία,
-			 // αφού το στοιχείο στη θέση i θα εξακολουθεί να είναι γειτονικό στοιχείο με τη θέση hashi
-			if(abs(e - hashi) <= NEIGHBOURS){
-                e = e % map->capacity;
-                map->array[e].key = map->array[i].key;		 // Κάνουμε το swap
-                map->array[e].value = map->array[i].value;
-                map->array[e].state = OCCUPIED;
-                map->array[i].state = EMPTY;				// Δημιουργούμε τη νέα ελεύθερη θέση
-				map->array[i].key = NULL;
-				map->array[i].value = NULL;
-                e = i;
-                break;		// break και συνεχίζουμε να φτιάχνουμε κενές θέσεις κοντά στο pos
-            }
-            count++;		// Διαφορετικά εξετάζουμε το επόμενο γειτονικό στοιχείο
-        }
-		// Αν δεν μπορεί να γίνει swap με κάποιο απο τα NEIGHBOURS γειτονικά στοιχεία κάνουμε rehash
-        if(count>=NEIGHBOURS){
-            rehash(map);
-			pos = map->hash_function(key) % map->capacity;	// Βρίσκουμε τη θέση που χασάρει το key στο νέο map
-            if(map->array[pos].state == EMPTY){				// Αν στη θέση αυτη ο κόμβοσ είναι κενός τοποθετούμε το στοιχείο
-                map->array[pos].key = key;
-                map->array[pos].value = value;
-                map->array[pos].state = OCCUPIED;
-                map->size++;			// Αυξάνουμε το μέγεθος του map αλλά δεν ελέγχουμε για rehash γιατι μόλις έγινε
-                return;										
-            }
-            // Διαφορετικά ψάχνουμε την επόμενη κενή θέση
-            e = pos +1;
-            while(e!=pos){
-                if(map->array[e].state == EMPTY){
-                    break;
-                }
-                e = (e + 1) % map->capacity;
-            }
-        }
-    }
+	// Κάθε εισαγωγή προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
+
+	insert_hashed(map, key, value, hash_of(map, key));
 }
 
+// Η map_insert_batch υπολογίζει τα hash codes σε ομάδες των BATCH_SIZE keys, και φορτώνει στην cache
+// τη θέση κάθε key PREFETCH_DISTANCE εισαγωγές πριν από αυτή, ώστε οι αναμονές για τη μνήμη να επικαλύπτονται.
+#define BATCH_SIZE 64
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 8
+#endif
+
+// Φορτώνει στην cache (χωρίς να περιμένει) τον κόμβο από τον οποίο ξεκινάει η αναζήτηση του hash
+static inline void prefetch(Map map, uint64_t hash) {
+	__builtin_prefetch(&map->array[home_pos(hash, map->capacity)], 1);
+}
+
+void map_insert_batch(Map map, Pointer* keys, Pointer* values, size_t n) {
+	// Δεσμεύουμε μία φορά χώρο για όλα τα στοιχεία (αν κάποια keys υπάρχουν ήδη, απλά περισσεύει χώρος)
+	reserve(map, map->size + n);
+
+	uint64_t hashes[BATCH_SIZE];
+	for (size_t start = 0; start < n; start += BATCH_SIZE) {
+		size_t count = n - start < BATCH_SIZE ? n - start : BATCH_SIZE;
+		for (size_t i = 0; i < count; i++) {
+			hashes[i] = hash_of(map, keys[start + i]);
+			if (i < PREFETCH_DISTANCE)
+				prefetch(map, hashes[i]);
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			if (i + PREFETCH_DISTANCE < count)
+				prefetch(map, hashes[i + PREFETCH_DISTANCE]);
+
+			migrate(map, REHASH_STEP);
+			insert_hashed(map, keys[start + i], values != NULL ? values[start + i] : NULL, hashes[i]);
+		}
+	}
+}
 
 // Διαγραφή απο το Hash Table του κλειδιού με τιμή key
 bool map_remove(Map map, Pointer key) {
-	MapNode node = map_find_node(map, key);
+	// Κάθε διαγραφή προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
+
+	uint64_t hash = hash_of(map, key);
+	MapNode node = find_node(map, key, hash);
 	if (node == MAP_EOF)
 		return false;
 
@@ -208,9 +540,17 @@ bool map_remove(Map map, Pointer key) {
 	if (map->destroy_value != NULL)
 		map->destroy_value(node->value);
 
-	
-	node->state = EMPTY;		// Όταν γίνει η αφαίρεση ο κόμβος θα έιναι empty
+	// Ο κόμβος γίνεται empty, και αφαιρείται από το hop bitmap του home του (στον πίνακα που βρίσκεται)
+	bool in_array = node >= map->array && node < map->array + map->capacity;
+	MapNode array = in_array ? map->array : map->old_array;
+	size_t capacity = in_array ? map->capacity : map->old_capacity;
+
+	size_t home = home_pos(hash, capacity);
+	array[home].hop &= ~(1u << wrap(node - array + capacity - home, capacity));
+	node->state = EMPTY;
+	bitmap_clear(in_array ? map->occupied : map->old_occupied, node - array);
 	map->size--;
+	shrink(map);
 
 	return true;
 }
@@ -224,6 +564,51 @@ Pointer map_find(Map map, Pointer key) {
 		return NULL;
 }
 
+// Στη map_find_batch (βλέπε ADTMap.h) το πρώτο βήμα διαβάζει το hop της θέσης του key και κάνει prefetch στους
+// κόμβους της γειτονιάς που δείχνει, και το δεύτερο ελέγχει αυτούς τους κόμβους.
+
+// Η κατάσταση μιας αναζήτησης της map_find_batch
+typedef struct {
+	size_t index;		// Η θέση του key στον πίνακα keys
+	uint64_t hash;
+	bool hashed;		// Έχει υπολογιστεί το hash code (στο πρώτο βήμα, αφού γίνει prefetch στο key)
+	size_t home;		// Η θέση που κάνει hash το key (έχει ήδη γίνει prefetch)
+	uint hop;			// Αν != 0, οι θέσεις της γειτονιάς με keys της home (έχει γίνει prefetch στους κόμβους τους)
+} Lookup;
+
+// Υπολογίζει το hash code του key της l και κάνει prefetch στη θέση του
+static void lookup_hash(Map map, Lookup* l, Pointer key) {
+	l->hash = hash_of(map, key);
+	l->home = home_pos(l->hash, map->capacity);
+	l->hop = 0;
+	__builtin_prefetch(&map->array[l->home]);
+}
+
+#include "../ADTMapFindBatch.h"
+
+// Ένα βήμα της αναζήτησης l (σε δύο γύρους: το hop της home και οι κόμβοι του), επιστρέφει true αν ολοκληρώθηκε
+static bool lookup_step(Map map, Lookup* l, Pointer* keys, Pointer* out_values) {
+	if (l->hop == 0) {
+		l->hop = map->array[l->home].hop;
+		for (uint hop = l->hop; hop != 0; hop &= hop - 1)
+			__builtin_prefetch(&map->array[wrap(l->home + __builtin_ctz(hop), map->capacity)]);
+		if (l->hop != 0)
+			return false;
+	}
+
+	for (; l->hop != 0; l->hop &= l->hop - 1) {
+		MapNode node = &map->array[wrap(l->home + __builtin_ctz(l->hop), map->capacity)];
+		if (node->state == OCCUPIED && node->hash == l->hash && map->compare(node->key, keys[l->index]) == 0)
+			return lookup_finish(l, out_values, node);
+	}
+
+	// Δε βρέθηκε στο array. Όσο διαρκεί ένα rehash, το key μπορεί να μην έχει μεταφερθεί ακόμα.
+	MapNode node = MAP_EOF;
+	if (map->old_array != NULL)
+		node = find_in(map, map->old_array, map->old_capacity, keys[l->index], l->hash);
+	return lookup_finish(l, out_values, node);
+}
+
 
 DestroyFunc map_set_destroy_key(Map map, DestroyFunc destroy_key) {
 	DestroyFunc old = map->destroy_key;
@@ -239,37 +624,51 @@ DestroyFunc map_set_destroy_value(Map map, DestroyFunc destroy_value) {
 
 // Απελευθέρωση μνήμης που δεσμεύει το map
 void map_destroy(Map map) {
-	for (int i = 0; i < map->capacity; i++) {
-		if (map->array[i].state == OCCUPIED) {
+	if (map->destroy_key != NULL || map->destroy_value != NULL) {
+		for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node)) {
 			if (map->destroy_key != NULL)
-				map->destroy_key(map->array[i].key);
+				map->destroy_key(node->key);
 			if (map->destroy_value != NULL)
-				map->destroy_value(map->array[i].value);
+				map->destroy_value(node->value);
 		}
 	}
 
+	free(map->old_array);
+	free(map->old_occupied);
 	free(map->array);
+	free(map->occupied);
 	free(map);
 }
 
 /////////////////////// Διάσχιση του map μέσω κόμβων ///////////////////////////
 
+// Όσο διαρκεί ένα rehash, διασχίζουμε πρώτα το array και μετά ό,τι έχει μείνει στο old_array.
+
+// Επιστρέφει τον πρώτο OCCUPIED κόμβο του πίνακα array (με bitmap occupied) με θέση >= start, ή MAP_EOF
+static MapNode first_occupied(MapNode array, const uint64_t* occupied, size_t capacity, size_t start) {
+	size_t pos = bitmap_next(occupied, capacity, start);
+	return pos < capacity ? &array[pos] : MAP_EOF;
+}
+
 MapNode map_first(Map map) {
 	//Ξεκινάμε την επανάληψή μας απο το 1ο στοιχείο, μέχρι να βρούμε κάτι όντως τοποθετημένο
-	for (int i = 0; i < map->capacity; i++)
-		if (map->array[i].state == OCCUPIED)
-			return &map->array[i];
-
-	return MAP_EOF;
+	MapNode node = first_occupied(map->array, map->occupied, map->capacity, 0);
+	if (node == MAP_EOF && map->old_array != NULL)
+		node = first_occupied(map->old_array, map->old_occupied, map->old_capacity, 0);
+	return node;
 }
 
 MapNode map_next(Map map, MapNode node) {
 	// Το node είναι pointer στο i-οστό στοιχείο του array, οπότε node - array == i  (pointer arithmetic!)
-	for (int i = node - map->array + 1; i < map->capacity; i++)
-		if (map->array[i].state == OCCUPIED)
-			return &map->array[i];
+	if (node >= map->array && node < map->array + map->capacity) {
+		MapNode next = first_occupied(map->array, map->occupied, map->capacity, node - map->array + 1);
+		if (next == MAP_EOF && map->old_array != NULL)
+			next = first_occupied(map->old_array, map->old_occupied, map->old_capacity, 0);
+		return next;
+	}
 
-	return MAP_EOF;
+	// Διαφορετικά το node ανήκει στο old_array
+	return first_occupied(map->old_array, map->old_occupied, map->old_capacity, node - map->old_array + 1);
 }
 
 Pointer map_node_key(Map map, MapNode node) {
@@ -281,34 +680,103 @@ Pointer map_node_value(Map map, MapNode node) {
 }
 
 MapNode map_find_node(Map map, Pointer key) {
-	uint pos =  map->hash_function(key) % map->capacity;	// Βρίσκουμε τη θέση που χασάρει το key
-	for (int i = 0;	i<= NEIGHBOURS;	i++){					// Ψάχνουμε αν το κλειδί key βρίσκεται σε γειτονικό κόμβο η στη θέση pos
-		if (map->array[pos].state == OCCUPIED && map->compare(map->array[pos].key, key) == 0){
-			return &map->array[pos];						// Bρέθηκε και το επιστέφουμε
-		}
-		pos = (pos + 1) % map->capacity;        
-	}
-	// Διαφορετικά δεν υπαρχει καθόλου στο map
-	return MAP_EOF;
+	return find_node(map, key, hash_of(map, key));
+}
+
+MapNode map_find_or_insert(Map map, Pointer key, bool* inserted) {
+	// Όπως η map_insert, προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
+
+	bool was_inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash_of(map, key), &was_inserted);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+MapNode map_find_or_insert_with(Map map, Pointer key, CreateValueFunc create_value, bool* inserted) {
+	bool was_inserted;
+	MapNode node = map_find_or_insert(map, key, &was_inserted);
+	if (was_inserted)
+		node->value = create_value(key);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	node->value = value;
 }
 
 // Αρχικοποίηση της συνάρτησης κατακερματισμού του συγκεκριμένου map.
 void map_set_hash_function(Map map, HashFunc func) {
 	map->hash_function = func;
+	map->hash_function64 = NULL;
 }
 
-uint hash_string(Pointer value) {
-	// djb2 hash function, απλή, γρήγορη, και σε γενικές γραμμές αποδοτική
-    uint hash = 5381;
-    for (char* s = value; *s != '\0'; s++)
-		hash = (hash << 5) + hash + *s;			// hash = (hash * 33) + *s. Το foo << 5 είναι γρηγορότερη εκδοχή του foo * 32.
-    return hash;
+void map_set_hash_function64(Map map, HashFunc64 func) {
+	map->hash_function64 = func;
 }
 
-uint hash_int(Pointer value) {
-	return *(int*)value;
+void map_set_capacity_policy(Map map, MapCapacityPolicy policy) {
+	// Τα στοιχεία ενός μη κενού map θα χάνονταν μαζί με τον πίνακα
+	if (map->size != 0)
+		return;
+
+	map->capacity_policy = policy;
+
+	// Το map είναι άδειο, οπότε απλά αντικαθιστούμε τον αρχικό πίνακα με έναν της νέας πολιτικής
+	// που χωράει όσα στοιχεία και ο παλιός (ώστε να διατηρείται ο χώρος της map_create_sized)
+	free(map->array);
+	free(map->occupied);
+	allocate_array(map, capacity_for(map, map->capacity * MAX_LOAD_FACTOR));
 }
 
-uint hash_pointer(Pointer value) {
-	return (size_t)value;				// cast σε sizt_t, που έχει το ίδιο μήκος με έναν pointer
-}
\ No newline at end of file
+// Η γειτονιά ισχύει για όλα τα keys του πίνακα, οπότε δεν αλλάζει αφού γίνουν εισαγωγές
+void map_set_neighbourhood(Map map, int neighbourhood) {
+	if (map->size != 0)
+		return;
+
+	map->neighbourhood = neighbourhood < MIN_NEIGHBOURHOOD ? MIN_NEIGHBOURHOOD : neighbourhood > 32 ? 32 : neighbourhood;
+}
+
+#include "../ADTMapHash.h"
+
+/////////////////////// Στατιστικά ///////////////////////////
+
+// Προσθέτει την τιμή value στο ιστόγραμμα hist (οι μεγάλες τιμές μετράνε στην τελευταία θέση)
+static void histogram_add(size_t hist[], size_t value) {
+	hist[value < MAP_STATS_HISTOGRAM ? value : MAP_STATS_HISTOGRAM - 1]++;
+}
+
+// Το probe length κάθε στοιχείου είναι η θέση του μέσα στη γειτονιά του home (< neighbourhood)
+static void add_probe_lengths(MapStats* stats, MapNode array, size_t capacity) {
+	for (size_t pos = 0; pos < capacity; pos++) {
+		if (array[pos].state != OCCUPIED)
+			continue;
+
+		size_t home = home_pos(array[pos].hash, capacity);
+		histogram_add(stats->probe_lengths, pos >= home ? pos - home : pos - home + capacity);
+	}
+}
+
+void map_stats(Map map, MapStats* stats) {
+	*stats = (MapStats){
+		.size = map->size,
+		.capacity = map->capacity,
+		.load_factor = (double)map->size / map->capacity,
+		.displacements = map->displacements,
+		.rehashes = map->rehashes,
+		.bytes = sizeof(*map) + map->capacity * sizeof(struct map_node) + (map->capacity + 63) / 64 * sizeof(uint64_t),
+	};
+
+	add_probe_lengths(stats, map->array, map->capacity);
+
+	// Όσο διαρκεί ένα rehash, μετράμε και ό,τι δεν έχει μεταφερθεί ακόμα από το old_array
+	if (map->old_array != NULL) {
+		add_probe_lengths(stats, map->old_array, map->old_capacity);
+		stats->bytes += map->old_capacity * sizeof(struct map_node) + (map->old_capacity + 63) / 64 * sizeof(uint64_t);
+	}
+}
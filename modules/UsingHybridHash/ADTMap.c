@@ -5,9 +5,11 @@
 /////////////////////////////////////////////////////////////////////////////
 
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
 #include <stdio.h>
+
 #include "ADTMap.h"
-#include "ADTVector.h"
 
 // Κάθε θέση i θεωρείται γεινοτική με όλες τις θέσεις μέχρι και την i + NEIGHBOURS
 #define NEIGHBOURS 3
@@ -18,263 +20,688 @@ typedef enum {
 
 // Το μέγεθος του Hash Table ιδανικά θέλουμε να είναι πρώτος αριθμός σύμφωνα με την θεωρία.
 // Η παρακάτω λίστα περιέχει πρώτους οι οποίοι έχουν αποδεδιγμένα καλή συμπεριφορά ως μεγέθη.
-// Κάθε re-hash θα γίνεται βάσει αυτής της λίστας. Αν χρειάζονται παραπάνω απο 1610612741 στοχεία, τότε σε καθε rehash διπλασιάζουμε το μέγεθος.
-int prime_sizes[] = {53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
-	786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741};
+// Κάθε re-hash θα γίνεται βάσει αυτής της λίστας. Αν χρειάζονται παραπάνω απο 824633720837 στοχεία, τότε σε καθε rehash διπλασιάζουμε το μέγεθος.
+// (Κάθε πρώτος είναι ο μικρότερος μετά το 1.5 * 2^k, οπότε οι τιμές μετά το 1610612741 συνεχίζουν με τον ίδιο κανόνα.)
+size_t prime_sizes[] = {53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
+	786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741,
+	3221225473, 6442450967, 12884901893, 25769803799, 51539607599, 103079215111, 206158430209, 412316860441, 824633720837};
+
+// Με MAP_CAPACITY_POW2 η χωρητικότητα ξεκινάει από POW2_MIN_CAPACITY και διπλασιάζεται σε κάθε rehash
+#define POW2_MIN_CAPACITY 64
 
 // Χρησιμοποιούμε open addressing, οπότε σύμφωνα με την θεωρία, πρέπει πάντα να διατηρούμε
 // τον load factor του  hash table μικρότερο ή ίσο του 0.5, για να έχουμε αποδoτικές πράξεις
 #define MAX_LOAD_FACTOR 0.5
 
+// Ο πίνακας μικραίνει κάτω από MIN_LOAD_FACTOR (βλέπε map_compact στο ADTMap.h). Στο size μετράνε και τα στοιχεία
+// των αλυσίδων, και όταν ολοκληρωθεί η μεταφορά αποδεσμεύονται τα slabs που έμειναν χωρίς blocks σε αλυσίδα.
+#define MIN_LOAD_FACTOR 0.125
+
+// Το rehash δε μεταφέρει όλα τα στοιχεία με τη μία, κάτι που σε μεγάλους πίνακες θα καθυστερούσε πολύ
+// τη μία map_insert που το προκαλεί. Ο παλιός πίνακας (μαζί με τις αλυσίδες του) κρατιέται δίπλα στον νέο,
+// κάθε map_insert / map_remove μεταφέρει REHASH_STEP θέσεις του στον νέο, και μέχρι να ολοκληρωθεί η
+// μεταφορά οι αναζητήσεις ελέγχουν και τους δύο. Με make CFLAGS=-DREHASH_STEP=0 όλες οι θέσεις
+// μεταφέρονται αμέσως κατά το rehash.
+#ifndef REHASH_STEP
+#define REHASH_STEP 64
+#endif
+
+// Τα στοιχεία που δε χωράνε στη γειτονιά τους μπαίνουν στην αλυσίδα (chain) της θέσης που κάνουν hash.
+// Η αλυσίδα είναι λίστα από blocks των CHAIN_NODES κόμβων, και κάθε block είναι ένα cache line
+// (2 * 24 + 8 = 56 bytes), οπότε μια αλυσίδα μέχρι CHAIN_NODES στοιχείων κοστίζει μία μόνο επιπλέον πρόσβαση.
+#ifndef CHAIN_NODES
+#define CHAIN_NODES 2
+#endif
+
+// Από το hash code κρατάμε τα HASH_BITS χαμηλότερα bits, ώστε μαζί με το state να χωράει σε 8 bytes (κόμβος 24 bytes).
+// Η θέση ενός key υπολογίζεται πάντα από το κομμένο hash code, οπότε είναι ίδια στην εισαγωγή και στο rehash.
+#define HASH_BITS 56
+
+// Τα blocks δε δεσμεύονται ένα-ένα με malloc, αλλά από slabs των SLAB_CHAINS blocks που ανήκουν
+// στο map. Τα blocks που αδειάζουν μπαίνουν σε μια λίστα (free list) και ξαναχρησιμοποιούνται
+// από τις επόμενες εισαγωγές, και η map_destroy αποδεσμεύει ολόκληρα slabs.
+#ifndef SLAB_CHAINS
+#define SLAB_CHAINS 128
+#endif
+
 // Δομή του κάθε κόμβου που έχει το hash table (με το οποίο υλοιποιούμε το map)
 struct map_node {
 	Pointer key;		// Το κλειδί που χρησιμοποιείται για να hash-αρουμε
 	Pointer value;  	// Η τιμή που αντισοιχίζεται στο παραπάνω κλειδί
-	State state;		// Μεταβλητή για να μαρκάρουμε την κατάσταση των κόμβων (βλέπε διαγραφή)
+	uint64_t hash : HASH_BITS;	// Το hash code του key (βλέπε HASH_BITS), υπολογίζεται μία φορά κατά την εισαγωγή
+	State state : 8;	// Μεταβλητή για να μαρκάρουμε την κατάσταση των κόμβων (βλέπε διαγραφή)
 };
 
+// Ένα block μιας αλυσίδας. Οι κόμβοι του με state EMPTY είναι ελεύθεροι, και ένα block που
+// αδειάζει εντελώς αφαιρείται από την αλυσίδα, οπότε οι αλυσίδες δεν περιέχουν ποτέ άδεια blocks.
+typedef struct chain* Chain;
+
+struct chain {
+	_Alignas(64) struct map_node nodes[CHAIN_NODES];
+	Chain next;					// Το επόμενο block της αλυσίδας (ή της free list)
+};
+
+// Ένα slab από blocks. Τα slabs ενός map σχηματίζουν λίστα, ώστε να αποδεσμεύονται στη map_destroy.
+typedef struct slab* Slab;
+
+struct slab {
+	struct chain chains[SLAB_CHAINS];
+	Slab next;
+};
+
+// Οι περιοχές του map, με τη σειρά που διασχίζονται από τη map_first / map_next
+typedef enum {
+	IN_ARRAY, IN_CHAINS, IN_OLD_ARRAY, IN_OLD_CHAINS, IN_END
+} Region;
+
+// Η θέση ενός κόμβου στη διάσχιση, ώστε η map_next να συνεχίζει από αυτήν χωρίς να ψάχνει τον κόμβο
+typedef struct {
+	MapNode node;				// Ο κόμβος (NULL αν ο cursor δεν αντιστοιχεί σε κόμβο)
+	Region region;
+	size_t next;				// Η επόμενη θέση του array / των chains που θα ελεγχθεί
+	Chain chain;				// Στις αλυσίδες, το block του κόμβου
+	int slot;					// και ο επόμενος κόμβος του block που θα ελεγχθεί
+} Cursor;
+
 // Δομή του Map (περιέχει όλες τις πληροφορίες που χρεαζόμαστε για το HashTable)
 struct map {
 	MapNode array;				// Ο πίνακας που θα χρησιμοποιήσουμε για το map (remember, φτιάχνουμε ένα hash table)
-	Vector *chains;
-	int capacity;				// Πόσο χώρο έχουμε δεσμεύσει.
-	int size;					// Πόσα στοιχεία έχουμε προσθέσει
+	Chain *chains;				// Για κάθε θέση, η αλυσίδα με τους κόμβους που δε χώρεσαν στη γειτονιά της (ή NULL)
+	size_t capacity;			// Πόσο χώρο έχουμε δεσμεύσει.
+	size_t size;				// Πόσα στοιχεία έχουμε προσθέσει
+	size_t reserved;			// Ο χώρος (σε στοιχεία) της map_reserve, κάτω από τον οποίο ο πίνακας δε μικραίνει
+	uint64_t* occupied;			// Bitmap με τις OCCUPIED θέσεις του array (βλέπε bitmap_next)
+	MapNode old_array;			// Ο παλιός πίνακας όσο διαρκεί ένα rehash, διαφορετικά NULL
+	Chain *old_chains;			// Οι αλυσίδες του παλιού πίνακα
+	uint64_t* old_occupied;		// Το bitmap του παλιού πίνακα
+	size_t old_capacity;
+	size_t migrated;				// Πόσες θέσεις του old_array έχουν ήδη μεταφερθεί στο array
+	Slab slabs;					// Τα slabs από τα οποία δεσμεύονται τα blocks των αλυσίδων
+	Chain free_chains;			// Τα ελεύθερα blocks των slabs
+	Cursor cursor;				// Ο κόμβος που επέστρεψε τελευταία η map_first / map_next (ακυρώνεται σε κάθε μεταβολή)
+	int rehashes;				// Πόσα rehash έχουν γίνει (για τη map_stats)
+	MapCapacityPolicy capacity_policy;	// Πρώτοι αριθμοί ή δυνάμεις του 2 ως χωρητικότητες
 	CompareFunc compare;		// Συνάρτηση για σύγκριση δεικτών, που πρέπει να δίνεται απο τον χρήστη
 	HashFunc hash_function;		// Συνάρτηση για να παίρνουμε το hash code του κάθε αντικειμένου.
+	HashFunc64 hash_function64;	// Η συνάρτηση 64 bits, αν έχει οριστεί (διαφορετικά NULL και χρησιμοποιείται η hash_function)
 	DestroyFunc destroy_key;	// Συναρτήσεις που καλούνται όταν διαγράφουμε έναν κόμβο απο το map.
 	DestroyFunc destroy_value;
 };
 
 
+// Bitmap με ένα bit για κάθε θέση ενός πίνακα (το bit pos % 64 της λέξης pos / 64), που είναι 1 για τις
+// OCCUPIED θέσεις. Η διάσχιση και η map_destroy διαβάζουν 64 θέσεις με κάθε λέξη του bitmap, αντί για
+// τους ίδιους τους κόμβους, οπότε σε αραιούς πίνακες το κόστος τους εξαρτάται από τα στοιχεία και όχι τη χωρητικότητα.
+static uint64_t* bitmap_create(size_t capacity) {
+	return calloc((capacity + 63) / 64, sizeof(uint64_t));
+}
+
+static inline void bitmap_set(uint64_t* bitmap, size_t pos) {
+	bitmap[pos / 64] |= 1ull << (pos % 64);
+}
+
+static inline void bitmap_clear(uint64_t* bitmap, size_t pos) {
+	bitmap[pos / 64] &= ~(1ull << (pos % 64));
+}
+
+// Η πρώτη θέση >= start με bit 1 στο bitmap ενός πίνακα capacity θέσεων, ή capacity αν δεν υπάρχει
+static size_t bitmap_next(const uint64_t* bitmap, size_t capacity, size_t start) {
+	if (start >= capacity)
+		return capacity;
+
+	size_t word = start / 64, words = (capacity + 63) / 64;
+	uint64_t bits = bitmap[word] & (~0ull << (start % 64));		// αγνοούμε τις θέσεις πριν από την start
+	while (bits == 0) {
+		if (++word == words)
+			return capacity;
+		bits = bitmap[word];
+	}
+	return word * 64 + __builtin_ctzll(bits);
+}
+
+
+// Δεσμεύει ένα κενό array και έναν πίνακα από (NULL) αλυσίδες χωρητικότητας capacity.
+// Το calloc δίνει απευθείας state == EMPTY (0) και NULL αλυσίδες, ώστε το rehash να μη διατρέχει τους νέους πίνακες.
+static void allocate_arrays(Map map, size_t capacity) {
+	map->capacity = capacity;
+	map->array = calloc(capacity, sizeof(struct map_node));
+	map->chains = calloc(capacity, sizeof(Chain));
+	map->occupied = bitmap_create(capacity);
+}
+
 Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value) {
 	// Δεσμεύουμε κατάλληλα τον χώρο που χρειαζόμαστε για το hash table
 	Map map = malloc(sizeof(*map));
-	map->capacity = prime_sizes[0];
-	map->array = malloc(map->capacity * sizeof(struct map_node));
-	map->chains = malloc(map->capacity * sizeof(Vector));
-
-	// Αρχικοποιούμε τους κόμβους που έχουμε σαν διαθέσιμους.
-	for (int i = 0; i < map->capacity; i++){
-		map->array[i].state = EMPTY;
-		map->chains[i] = NULL;
-	}	
+	allocate_arrays(map, prime_sizes[0]);
+
 	map->size = 0;
+	map->old_array = NULL;
+	map->old_chains = NULL;
+	map->old_capacity = 0;
+	map->migrated = 0;
+	map->slabs = NULL;
+	map->free_chains = NULL;
+	map->cursor.node = NULL;
+	map->reserved = 0;
+	map->rehashes = 0;
+	map->capacity_policy = MAP_CAPACITY_PRIME;
 	map->compare = compare;
+	map->hash_function = NULL;
+	map->hash_function64 = NULL;
 	map->destroy_key = destroy_key;
 	map->destroy_value = destroy_value;
 
 	return map;
 }
 
+Map map_create_sized(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value, size_t expected) {
+	Map map = map_create(compare, destroy_key, destroy_value);
+	map_reserve(map, expected);
+	return map;
+}
+
 // Επιστρέφει τον αριθμό των entries του map σε μία χρονική στιγμή.
 int map_size(Map map) {
 	return map->size;
 }
 
-// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ.
-static void rehash(Map map) {
-	// Αποθήκευση των παλιών δεδομένων
-	int old_capacity = map->capacity;
-	MapNode old_array = map->array;
-	Vector *old_vector = map->chains;
-
-	// Βρίσκουμε τη νέα χωρητικότητα, διασχίζοντας τη λίστα των πρώτων ώστε να βρούμε τον επόμενο. 
-	int prime_no = sizeof(prime_sizes) / sizeof(int);	// το μέγεθος του πίνακα
-	for (int i = 0; i < prime_no; i++) {					// LCOV_EXCL_LINE
-		if (prime_sizes[i] > old_capacity) {
-			map->capacity = prime_sizes[i]; 
-			break;
+size_t map_size64(Map map) {
+	return map->size;
+}
+
+// Το hash code του key, από όποια από τις δύο συναρτήσεις κατακερματισμού έχει οριστεί (τα HASH_BITS bits του)
+static inline uint64_t hash_of(Map map, Pointer key) {
+	uint64_t hash = map->hash_function64 != NULL ? map->hash_function64(key) : map->hash_function(key);
+	return hash & ((1ull << HASH_BITS) - 1);
+}
+
+// Η θέση που κάνει hash ένα key σε πίνακα capacity θέσεων. Οι χωρητικότητες της MAP_CAPACITY_POW2 είναι οι
+// μόνες δυνάμεις του 2, και για αυτές παίρνουμε τα υψηλότερα bits του hash * 2^64/φ (Fibonacci hashing).
+// Διαφορετικά, η διαίρεση των 64 bits είναι αρκετά πιο αργή από αυτή των 32 bits, οπότε για πίνακες κάτω
+// από 2^32 θέσεις "διπλώνουμε" πρώτα το hash code σε 32 bits (τα hash codes των 32 bits δεν αλλάζουν).
+static inline size_t home_pos(uint64_t hash, size_t capacity) {
+	if ((capacity & (capacity - 1)) == 0)
+		return (hash * 0x9E3779B97F4A7C15ull) >> (64 - __builtin_ctzll(capacity));
+	if (capacity <= UINT32_MAX)
+		return (uint32_t)(hash ^ hash >> 32) % (uint32_t)capacity;
+	return hash % capacity;
+}
+
+// Για pos < 2 * capacity, η θέση pos "γυρνώντας" στην αρχή του πίνακα (χωρίς διαίρεση)
+static inline size_t wrap(size_t pos, size_t capacity) {
+	return pos < capacity ? pos : pos - capacity;
+}
+
+// Επιστρέφει ένα άδειο block από τη free list, δεσμεύοντας νέο slab μόνο αν αυτή είναι άδεια
+static Chain allocate_chain(Map map) {
+	if (map->free_chains == NULL) {
+		Slab slab = aligned_alloc(_Alignof(struct slab), sizeof(struct slab));
+		slab->next = map->slabs;
+		map->slabs = slab;
+
+		// Όλα τα blocks του νέου slab μπαίνουν στη free list
+		for (int i = 0; i < SLAB_CHAINS; i++) {
+			slab->chains[i].next = map->free_chains;
+			map->free_chains = &slab->chains[i];
 		}
 	}
-	// Αν έχουμε εξαντλήσει όλους τους πρώτους, διπλασιάζουμε
-	if (map->capacity == old_capacity)					// LCOV_EXCL_LINE
-		map->capacity *= 2;								// LCOV_EXCL_LINE
-
-	// Δημιουργούμε ένα μεγαλύτερο hash table και ένα μεγαλύτερο πίνακα από vector
-	map->array = malloc(map->capacity * sizeof(struct map_node));
-	map->chains = malloc(map->capacity * sizeof(Vector));
-	for (int i = 0; i < map->capacity; i++){
-		map->array[i].state = EMPTY;
-		map->chains[i] = NULL;
-	}
-	
-	// Τοποθετούμε ΜΟΝΟ τα entries που όντως περιέχουν ένα στοιχείο
-	map->size = 0;
-	for (int i = 0; i < old_capacity; i++){		// Διατρέχουμε το παλιό array και εισάγουμε τα στοιχεία στο νέο
-		if (old_array[i].state == OCCUPIED){
-			map_insert(map, old_array[i].key, old_array[i].value);
+
+	Chain chain = map->free_chains;
+	map->free_chains = chain->next;
+
+	for (int i = 0; i < CHAIN_NODES; i++)
+		chain->nodes[i].state = EMPTY;
+	chain->next = NULL;
+	return chain;
+}
+
+// Επιστρέφει ένα block στη free list (η μνήμη του αποδεσμεύεται μαζί με το slab του)
+static void free_chain(Map map, Chain chain) {
+	chain->next = map->free_chains;
+	map->free_chains = chain;
+}
+
+// Αποδεσμεύει τα slabs που δεν έχουν κανένα block σε αλυσίδα, και ξαναφτιάχνει τη free list από τα ελεύθερα
+// blocks των υπόλοιπων. Τα blocks των αλυσίδων έχουν πάντα κάποιον OCCUPIED κόμβο, οπότε μαρκάρουμε πρώτα
+// όλους τους κόμβους των blocks της free list ως EMPTY. Καλείται μόνο όταν δεν υπάρχει rehash σε εξέλιξη.
+static void release_slabs(Map map) {
+	for (Chain chain = map->free_chains; chain != NULL; chain = chain->next)
+		for (int i = 0; i < CHAIN_NODES; i++)
+			chain->nodes[i].state = EMPTY;
+	map->free_chains = NULL;
+
+	for (Slab* link = &map->slabs; *link != NULL; ) {
+		Slab slab = *link;
+		bool used[SLAB_CHAINS];
+		bool slab_used = false;
+		for (int c = 0; c < SLAB_CHAINS; c++) {
+			used[c] = false;
+			for (int i = 0; i < CHAIN_NODES; i++)
+				if (slab->chains[c].nodes[i].state == OCCUPIED)
+					used[c] = true;
+			slab_used = slab_used || used[c];
 		}
-		if(old_vector[i] != NULL){				// Αν στην αντίστοιχη θέση υπάρχει vector
-			Vector vector = old_vector[i];
-			for(int j=0 ; j<vector_size(vector); j++){	
-				MapNode node = (MapNode)vector_get_at(vector, j);
-				map_insert(map, node->key, node->value);		// Εισάγουμε τα στοιχεία του vector
-				free(node);										// Διαγράφουμε τον κ΄όμβο
-			}
-			vector_destroy(old_vector[i]);	// Διαγράφουμε το vector
+
+		if (!slab_used) {
+			*link = slab->next;
+			free(slab);
+			continue;
 		}
+		for (int c = 0; c < SLAB_CHAINS; c++)
+			if (!used[c])
+				free_chain(map, &slab->chains[c]);
+		link = &slab->next;
 	}
-
-	//Αποδεσμεύουμε τον παλιό πίνακα ώστε να μήν έχουμε leaks
-	free (old_vector);
-	free(old_array);
 }
 
-// Βοηθητική συνάρτηση για εισαγωγή στον πίνακα από vector του ζευγαριού (key, item)
-void insert_at_vector(Map map, Pointer key, Pointer value){
-	
-	uint pos = map->hash_function(key) % map->capacity;	 // Βρίσκουμε τη θέση που χασάρει το key 
-	bool already_in_vector = false;
-	MapNode new_node = malloc(sizeof(MapNode));			// Φτιάχνουμε τον κόμβο που θα εισάγουμε
+// Βοηθητική συνάρτηση για εισαγωγή στην αλυσίδα της θέσης pos του ζευγαριού (key, item), στον πρώτο
+// ελεύθερο κόμβο της ή σε νέο block στο τέλος της. Το key σίγουρα δεν υπάρχει ήδη στο map.
+void insert_at_chain(Map map, size_t pos, Pointer key, Pointer value, uint64_t hash){
+	MapNode new_node = NULL;
+	Chain* link = &map->chains[pos];
+	for (; *link != NULL && new_node == NULL; link = &(*link)->next)
+		for (int i = 0; i < CHAIN_NODES && new_node == NULL; i++)
+			if ((*link)->nodes[i].state == EMPTY)
+				new_node = &(*link)->nodes[i];
+
+	if (new_node == NULL) {								// Η αλυσίδα είναι γεμάτη (ή δεν υπάρχει), προσθέτουμε ένα block
+		*link = allocate_chain(map);
+		new_node = &(*link)->nodes[0];
+	}
+
 	new_node->key = key;
 	new_node->value = value;
+	new_node->hash = hash;
 	new_node->state = OCCUPIED;
-	
-	if(map->chains[pos] == NULL){						// Αν δεν θπάρχει vector στη θέση pos δημιουργούμε ένα
-		map->chains[pos] = vector_create(0, NULL);
+}
+
+// Τοποθετεί στο hash table ένα key που σίγουρα δεν υπάρχει ήδη: σε κενό γειτονικό κόμβο του array
+// αν υπάρχει, διαφορετικά στην αλυσίδα της θέσης που κάνει hash.
+static void place(Map map, Pointer key, Pointer value, uint64_t hash) {
+	size_t hash_pos = home_pos(hash, map->capacity);		// Βρίσκουμε τη θέση που χασάρει το key
+	size_t pos = hash_pos;
+	for (int i = 0;	i<= NEIGHBOURS;	i++) {					// Ψάχνουμε αν υπάρχει κενός γειτονικός κόμβος
+		if(map->array[pos].state == EMPTY){
+			map->array[pos].state = OCCUPIED;
+			map->array[pos].key = key;
+			map->array[pos].value = value;
+			map->array[pos].hash = hash;
+			bitmap_set(map->occupied, pos);
+			return;
+		}
+		pos = wrap(pos + 1, map->capacity);		// linear probing, γυρνώντας στην αρχή όταν φτάσουμε στη τέλος του πίνακα
 	}
-	Vector vector = map->chains[pos];
-	
-	MapNode node = NULL;
-	for(int i=0 ; i < vector_size(vector) ; i++){		// Διατρέχουμε το vector
-		MapNode cur_node = (MapNode)vector_get_at(vector, i);
-		if(cur_node != NULL){
-			if (map->compare(cur_node->key, key) == 0) {	// Αν υπάρχει ήδη το στοιχείο με το key
-				already_in_vector = true;
-				node = cur_node;					// βρήκαμε το key, το ζευγάρι θα μπει αναγκαστικά εδώ (ακόμα και αν είχαμε προηγουμένως βρει DELETED θέση)
-				break;											// και δε χρειάζεται να συνεχίζουμε την αναζήτηση.
-			}
+
+	// Το ζευγάρι (key , value) μπαίνει στην αλυσίδα
+	insert_at_chain(map, hash_pos, key, value, hash);
+}
+
+// Μεταφέρει έως count θέσεις του old_array (και τις αντίστοιχες αλυσίδες) στο array (αν υπάρχει rehash σε εξέλιξη)
+static void migrate(Map map, size_t count) {
+	if (map->old_array == NULL)
+		return;
+
+	for (; count > 0 && map->migrated < map->old_capacity; count--, map->migrated++) {
+		size_t i = map->migrated;
+		if (map->old_array[i].state == OCCUPIED) {
+			place(map, map->old_array[i].key, map->old_array[i].value, map->old_array[i].hash);
+			map->old_array[i].state = EMPTY;
+			bitmap_clear(map->old_occupied, i);
+		}
+		while (map->old_chains[i] != NULL) {		// Αν στην αντίστοιχη θέση υπάρχει αλυσίδα
+			// Επιστρέφουμε πρώτα το block στη free list, ώστε αν τα στοιχεία του καταλήξουν
+			// πάλι σε αλυσίδα η place να ξαναχρησιμοποιήσει το ίδιο block
+			Chain chain = map->old_chains[i];
+			struct map_node entries[CHAIN_NODES];
+			for (int j = 0; j < CHAIN_NODES; j++)
+				entries[j] = chain->nodes[j];
+			map->old_chains[i] = chain->next;
+			free_chain(map, chain);
+
+			for (int j = 0; j < CHAIN_NODES; j++)		// Εισάγουμε τα στοιχεία του block (χωρίς να ξανακαλέσουμε την hash_function)
+				if (entries[j].state == OCCUPIED)
+					place(map, entries[j].key, entries[j].value, entries[j].hash);
 		}
 	}
 
-	// Σε αυτό το σημείο, το node είναι ο κόμβος στον οποίο θα γίνει εισαγωγή.
-	if (already_in_vector) {
-		// Αν αντικαθιστούμε παλιά key/value, τa κάνουμε destropy
-		if (node->key != key && map->destroy_key != NULL)
-			map->destroy_key(node->key);
+	// Ολοκληρώθηκε η μεταφορά, αποδεσμεύουμε τον παλιό πίνακα ώστε να μήν έχουμε leaks
+	if (map->migrated == map->old_capacity) {
+		free(map->old_chains);
+		free(map->old_array);
+		free(map->old_occupied);
+		map->old_array = NULL;
+		map->old_chains = NULL;
 
-		if (node->value != value && map->destroy_value != NULL)
-			map->destroy_value(node->value);
+		// Μετά από rehash που δε μεγάλωσε τον πίνακα (map_compact ή shrink), πολλά blocks έχουν μείνει ελεύθερα
+		if (map->old_capacity >= map->capacity)
+			release_slabs(map);
+	}
+}
 
-		node->key = key;
-		node->value = value;
-		free(new_node); 	// Αν υπάρχει ήδη το στοιχείο με key τότε το new_node που δημιουργήσαμε είναι περιττό
-	
+// Η χωρητικότητα που ακολουθεί την capacity: ο επόμενος πρώτος της λίστας, ή το διπλάσιο για τη MAP_CAPACITY_POW2
+static size_t next_capacity(Map map, size_t capacity) {
+	if (map->capacity_policy == MAP_CAPACITY_POW2)
+		return capacity * 2;
+
+	// Διασχίζουμε τη λίστα των πρώτων ώστε να βρούμε τον επόμενο.
+	size_t prime_no = sizeof(prime_sizes) / sizeof(prime_sizes[0]);	// το μέγεθος του πίνακα
+	for (size_t i = 0; i < prime_no; i++)					// LCOV_EXCL_LINE
+		if (prime_sizes[i] > capacity)
+			return prime_sizes[i];
+
+	// Αν έχουμε εξαντλήσει όλους τους πρώτους, διπλασιάζουμε
+	return capacity * 2;								// LCOV_EXCL_LINE
+}
+
+// Η μικρότερη χωρητικότητα (της πολιτικής του map) στην οποία χωράνε n στοιχεία χωρίς rehash
+static size_t capacity_for(Map map, size_t n) {
+	size_t capacity = map->capacity_policy == MAP_CAPACITY_POW2 ? POW2_MIN_CAPACITY : prime_sizes[0];
+	while ((float)n / capacity > MAX_LOAD_FACTOR)
+		capacity = next_capacity(map, capacity);
+	return capacity;
+}
+
+// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ.
+// Δημιουργεί τον νέο πίνακα new_capacity θέσεων, και η μεταφορά των στοιχείων γίνεται σταδιακά από τη migrate.
+static void rehash(Map map, size_t new_capacity) {
+	map->cursor.node = NULL;		// οι κόμβοι θα μετακινηθούν
+
+	// Αν δεν έχει ολοκληρωθεί το προηγούμενο rehash, μεταφέρουμε πρώτα ό,τι έχει απομείνει
+	migrate(map, map->old_capacity);
+
+	// Ο τρέχων πίνακας γίνεται ο παλιός
+	map->old_array = map->array;
+	map->old_chains = map->chains;
+	map->old_occupied = map->occupied;
+	map->old_capacity = map->capacity;
+	map->migrated = 0;
+	map->rehashes++;
+
+	// Δημιουργούμε ένα μεγαλύτερο hash table και ένα μεγαλύτερο πίνακα από αλυσίδες
+	allocate_arrays(map, new_capacity);
+
+	migrate(map, REHASH_STEP > 0 ? REHASH_STEP : map->old_capacity);
+}
+
+// Μεγαλώνει τον πίνακα (αν χρειάζεται) ώστε να χωράει n στοιχεία
+static void reserve(Map map, size_t n) {
+	size_t capacity = capacity_for(map, n);
+	if (capacity <= map->capacity)
+		return;
+
+	// Μεταφέρουμε αμέσως όλα τα στοιχεία, ώστε οι επόμενες εισαγωγές να μην πληρώνουν τη μεταφορά
+	rehash(map, capacity);
+	migrate(map, map->old_capacity);
+}
+
+// Ο χώρος της map_reserve διατηρείται και όταν ο πίνακας μικραίνει (βλέπε shrink)
+void map_reserve(Map map, size_t n) {
+	if (n > map->reserved)
+		map->reserved = n;
+	reserve(map, n);
+}
+
+// Μικραίνει τον πίνακα αν ο load factor έπεσε κάτω από MIN_LOAD_FACTOR. Όπως και στη μεγέθυνση, τα στοιχεία
+// μεταφέρονται σταδιακά στον νέο πίνακα από τη migrate, η οποία στο τέλος αποδεσμεύει και τα άδεια slabs.
+static void shrink(Map map) {
+	if (map->size >= map->capacity * MIN_LOAD_FACTOR)
+		return;
+
+	size_t n = 2 * map->size > map->reserved ? 2 * map->size : map->reserved;
+	size_t capacity = capacity_for(map, n);
+	if (capacity < map->capacity)
+		rehash(map, capacity);
+}
+
+void map_compact(Map map) {
+	// Ο νέος πίνακας δημιουργείται ακόμα και αν η χωρητικότητα δεν αλλάζει, ώστε τα στοιχεία των αλυσίδων
+	// να ξαναμπούν (όσο χωράνε) στις γειτονιές τους. Τα στοιχεία μεταφέρονται αμέσως.
+	map->reserved = 0;
+	rehash(map, capacity_for(map, map->size));
+	migrate(map, map->old_capacity);
+}
+
+// Βοηθητική συνάρτηση που βρίσκει(αν υπάρχει) το κλειδί με τιμή key στις αλυσίδες chains
+MapNode search_at_chain(Map map, Chain* chains, size_t capacity, Pointer key, uint64_t hash) {
+	// Διατρέχουμε την αλυσίδα της θέσης που χασάρει το key
+	for (Chain chain = chains[home_pos(hash, capacity)]; chain != NULL; chain = chain->next) {
+		for (int i = 0; i < CHAIN_NODES; i++) {
+			MapNode node = &chain->nodes[i];
+			if (node->state == OCCUPIED && node->hash == hash && map->compare(node->key, key) == 0)		// Αν βρέθει ο κόμβος με το ζευγάρι (key,value)
+				return node;								// Τον επιστρέφουμε
+		}
 	}
-	else{
-		// Νέο στοιχείο, αυξάνουμε τα συνολικά στοιχεία του map
-		vector_insert_last(vector, new_node);
-		map->size++;
+	return MAP_EOF;
+}
+
+// Αναζήτηση του key σε έναν από τους δύο πίνακες (array/chains ή old_array/old_chains)
+static MapNode find_in(Map map, MapNode array, Chain* chains, size_t capacity, Pointer key, uint64_t hash) {
+	size_t pos = home_pos(hash, capacity);
+	for (int i = 0;	i<= NEIGHBOURS;	i++) {	// Ψάχνουμε αν το κλειδί key βρίσκεται σε γειτονικό κόμβο η στη θέση pos
+
+		// Μόνο σε OCCUPIED θέσεις, ελέγχουμε αν το key είναι εδώ (η compare καλείται μόνο για ίδιο hash code)
+		if (array[pos].state == OCCUPIED && array[pos].hash == hash && map->compare(array[pos].key, key) == 0){
+			return &array[pos];
+		}
+		pos = wrap(pos + 1, capacity);
 	}
+	// Διαφορετικά δεν υπαρχει στο array και ψάχνουμε αν υπάρχει στην αλυσίδα
+	return search_at_chain(map, chains, capacity, key, hash);
+}
+
+// Όπως η find_in, αλλά σε όποιον πίνακα βρίσκεται το key
+static MapNode find_node(Map map, Pointer key, uint64_t hash) {
+	MapNode node = find_in(map, map->array, map->chains, map->capacity, key, hash);
+
+	// Όσο διαρκεί ένα rehash, το key μπορεί να μην έχει μεταφερθεί ακόμα
+	if (node == MAP_EOF && map->old_array != NULL)
+		node = find_in(map, map->old_array, map->old_chains, map->old_capacity, key, hash);
+
+	return node;
+}
+
+// Η map_find_or_insert για key με ήδη υπολογισμένο hash code: επιστρέφει τον κόμβο του key, ή αν δεν
+// υπάρχει το τοποθετεί με τιμή NULL. Η αναζήτηση στη γειτονιά και στην αλυσίδα σημειώνει τον πρώτο κενό
+// κόμβο (με την ίδια σειρά που τον επιλέγει η place), οπότε η εισαγωγή γίνεται χωρίς δεύτερη διάσχιση.
+static MapNode find_or_insert_hashed(Map map, Pointer key, uint64_t hash, bool* inserted) {
+	map->cursor.node = NULL;		// η θέση της τελευταίας διάσχισης δεν ισχύει πλέον
+	*inserted = false;
+
+	size_t hash_pos = home_pos(hash, map->capacity);
+	MapNode free_node = NULL;
+	size_t free_pos = map->capacity;						// η θέση του free_node στο array (capacity αν είναι σε αλυσίδα)
+	size_t pos = hash_pos;
+	for (int i = 0; i <= NEIGHBOURS; i++) {
+		MapNode node = &map->array[pos];
+		if (node->state == OCCUPIED) {
+			if (node->hash == hash && map->compare(node->key, key) == 0)
+				return node;
+		} else if (free_node == NULL) {
+			free_node = node;
+			free_pos = pos;
+		}
+		pos = wrap(pos + 1, map->capacity);
+	}
+
+	// Στο τέλος της διάσχισης το link δείχνει στο (NULL) next του τελευταίου block της αλυσίδας
+	Chain* link = &map->chains[hash_pos];
+	for (; *link != NULL; link = &(*link)->next) {
+		for (int i = 0; i < CHAIN_NODES; i++) {
+			MapNode node = &(*link)->nodes[i];
+			if (node->state == OCCUPIED) {
+				if (node->hash == hash && map->compare(node->key, key) == 0)
+					return node;
+			} else if (free_node == NULL) {
+				free_node = node;
+			}
+		}
+	}
+
+	// Όσο διαρκεί ένα rehash, το key μπορεί να μην έχει μεταφερθεί ακόμα
+	if (map->old_array != NULL) {
+		MapNode old_node = find_in(map, map->old_array, map->old_chains, map->old_capacity, key, hash);
+		if (old_node != MAP_EOF)
+			return old_node;
+	}
+
+	// Νέο στοιχείο, στον κενό κόμβο που βρήκαμε ή σε νέο block στο τέλος της αλυσίδας
+	if (free_node == NULL) {
+		*link = allocate_chain(map);
+		free_node = &(*link)->nodes[0];
+	}
+	free_node->key = key;
+	free_node->value = NULL;
+	free_node->hash = hash;
+	free_node->state = OCCUPIED;
+	if (free_pos < map->capacity)
+		bitmap_set(map->occupied, free_pos);
+	map->size++;
+	*inserted = true;
+
 	// Αν με την νέα εισαγωγή ξεπερνάμε το μέγιστο load factor, πρέπει να κάνουμε rehash.
-	// Στο load factor μετράμε και τα DELETED, γιατί και αυτά επηρρεάζουν τις αναζητήσεις.
+	// Το rehash μπορεί να μεταφέρει τον κόμβο, οπότε τον ξαναβρίσκουμε.
 	float load_factor = (float)(map->size) / map->capacity;
-	if (load_factor > MAX_LOAD_FACTOR)
-		rehash(map);
+	if (load_factor > MAX_LOAD_FACTOR) {
+		rehash(map, next_capacity(map, map->capacity));
+		free_node = find_node(map, key, hash);
+	}
+	return free_node;
 }
 
-
 // Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει,
-// ανανέωση του με ένα νέο value, και η συνάρτηση επιστρέφει true.
-void map_insert(Map map, Pointer key, Pointer value) {
-	// Σκανάρουμε το Hash Table μέχρι να βρούμε διαθέσιμη θέση για να τοποθετήσουμε το ζευγάρι,
-	// ή μέχρι να βρούμε το κλειδί ώστε να το αντικαταστήσουμε.
-	MapNode node = map_find_node(map, key);
-	if(node != MAP_EOF){
+// ανανέωση του με ένα νέο value.
+// Η map_insert για key με ήδη υπολογισμένο hash code
+static void insert_hashed(Map map, Pointer key, Pointer value, uint64_t hash) {
+	bool inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash, &inserted);
+	if (!inserted) {
 		if (node->key != key && map->destroy_key != NULL)
 			map->destroy_key(node->key);
 
 		if (node->value != value && map->destroy_value != NULL)
 			map->destroy_value(node->value);
 
-		// Προσθήκη τιμών στον κόμβο
 		node->key = key;
-		node->value = value;
-		return;
 	}
-	uint pos = map->hash_function(key) % map->capacity;		// Βρίσκουμε τη θέση που χασάρει το key
-	bool in_vector = true;
-	for (int i = 0;	i<= NEIGHBOURS;	i++) {					// Ψάχνουμε αν υπάρχει κενός γειτονικός κόμβος			
-		
-		if(map->array[pos].state == EMPTY){					
-			in_vector = false;
-			break;
+	node->value = value;
+}
+
+void map_insert(Map map, Pointer key, Pointer value) {
+	// Κάθε εισαγωγή προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
+
+	// Το hash code του key υπολογίζεται μόνο εδώ, στη συνέχεια αποθηκεύεται στον κόμβο
+	insert_hashed(map, key, value, hash_of(map, key));
+}
+
+// Η map_insert_batch υπολογίζει τα hash codes σε ομάδες των BATCH_SIZE keys, και φορτώνει στην cache
+// τη θέση κάθε key PREFETCH_DISTANCE εισαγωγές πριν από αυτή, ώστε οι αναμονές για τη μνήμη να επικαλύπτονται.
+#define BATCH_SIZE 64
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 8
+#endif
+
+// Φορτώνει στην cache (χωρίς να περιμένει) τον κόμβο από τον οποίο ξεκινάει η αναζήτηση του hash και την αλυσίδα του
+static inline void prefetch(Map map, uint64_t hash) {
+	size_t pos = home_pos(hash, map->capacity);
+	__builtin_prefetch(&map->array[pos], 1);
+	__builtin_prefetch(&map->chains[pos]);
+}
+
+void map_insert_batch(Map map, Pointer* keys, Pointer* values, size_t n) {
+	// Δεσμεύουμε μία φορά χώρο για όλα τα στοιχεία (αν κάποια keys υπάρχουν ήδη, απλά περισσεύει χώρος)
+	reserve(map, map->size + n);
+
+	uint64_t hashes[BATCH_SIZE];
+	for (size_t start = 0; start < n; start += BATCH_SIZE) {
+		size_t count = n - start < BATCH_SIZE ? n - start : BATCH_SIZE;
+		for (size_t i = 0; i < count; i++) {
+			hashes[i] = hash_of(map, keys[start + i]);
+			if (i < PREFETCH_DISTANCE)
+				prefetch(map, hashes[i]);
 		}
 
-		pos = (pos + 1) % map->capacity;		// linear probing, γυρνώντας στην αρχή όταν φτάσουμε στη τέλος του πίνακα
-	}
-	
-	if(in_vector){								//Αν το ζευγάρι (key , value) μπαίνει στο vector
-		insert_at_vector(map, key, value);		// Κα΄λούμε τη βοηθητικη συνάρτηση για να το κάνει
-		return;
+		for (size_t i = 0; i < count; i++) {
+			if (i + PREFETCH_DISTANCE < count)
+				prefetch(map, hashes[i + PREFETCH_DISTANCE]);
+
+			migrate(map, REHASH_STEP);
+			insert_hashed(map, keys[start + i], values != NULL ? values[start + i] : NULL, hashes[i]);
+		}
 	}
-	// Διαφορετικά σημαίνει πως βρέθηκε κενός γειτονικός κόμβος
-	node = &map->array[pos];
-	map->size++;
-	// Προσθήκη τιμών στον κόμβο
-	node->state = OCCUPIED;
-	node->key = key;
-	node->value = value;
+}
 
-	// Αν με την νέα εισαγωγή ξεπερνάμε το μέγιστο load factor, πρέπει να κάνουμε rehash.
-	// Στο load factor μετράμε και τα DELETED, γιατί και αυτά επηρρεάζουν τις αναζητήσεις.
-	float load_factor = (float)(map->size) / map->capacity;
-	if (load_factor > MAX_LOAD_FACTOR)
-		rehash(map);
-}
-
-
-// Βοηθητική συνάρτηση για διαργραφή απο τον πίνακα με τα vector του κλειδιού με τιμή key
-bool remove_from_vector(Map map, Pointer key) {
-	
-	uint pos = map->hash_function(key) % map->capacity;		// Βρίσκουμε τη θέση που χασάρει το key
-	Vector vector = map->chains[pos];
-	if(vector!=NULL){										// Αν υπάρχει το vector
-		for(int i=0 ; i < vector_size(vector) ; i++){		// Διατρέχουμε το vector
-			MapNode node = (MapNode)vector_get_at(vector, i);
-			if(node != NULL){
-				if (map->compare(node->key, key) == 0) {	// Αν βρέθει ο κόμβος με το ζευγάρι (key,value) που θα αφαιρέσουμε
-					// destroy
-					if (map->destroy_key != NULL)
-						map->destroy_key(node->key);
-					if (map->destroy_value != NULL)
-						map->destroy_value(node->value);
-					// Τον κάνουμε swap με τον τελευταίο κόμβο και τον αφαιρούμε από το vector
-					MapNode last_node = (MapNode)vector_get_at(vector, vector_size(vector)-1);
-					vector_set_at(vector, i, last_node);
-					vector_remove_last(vector);
-					map->size--;							// Μειώνουμε το μέγεθος του πίνακα
-					return true;			
+
+// Βοηθητική συνάρτηση για διαργραφή απο τις αλυσίδες chains του κλειδιού με τιμή key
+bool remove_from_chain(Map map, Chain* chains, size_t capacity, Pointer key, uint64_t hash) {
+	// Διατρέχουμε την αλυσίδα της θέσης που χασάρει το key, κρατώντας τον δείκτη (link) προς το τρέχον block
+	for (Chain* link = &chains[home_pos(hash, capacity)]; *link != NULL; link = &(*link)->next) {
+		Chain chain = *link;
+		for (int i = 0; i < CHAIN_NODES; i++) {
+			MapNode node = &chain->nodes[i];
+			if (node->state == OCCUPIED && node->hash == hash && map->compare(node->key, key) == 0) {		// Αν βρέθει ο κόμβος με το ζευγάρι (key,value) που θα αφαιρέσουμε
+				// destroy
+				if (map->destroy_key != NULL)
+					map->destroy_key(node->key);
+				if (map->destroy_value != NULL)
+					map->destroy_value(node->value);
+				node->state = EMPTY;
+
+				// Οι υπόλοιποι κόμβοι δε μετακινούνται (οι MapNode τους μένουν έγκυροι), αλλά
+				// αν το block άδειασε εντελώς το αφαιρούμε από την αλυσίδα
+				bool empty = true;
+				for (int j = 0; j < CHAIN_NODES; j++)
+					if (chain->nodes[j].state == OCCUPIED)
+						empty = false;
+				if (empty) {
+					*link = chain->next;
+					free_chain(map, chain);
 				}
+				return true;
 			}
-			
 		}
 	}
 	return false;
-
 }
 
-// Διαργραφή απο το Hash Table του κλειδιού με τιμή key
-bool map_remove(Map map, Pointer key) {
-	
-	uint pos = map->hash_function(key) % map->capacity;			// Βρίσκουμε τη θέση που χασάρει το key
+// Διαγραφή του key από έναν από τους δύο πίνακες (array/chains ή old_array/old_chains)
+static bool remove_from(Map map, MapNode array, Chain* chains, uint64_t* occupied, size_t capacity, Pointer key, uint64_t hash) {
+	size_t pos = home_pos(hash, capacity);									// Βρίσκουμε τη θέση που χασάρει το key
 	for(int i = 0; i <= NEIGHBOURS; i++){						// Ψάχνουμε αν το κλειδί key βρίσκεται σε γειτονικό κόμβο η στη θέση pos
-		MapNode node = &map->array[pos];
-		if(node->state == OCCUPIED && map->compare(node->key, key) == 0) {
+		MapNode node = &array[pos];
+		if(node->state == OCCUPIED && node->hash == hash && map->compare(node->key, key) == 0) {
 			//destroy
 			if (map->destroy_key != NULL)
 				map->destroy_key(node->key);
 			if (map->destroy_value != NULL)
 				map->destroy_value(node->value);
 			node->state = EMPTY;
-			map->size--;
+			bitmap_clear(occupied, pos);
 			return true;
-			
 		}
-		pos = (pos + 1) % map->capacity;
+		pos = wrap(pos + 1, capacity);
 	}
-	//Διαφορετικά το key ή υπάρχει στο vector, οπότε καλούμε τη βοηθητική συνάρτηση για να κάνει remove, ή δεν υπάρχει
-	return remove_from_vector(map, key);
+	//Διαφορετικά το key ή υπάρχει στην αλυσίδα, οπότε καλούμε τη βοηθητική συνάρτηση για να κάνει remove, ή δεν υπάρχει
+	return remove_from_chain(map, chains, capacity, key, hash);
+}
+
+// Διαργραφή απο το Hash Table του κλειδιού με τιμή key
+bool map_remove(Map map, Pointer key) {
+	map->cursor.node = NULL;		// η θέση της τελευταίας διάσχισης δεν ισχύει πλέον
+
+	// Κάθε διαγραφή προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
+
+	uint64_t hash = hash_of(map, key);
+	bool removed = remove_from(map, map->array, map->chains, map->occupied, map->capacity, key, hash);
+	if (!removed && map->old_array != NULL)
+		removed = remove_from(map, map->old_array, map->old_chains, map->old_occupied, map->old_capacity, key, hash);
+
+	if (removed) {
+		map->size--;							// Μειώνουμε το μέγεθος του πίνακα
+		shrink(map);
+	}
+	return removed;
 }
 
 
@@ -287,8 +714,57 @@ Pointer map_find(Map map, Pointer key) {
 		return NULL;
 }
 
+// Στη map_find_batch (βλέπε ADTMap.h) το πρώτο βήμα ελέγχει τη γειτονιά της θέσης του key, και μόνο αν το key
+// δε βρεθεί εκεί ένα δεύτερο βήμα ελέγχει την αλυσίδα της.
 
+// Η κατάσταση μιας αναζήτησης της map_find_batch
+typedef struct {
+	size_t index;		// Η θέση του key στον πίνακα keys
+	uint64_t hash;
+	bool hashed;		// Έχει υπολογιστεί το hash code (στο πρώτο βήμα, αφού γίνει prefetch στο key)
+	size_t pos;			// Η θέση που κάνει hash το key (έχει ήδη γίνει prefetch στη γειτονιά και την αλυσίδα της)
+	bool chain;			// Το key δεν είναι στη γειτονιά, και έχει γίνει prefetch στο πρώτο block της αλυσίδας
+} Lookup;
 
+// Υπολογίζει το hash code του key της l και κάνει prefetch στη θέση του
+static void lookup_hash(Map map, Lookup* l, Pointer key) {
+	l->hash = hash_of(map, key);
+	l->pos = home_pos(l->hash, map->capacity);
+	l->chain = false;
+	__builtin_prefetch(&map->array[l->pos]);
+	__builtin_prefetch(&map->array[wrap(l->pos + NEIGHBOURS, map->capacity)]);
+	__builtin_prefetch(&map->chains[l->pos]);
+}
+
+#include "../ADTMapFindBatch.h"
+
+// Ένα βήμα της αναζήτησης l (σε δύο γύρους: η γειτονιά και η αλυσίδα), επιστρέφει true αν ολοκληρώθηκε
+static bool lookup_step(Map map, Lookup* l, Pointer* keys, Pointer* out_values) {
+	Pointer key = keys[l->index];
+	MapNode node = MAP_EOF;
+
+	if (!l->chain) {
+		size_t pos = l->pos;
+		for (int i = 0; i <= NEIGHBOURS; i++, pos = wrap(pos + 1, map->capacity))
+			if (map->array[pos].state == OCCUPIED && map->array[pos].hash == l->hash && map->compare(map->array[pos].key, key) == 0)
+				return lookup_finish(l, out_values, &map->array[pos]);
+
+		// Αν η θέση έχει αλυσίδα, τη διατρέχουμε στον επόμενο γύρο
+		Chain chain = map->chains[l->pos];
+		if (chain != NULL) {
+			l->chain = true;
+			__builtin_prefetch(chain);
+			return false;
+		}
+	} else {
+		node = search_at_chain(map, map->chains, map->capacity, key, l->hash);
+	}
+
+	// Όσο διαρκεί ένα rehash, το key μπορεί να μην έχει μεταφερθεί ακόμα
+	if (node == MAP_EOF && map->old_array != NULL)
+		node = find_in(map, map->old_array, map->old_chains, map->old_capacity, key, l->hash);
+	return lookup_finish(l, out_values, node);
+}
 
 DestroyFunc map_set_destroy_key(Map map, DestroyFunc destroy_key) {
 	DestroyFunc old = map->destroy_key;
@@ -302,105 +778,151 @@ DestroyFunc map_set_destroy_value(Map map, DestroyFunc destroy_value) {
 	return old;
 }
 
-// Απελευθέρωση μνήμης που δεσμεύει το map
-void map_destroy(Map map) {
-	for (int i = 0; i < map->capacity; i++) {
-		if (map->array[i].state == OCCUPIED) {		// Όταν βρούμε στοιχείο στο array διαγραφουμε το key και το value του
+// Απελευθέρωση της μνήμης ενός από τους δύο πίνακες (array/chains ή old_array/old_chains)
+static void destroy_arrays(Map map, MapNode array, Chain* chains, size_t capacity) {
+	for (size_t i = 0; i < capacity; i++) {
+		if (array[i].state == OCCUPIED) {		// Όταν βρούμε στοιχείο στο array διαγραφουμε το key και το value του
 			if (map->destroy_key != NULL)
-				map->destroy_key(map->array[i].key);
+				map->destroy_key(array[i].key);
 			if (map->destroy_value != NULL)
-				map->destroy_value(map->array[i].value);
+				map->destroy_value(array[i].value);
 		}
-		Vector vector = map->chains[i];
-		if(vector!=NULL){							// Αν υπάρχει vector
-			for(int j=0 ; j < vector_size(vector);  j++){
-				MapNode node = (MapNode)vector_get_at(vector, 0); // Διαγράφει πάντα το πρωτο στοιχείο επειδή η remove from vector κάνει swap με το τελευταίο
-				remove_from_vector(map, node->key);
+		for (Chain chain = chains[i]; chain != NULL; chain = chain->next) {		// Και το ίδιο για τους κόμβους της αλυσίδας
+			for (int j = 0; j < CHAIN_NODES; j++) {
+				MapNode node = &chain->nodes[j];
+				if (node->state != OCCUPIED)
+					continue;
+				if (map->destroy_key != NULL)
+					map->destroy_key(node->key);
+				if (map->destroy_value != NULL)
+					map->destroy_value(node->value);
 			}
-			vector_destroy(vector);					// Kαταστρέφουμε όλο το vector
 		}
-		
 	}
-	free(map->chains);
-	free(map->array);
+	// Τα blocks των αλυσίδων αποδεσμεύονται μαζί με τα slabs
+	free(chains);
+	free(array);
+}
+
+// Απελευθέρωση μνήμης που δεσμεύει το map
+void map_destroy(Map map) {
+	destroy_arrays(map, map->array, map->chains, map->capacity);
+	free(map->occupied);
+	if (map->old_array != NULL) {
+		destroy_arrays(map, map->old_array, map->old_chains, map->old_capacity);
+		free(map->old_occupied);
+	}
+
+	// Όλα τα blocks των αλυσίδων αποδεσμεύονται εδώ, ένα slab τη φορά
+	while (map->slabs != NULL) {
+		Slab next = map->slabs->next;
+		free(map->slabs);
+		map->slabs = next;
+	}
 	free(map);
 }
 
 /////////////////////// Διάσχιση του map μέσω κόμβων ///////////////////////////
+//
+// Οι κόμβοι διασχίζονται με τη σειρά: array, αλυσίδες, και όσο διαρκεί ένα rehash
+// ό,τι έχει μείνει στο old_array και στις αλυσίδες του.
 
-//Βοηθητική συνάρτηση που βρίσκει το πρώτο στοιχείο του πίνακα με τα Vector
-MapNode first_in_vector(Map map) {
-	// Είναι το πρώτο στοιχείο του πρώτου μη κενού vector που θα βρεθεί
-	for (int i = 0; i < map->capacity; i++){
-		if (map->chains[i]!=NULL && vector_size(map->chains[i]) != 0){
-			return (MapNode)vector_get_at(map->chains[i], 0);
-		}
-	}
-	// Αν δεν βρεθεί κανένα μη κενό vector τότε δεν υπάρχουν στοιχεία στον πίνακα 
-	return MAP_EOF;
+// Η θέση του κόμβου node στη διάσχιση
+static void cursor_at(Cursor* cursor, MapNode node, Region region, size_t next, Chain chain, int slot) {
+	cursor->node = node;
+	cursor->region = region;
+	cursor->next = next;
+	cursor->chain = chain;
+	cursor->slot = slot;
 }
 
-// Βρίσκει τον πρώτο κόμβο στο map
-MapNode map_first(Map map) {
-	//Ξεκινάμε την επανάληψή μας απο το 1ο στοιχείο, μέχρι να βρούμε κάτι όντως τοποθετημένο
-	for (int i = 0; i < map->capacity; i++){
-		if(map->array[i].state == OCCUPIED){
-			return &map->array[i];
-		}
-	}
-	// Αν δεν βρεθεί κανένα στοιχείο στο array τότε το πρ΄ώτο στοιχείο ,αν υπάρχει, είναι το πρώτο στοιχείο του vector
-	return first_in_vector(map);
-}
-
-
-// Βοηθητική συνάρτηση που βρίσκει το επόμενο στοιχείο στον πίνακα με τα vector
-MapNode next_in_vector(Map map, MapNode node) {
-	
-	uint pos = map->hash_function(node->key) % map->capacity;	// Βρίσκουμε τη θέση που χασάρει το key
-	Vector vector = map->chains[pos];
-	MapNode last_node = (MapNode)vector_get_at(vector, vector_size(vector) - 1);	// Ο τελευταίος κόμβος του vector
-	// Αν ο κόμβος που παίρνουμε σσν όρισμα δεν είναι ο τελευταίος του vector
-	if(map->compare(node->key, last_node->key) != 0){ 
-		for(int i=0 ; i < vector_size(vector) ; i++){	// Διατρεχουμε το vector 
-			MapNode cur_node = (MapNode)vector_get_at(vector, i);
-			if (map->compare(cur_node->key, node->key) == 0) { // Βρίσκουμε τον κόμβο
-				return vector_get_at(vector, i + 1);			// Και επιστρέφουμε τον επόμενο
+// Προχωράει τον cursor στον επόμενο κόμβο της διάσχισης, και τον επιστρέφει (ή MAP_EOF)
+static MapNode advance(Map map, Cursor* cursor) {
+	for (;;) {
+		bool old = cursor->region == IN_OLD_ARRAY || cursor->region == IN_OLD_CHAINS;
+		MapNode array = old ? map->old_array : map->array;
+		Chain* chains = old ? map->old_chains : map->chains;
+		uint64_t* occupied = old ? map->old_occupied : map->occupied;
+		size_t capacity = old ? map->old_capacity : map->capacity;
+
+		switch (cursor->region) {
+		case IN_ARRAY:
+		case IN_OLD_ARRAY:
+			// Η επόμενη OCCUPIED θέση από το bitmap, χωρίς να διαβάσουμε τις κενές θέσεις του array
+			cursor->next = bitmap_next(occupied, capacity, cursor->next);
+			if (cursor->next < capacity) {
+				cursor->node = &array[cursor->next++];
+				return cursor->node;
 			}
-		}
-	}
-	// Διαφορετικά ο επόμενος κόμβος είναι ο πρώτος του επόμενου vector που θα βρούμε
-	else{
-		for (int i = pos + 1; i < map->capacity; i++){ // Διατρέχουμε το υπόλοιπο array
-			if (map->chains[i]!=NULL && vector_size(map->chains[i]) != 0){  // Αν  βρεθεί επόμενο μη κενό vector
-				return (MapNode)vector_get_at(map->chains[i], 0);			// Επιστρέφουμε το πρώτο στοιχείο του
+
+			// Τέλος του πίνακα, συνεχίζουμε με τις αλυσίδες του
+			cursor_at(cursor, NULL, old ? IN_OLD_CHAINS : IN_CHAINS, 0, NULL, 0);
+			break;
+
+		case IN_CHAINS:
+		case IN_OLD_CHAINS:
+			// Οι υπόλοιποι κόμβοι της τρέχουσας αλυσίδας, ξεκινώντας από τον κόμβο slot του block chain
+			for (; cursor->chain != NULL; cursor->chain = cursor->chain->next, cursor->slot = 0)
+				for (; cursor->slot < CHAIN_NODES; cursor->slot++)
+					if (cursor->chain->nodes[cursor->slot].state == OCCUPIED) {
+						cursor->node = &cursor->chain->nodes[cursor->slot++];
+						return cursor->node;
+					}
+
+			// Η επόμενη αλυσίδα (οι αλυσίδες δεν έχουν άδεια blocks, οπότε έχει σίγουρα κόμβο)
+			for (; cursor->next < capacity; cursor->next++)
+				if (chains[cursor->next] != NULL)
+					break;
+			if (cursor->next < capacity) {
+				cursor->chain = chains[cursor->next++];
+				cursor->slot = 0;
+			} else if (!old && map->old_array != NULL) {
+				cursor_at(cursor, NULL, IN_OLD_ARRAY, 0, NULL, 0);
+			} else {
+				cursor_at(cursor, MAP_EOF, IN_END, 0, NULL, 0);
+				return MAP_EOF;
 			}
+			break;
+
+		case IN_END:
+			return MAP_EOF;
 		}
 	}
-	// Αν δεν βρούμε άλλο vector δεν υπάρχει επόμενο στοιχείο
-	return MAP_EOF;
 }
 
+// Βρίσκει τη θέση ενός κόμβου κάποιας από τις αλυσίδες chains. Επιστρέφει false αν δεν ανήκει σε αυτές.
+static bool find_in_chains(Cursor* cursor, Chain* chains, size_t capacity, MapNode node, Region region) {
+	size_t pos = home_pos(node->hash, capacity);	// Η θέση που χασάρει το key, από το αποθηκευμένο hash code
 
-// Βρίσκει τον επόμενο κόμβο
-MapNode map_next(Map map, MapNode node){
-	uint pos = map->hash_function(node->key) % map->capacity;	// Βρίσκουμε τη θέση που χασάρει το key του node
-	bool in_array = false;
-	for(int i = 0; i <= NEIGHBOURS; i++){		// Ψάχνουμε αν το κλειδί key βρίσκεται σε γειτονικό κόμβο ή στη θέση pos
-		if(map->compare(node->key, map->array[pos].key) == 0){
-			in_array = true;
-			break;
-		}
-		pos = (pos + 1) % map->capacity;
-	}
-	if(in_array){							// Αν το node βρίσκεται στο array
-		for (int i = pos + 1; i < map->capacity; i++){ // Διατρέχουμε το υπόλοιπο array μέχρι να βρουμε κάποιο στοιχείο
-			if(map->array[i].state == OCCUPIED){
-				return &map->array[i];	// Αν βρούμε το επιστρέφουμε
-			}
+	for (Chain chain = chains[pos]; chain != NULL; chain = chain->next)
+		if (node >= chain->nodes && node < chain->nodes + CHAIN_NODES) {
+			cursor_at(cursor, node, region, pos + 1, chain, node - chain->nodes + 1);
+			return true;
 		}
-		return first_in_vector(map); // Αν δεν βρούμε τότε το επόμενο στοιχείο είναι το πρώτο στοιχείο του πίνακα με τα vector
-	}
-	return next_in_vector(map, node);	// Αν το node δεν βρίσκεται στο array τότε βρίσκεται στο vector η δεν υπάρχει καθόλου
+	return false;
+}
+
+// Βρίσκει τον πρώτο κόμβο στο map
+MapNode map_first(Map map) {
+	cursor_at(&map->cursor, NULL, IN_ARRAY, 0, NULL, 0);
+	return advance(map, &map->cursor);
+}
+
+// Βρίσκει τον επόμενο κόμβο. Στη συνηθισμένη διάσχιση ο node είναι αυτός που επέστρεψε η προηγούμενη
+// map_first / map_next, και συνεχίζουμε σε O(1) από τη θέση του cursor. Διαφορετικά βρίσκουμε πρώτα τη θέση του node.
+MapNode map_next(Map map, MapNode node){
+	Cursor* cursor = &map->cursor;
+	if (node == cursor->node)
+		return advance(map, cursor);
+
+	if (node >= map->array && node < map->array + map->capacity)
+		cursor_at(cursor, node, IN_ARRAY, node - map->array + 1, NULL, 0);
+	else if (map->old_array != NULL && node >= map->old_array && node < map->old_array + map->old_capacity)
+		cursor_at(cursor, node, IN_OLD_ARRAY, node - map->old_array + 1, NULL, 0);
+	else if (!find_in_chains(cursor, map->chains, map->capacity, node, IN_CHAINS))
+		find_in_chains(cursor, map->old_chains, map->old_capacity, node, IN_OLD_CHAINS);
+
+	return advance(map, cursor);
 }
 
 Pointer map_node_key(Map map, MapNode node) {
@@ -411,55 +933,113 @@ Pointer map_node_value(Map map, MapNode node) {
 	return node->value;
 }
 
-// Βοηθητική συνάρτηση που βρίσκει(αν υπάρχει) το κλειδί με τιμή key στο vector
-MapNode search_at_vector(Map map, Pointer key) {
-	uint pos = map->hash_function(key) % map->capacity;		// Βρίσκουμε τη θέση που χασάρει το key
-	Vector vector = map->chains[pos];
-	if(vector != NULL){										// Αν υπάρχει το vector
-		for(int i=0 ; i < vector_size(vector) ; i++){		// Διατρέχουμε το vector
-			MapNode node = (MapNode)vector_get_at(vector, i);
-			if (map->compare(node->key, key) == 0) {		// Αν βρέθει ο κόμβος με το ζευγάρι (key,value)
-				return node;								// Τον επιστρέφουμε
-			}
-		}
-	}
-	return MAP_EOF;
+MapNode map_find_node(Map map, Pointer key) {
+	return find_node(map, key, hash_of(map, key));
 }
 
+MapNode map_find_or_insert(Map map, Pointer key, bool* inserted) {
+	// Όπως η map_insert, προχωράει το rehash που τυχόν βρίσκεται σε εξέλιξη
+	migrate(map, REHASH_STEP);
 
+	bool was_inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash_of(map, key), &was_inserted);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
 
-MapNode map_find_node(Map map, Pointer key) {
-	uint pos = 	map->hash_function(key) % map->capacity;
-	for (int i = 0;	i<= NEIGHBOURS;	i++) {	// Ψάχνουμε αν το κλειδί key βρίσκεται σε γειτονικό κόμβο η στη θέση pos
+MapNode map_find_or_insert_with(Map map, Pointer key, CreateValueFunc create_value, bool* inserted) {
+	bool was_inserted;
+	MapNode node = map_find_or_insert(map, key, &was_inserted);
+	if (was_inserted)
+		node->value = create_value(key);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
 
-		// Μόνο σε OCCUPIED θέσεις, ελέγχουμε αν το key είναι εδώ
-		if (map->array[pos].state == OCCUPIED && map->compare(map->array[pos].key, key) == 0){
-			return &map->array[pos];
-		}
-		pos = (pos + 1) % map->capacity;        
-	}
-	// Διαφορετικά δεν υπαρχει στο array και ψάχνουμε αν υπάρχει στο vector
-	return search_at_vector(map, key);
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	node->value = value;
 }
 
 // Αρχικοποίηση της συνάρτησης κατακερματισμού του συγκεκριμένου map.
 void map_set_hash_function(Map map, HashFunc func) {
 	map->hash_function = func;
+	map->hash_function64 = NULL;
+}
+
+void map_set_hash_function64(Map map, HashFunc64 func) {
+	map->hash_function64 = func;
+}
+
+void map_set_capacity_policy(Map map, MapCapacityPolicy policy) {
+	// Τα στοιχεία ενός μη κενού map θα χάνονταν μαζί με τον πίνακα
+	if (map->size != 0)
+		return;
+
+	map->capacity_policy = policy;
+
+	// Το map είναι άδειο, οπότε απλά αντικαθιστούμε τους αρχικούς πίνακες με πίνακες της νέας
+	// πολιτικής που χωράνε όσα στοιχεία και οι παλιοί (ώστε να διατηρείται ο χώρος της map_create_sized)
+	free(map->array);
+	free(map->chains);
+	free(map->occupied);
+	allocate_arrays(map, capacity_for(map, map->capacity * MAX_LOAD_FACTOR));
+}
+
+// Οι γειτονικές θέσεις (NEIGHBOURS) είναι λίγες και σταθερές, τα υπόλοιπα keys πάνε στις αλυσίδες,
+// οπότε η map_set_neighbourhood δεν αλλάζει κάτι
+void map_set_neighbourhood(Map map, int neighbourhood) {
 }
 
 
-uint hash_string(Pointer value) {
-	// djb2 hash function, απλή, γρήγορη, και σε γενικές γραμμές αποδοτική
-    uint hash = 5381;
-    for (char* s = value; *s != '\0'; s++)
-		hash = (hash << 5) + hash + *s;			// hash = (hash * 33) + *s. Το foo << 5 είναι γρηγορότερη εκδοχή του foo * 32.
-    return hash;
+#include "../ADTMapHash.h"
+
+/////////////////////// Στατιστικά ///////////////////////////
+
+// Προσθέτει την τιμή value στο ιστόγραμμα hist (οι μεγάλες τιμές μετράνε στην τελευταία θέση)
+static void histogram_add(size_t hist[], size_t value) {
+	hist[value < MAP_STATS_HISTOGRAM ? value : MAP_STATS_HISTOGRAM - 1]++;
 }
 
-uint hash_int(Pointer value) {
-	return *(int*)value;
+// Το probe length ενός στοιχείου του array είναι η απόστασή του από τη θέση που κάνει hash (<= NEIGHBOURS).
+// Τα στοιχεία μιας αλυσίδας βρίσκονται αφού εξεταστεί όλη η γειτονιά, οπότε το k-οστό (από 0) έχει NEIGHBOURS + 1 + k.
+static void add_lengths(MapStats* stats, MapNode array, Chain* chains, size_t capacity) {
+	for (size_t pos = 0; pos < capacity; pos++) {
+		if (array[pos].state == OCCUPIED) {
+			size_t home = home_pos(array[pos].hash, capacity);
+			histogram_add(stats->probe_lengths, pos >= home ? pos - home : pos - home + capacity);
+		}
+
+		size_t length = 0;
+		for (Chain chain = chains[pos]; chain != NULL; chain = chain->next)
+			for (int i = 0; i < CHAIN_NODES; i++)
+				if (chain->nodes[i].state == OCCUPIED)
+					histogram_add(stats->probe_lengths, NEIGHBOURS + 1 + length++);
+
+		histogram_add(stats->chain_lengths, length);
+	}
 }
 
-uint hash_pointer(Pointer value) {
-	return (size_t)value;				// cast σε sizt_t, που έχει το ίδιο μήκος με έναν pointer
-}
\ No newline at end of file
+void map_stats(Map map, MapStats* stats) {
+	*stats = (MapStats){
+		.size = map->size,
+		.capacity = map->capacity,
+		.load_factor = (double)map->size / map->capacity,
+		.rehashes = map->rehashes,
+		.bytes = sizeof(*map) + map->capacity * (sizeof(struct map_node) + sizeof(Chain)) + (map->capacity + 63) / 64 * sizeof(uint64_t),
+	};
+
+	add_lengths(stats, map->array, map->chains, map->capacity);
+
+	// Όσο διαρκεί ένα rehash, μετράμε και ό,τι δεν έχει μεταφερθεί ακόμα από το old_array
+	if (map->old_array != NULL) {
+		add_lengths(stats, map->old_array, map->old_chains, map->old_capacity);
+		stats->bytes += map->old_capacity * (sizeof(struct map_node) + sizeof(Chain)) + (map->old_capacity + 63) / 64 * sizeof(uint64_t);
+	}
+
+	for (Slab slab = map->slabs; slab != NULL; slab = slab->next)
+		stats->bytes += sizeof(struct slab);
+}
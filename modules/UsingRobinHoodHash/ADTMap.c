@@ -0,0 +1,585 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// Υλοποίηση του ADT Map μέσω Hash Table με open addressing
+// (Robin Hood linear probing, χωρίς DELETED κόμβους)
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ADTMap.h"
+
+
+// Σε αντίθεση με το UsingHashTable, δεν υπάρχουν DELETED κόμβοι: η διαγραφή μετακινεί τους
+// επόμενους κόμβους μία θέση πίσω (backward shift), οπότε οι κόμβοι είναι μόνο EMPTY ή OCCUPIED.
+typedef enum {
+	EMPTY, OCCUPIED
+} State;
+
+// Το μέγεθος του Hash Table ιδανικά θέλουμε να είναι πρώτος αριθμός σύμφωνα με την θεωρία.
+// Η παρακάτω λίστα περιέχει πρώτους οι οποίοι έχουν αποδεδιγμένα καλή συμπεριφορά ως μεγέθη.
+// Κάθε re-hash θα γίνεται βάσει αυτής της λίστας. Αν χρειάζονται παραπάνω απο 824633720837 στοχεία, τότε σε καθε rehash διπλασιάζουμε το μέγεθος.
+// (Κάθε πρώτος είναι ο μικρότερος μετά το 1.5 * 2^k, οπότε οι τιμές μετά το 1610612741 συνεχίζουν με τον ίδιο κανόνα.)
+size_t prime_sizes[] = {53, 97, 193, 389, 769, 1543, 3079, 6151, 12289, 24593, 49157, 98317, 196613, 393241,
+	786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741,
+	3221225473, 6442450967, 12884901893, 25769803799, 51539607599, 103079215111, 206158430209, 412316860441, 824633720837};
+
+// Με MAP_CAPACITY_POW2 η χωρητικότητα ξεκινάει από POW2_MIN_CAPACITY και διπλασιάζεται σε κάθε rehash
+#define POW2_MIN_CAPACITY 64
+
+// Το Robin Hood κρατάει τη διασπορά των αποστάσεων μικρή, οπότε ο πίνακας μπορεί να γεμίσει
+// αρκετά περισσότερο από το 0.5 του απλού linear probing. Δεν υπάρχουν DELETED, οπότε
+// ο load factor εξαρτάται μόνο από το πλήθος των στοιχείων.
+#define MAX_LOAD_FACTOR 0.85
+
+// Το κατώτερο όριο του load factor (βλέπε map_compact στο ADTMap.h). Η backward shift διαγραφή δεν αφήνει
+// DELETED θέσεις, οπότε ο load factor είναι πάντα ακριβώς size / capacity.
+#define MIN_LOAD_FACTOR 0.125
+
+// Δομή του κάθε κόμβου που έχει το hash table (με το οποίο υλοιποιούμε το map)
+struct map_node{
+	Pointer key;		// Το κλειδί που χρησιμοποιείται για να hash-αρουμε
+	Pointer value;  	// Η τιμή που αντισοιχίζεται στο παραπάνω κλειδί
+	State state;		// Μεταβλητή για να μαρκάρουμε την κατάσταση των κόμβων
+	int dist;			// Απόσταση του κόμβου από τη θέση που κάνει hash το key του (probe length)
+	uint64_t hash;		// Το hash code του key, υπολογίζεται μία φορά κατά την εισαγωγή και μετακινείται μαζί του
+};
+
+// Δομή του Map (περιέχει όλες τις πληροφορίες που χρεαζόμαστε για το HashTable)
+struct map {
+	MapNode array;				// Ο πίνακας που θα χρησιμοποιήσουμε για το map (remember, φτιάχνουμε ένα hash table)
+	size_t capacity;			// Πόσο χώρο έχουμε δεσμεύσει.
+	size_t size;				// Πόσα στοιχεία έχουμε προσθέσει
+	size_t reserved;			// Ο χώρος (σε στοιχεία) της map_reserve, κάτω από τον οποίο ο πίνακας δε μικραίνει
+	uint64_t* occupied;			// Bitmap με τις OCCUPIED θέσεις του array (βλέπε bitmap_next)
+	int rehashes;				// Πόσα rehash έχουν γίνει και πόσοι κόμβοι έχουν χάσει τη θέση τους (για τη map_stats)
+	long displacements;
+	MapCapacityPolicy capacity_policy;	// Πρώτοι αριθμοί ή δυνάμεις του 2 ως χωρητικότητες
+	CompareFunc compare;		// Συνάρτηση για σύγκριση δεικτών, που πρέπει να δίνεται απο τον χρήστη
+	HashFunc hash_function;		// Συνάρτηση για να παίρνουμε το hash code του κάθε αντικειμένου.
+	HashFunc64 hash_function64;	// Η συνάρτηση 64 bits, αν έχει οριστεί (διαφορετικά NULL και χρησιμοποιείται η hash_function)
+	DestroyFunc destroy_key;	// Συναρτήσεις που καλούνται όταν διαγράφουμε έναν κόμβο απο το map.
+	DestroyFunc destroy_value;
+};
+
+
+// Bitmap με ένα bit για κάθε θέση ενός πίνακα (το bit pos % 64 της λέξης pos / 64), που είναι 1 για τις
+// OCCUPIED θέσεις. Η διάσχιση και η map_destroy διαβάζουν 64 θέσεις με κάθε λέξη του bitmap, αντί για
+// τους ίδιους τους κόμβους, οπότε σε αραιούς πίνακες το κόστος τους εξαρτάται από τα στοιχεία και όχι τη χωρητικότητα.
+static uint64_t* bitmap_create(size_t capacity) {
+	return calloc((capacity + 63) / 64, sizeof(uint64_t));
+}
+
+static inline void bitmap_set(uint64_t* bitmap, size_t pos) {
+	bitmap[pos / 64] |= 1ull << (pos % 64);
+}
+
+static inline void bitmap_clear(uint64_t* bitmap, size_t pos) {
+	bitmap[pos / 64] &= ~(1ull << (pos % 64));
+}
+
+// Η πρώτη θέση >= start με bit 1 στο bitmap ενός πίνακα capacity θέσεων, ή capacity αν δεν υπάρχει
+static size_t bitmap_next(const uint64_t* bitmap, size_t capacity, size_t start) {
+	if (start >= capacity)
+		return capacity;
+
+	size_t word = start / 64, words = (capacity + 63) / 64;
+	uint64_t bits = bitmap[word] & (~0ull << (start % 64));		// αγνοούμε τις θέσεις πριν από την start
+	while (bits == 0) {
+		if (++word == words)
+			return capacity;
+		bits = bitmap[word];
+	}
+	return word * 64 + __builtin_ctzll(bits);
+}
+
+
+// Δεσμεύει έναν κενό πίνακα χωρητικότητας capacity και το bitmap του
+static void allocate_array(Map map, size_t capacity) {
+	map->capacity = capacity;
+	map->array = malloc(capacity * sizeof(struct map_node));
+	map->occupied = bitmap_create(capacity);
+
+	// Αρχικοποιούμε τους κόμβους που έχουμε σαν διαθέσιμους.
+	for (size_t i = 0; i < capacity; i++)
+		map->array[i].state = EMPTY;
+}
+
+Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value) {
+	// Δεσμεύουμε κατάλληλα τον χώρο που χρειαζόμαστε για το hash table
+	Map map = malloc(sizeof(*map));
+	allocate_array(map, prime_sizes[0]);
+
+	map->size = 0;
+	map->reserved = 0;
+	map->rehashes = 0;
+	map->capacity_policy = MAP_CAPACITY_PRIME;
+	map->displacements = 0;
+	map->compare = compare;
+	map->hash_function = NULL;
+	map->hash_function64 = NULL;
+	map->destroy_key = destroy_key;
+	map->destroy_value = destroy_value;
+
+	return map;
+}
+
+Map map_create_sized(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value, size_t expected) {
+	Map map = map_create(compare, destroy_key, destroy_value);
+	map_reserve(map, expected);
+	return map;
+}
+
+// Επιστρέφει τον αριθμό των entries του map σε μία χρονική στιγμή.
+int map_size(Map map) {
+	return map->size;
+}
+
+size_t map_size64(Map map) {
+	return map->size;
+}
+
+// Το hash code του key, από όποια από τις δύο συναρτήσεις κατακερματισμού έχει οριστεί
+static inline uint64_t hash_of(Map map, Pointer key) {
+	return map->hash_function64 != NULL ? map->hash_function64(key) : map->hash_function(key);
+}
+
+// Η θέση που κάνει hash ένα key σε πίνακα capacity θέσεων. Οι χωρητικότητες της MAP_CAPACITY_POW2 είναι οι
+// μόνες δυνάμεις του 2, και για αυτές παίρνουμε τα υψηλότερα bits του hash * 2^64/φ (Fibonacci hashing).
+// Διαφορετικά, η διαίρεση των 64 bits είναι αρκετά πιο αργή από αυτή των 32 bits, οπότε για πίνακες κάτω
+// από 2^32 θέσεις "διπλώνουμε" πρώτα το hash code σε 32 bits (τα hash codes των 32 bits δεν αλλάζουν).
+static inline size_t home_pos(uint64_t hash, size_t capacity) {
+	if ((capacity & (capacity - 1)) == 0)
+		return (hash * 0x9E3779B97F4A7C15ull) >> (64 - __builtin_ctzll(capacity));
+	if (capacity <= UINT32_MAX)
+		return (uint32_t)(hash ^ hash >> 32) % (uint32_t)capacity;
+	return hash % capacity;
+}
+
+// Για pos < 2 * capacity, η θέση pos "γυρνώντας" στην αρχή του πίνακα (χωρίς διαίρεση)
+static inline size_t wrap(size_t pos, size_t capacity) {
+	return pos < capacity ? pos : pos - capacity;
+}
+
+// Τοποθετεί στο hash table ένα key που σίγουρα δεν υπάρχει ήδη. Κατά τη διάσχιση, αν βρούμε κόμβο
+// που είναι πιο κοντά στη θέση του από ό,τι ο κόμβος που τοποθετούμε ("πλούσιος"), του παίρνουμε τη
+// θέση και συνεχίζουμε με την τοποθέτηση εκείνου. Έτσι όλοι οι κόμβοι μένουν κοντά στη θέση τους.
+// Η διάσχιση ξεκινάει από τη θέση pos, όπου το entry απέχει entry.dist θέσεις από τη θέση του,
+// και επιστρέφεται ο κόμβος στον οποίο τοποθετήθηκε το (αρχικό) entry.
+static MapNode place_from(Map map, struct map_node entry, size_t pos) {
+	MapNode placed = NULL;
+	for (; ; pos = wrap(pos + 1, map->capacity)) {
+		MapNode node = &map->array[pos];
+		if (node->state == EMPTY) {
+			*node = entry;
+			bitmap_set(map->occupied, pos);
+			return placed != NULL ? placed : node;
+		}
+
+		if (node->dist < entry.dist) {
+			struct map_node temp = *node;
+			*node = entry;
+			entry = temp;
+			map->displacements++;
+			if (placed == NULL)
+				placed = node;
+		}
+		entry.dist++;
+	}
+}
+
+static MapNode place(Map map, Pointer key, Pointer value, uint64_t hash) {
+	struct map_node entry = { .key = key, .value = value, .state = OCCUPIED, .dist = 0, .hash = hash };
+	return place_from(map, entry, home_pos(hash, map->capacity));
+}
+
+// Η χωρητικότητα που ακολουθεί την capacity: ο επόμενος πρώτος της λίστας, ή το διπλάσιο για τη MAP_CAPACITY_POW2
+static size_t next_capacity(Map map, size_t capacity) {
+	if (map->capacity_policy == MAP_CAPACITY_POW2)
+		return capacity * 2;
+
+	// Διασχίζουμε τη λίστα των πρώτων ώστε να βρούμε τον επόμενο.
+	size_t prime_no = sizeof(prime_sizes) / sizeof(prime_sizes[0]);	// το μέγεθος του πίνακα
+	for (size_t i = 0; i < prime_no; i++)					// LCOV_EXCL_LINE
+		if (prime_sizes[i] > capacity)
+			return prime_sizes[i];
+
+	// Αν έχουμε εξαντλήσει όλους τους πρώτους, διπλασιάζουμε
+	return capacity * 2;								// LCOV_EXCL_LINE
+}
+
+// Η μικρότερη χωρητικότητα (της πολιτικής του map) στην οποία χωράνε n στοιχεία χωρίς rehash
+static size_t capacity_for(Map map, size_t n) {
+	size_t capacity = map->capacity_policy == MAP_CAPACITY_POW2 ? POW2_MIN_CAPACITY : prime_sizes[0];
+	while ((float)n / capacity > MAX_LOAD_FACTOR)
+		capacity = next_capacity(map, capacity);
+	return capacity;
+}
+
+// Συνάρτηση για την επέκταση του Hash Table σε περίπτωση που ο load factor μεγαλώσει πολύ.
+// Τα στοιχεία μεταφέρονται σε νέο πίνακα new_capacity θέσεων.
+static void rehash(Map map, size_t new_capacity) {
+	// Αποθήκευση των παλιών δεδομένων
+	size_t old_capacity = map->capacity;
+	MapNode old_array = map->array;
+	uint64_t* old_occupied = map->occupied;
+	map->rehashes++;
+
+	// Δημιουργούμε ένα μεγαλύτερο hash table
+	allocate_array(map, new_capacity);
+
+	// Τα keys είναι σίγουρα διαφορετικά μεταξύ τους, οπότε τα τοποθετούμε χωρίς αναζήτηση
+	// (και χωρίς να ξανακαλέσουμε την hash_function, το hash code είναι αποθηκευμένο στον κόμβο)
+	for (size_t i = bitmap_next(old_occupied, old_capacity, 0); i < old_capacity; i = bitmap_next(old_occupied, old_capacity, i + 1))
+		place(map, old_array[i].key, old_array[i].value, old_array[i].hash);
+
+	//Αποδεσμεύουμε τον παλιό πίνακα ώστε να μήν έχουμε leaks
+	free(old_array);
+	free(old_occupied);
+}
+
+// Μεγαλώνει τον πίνακα (αν χρειάζεται) ώστε να χωράει n στοιχεία
+static void reserve(Map map, size_t n) {
+	size_t capacity = capacity_for(map, n);
+	if (capacity > map->capacity)
+		rehash(map, capacity);
+}
+
+// Ο χώρος της map_reserve διατηρείται και όταν ο πίνακας μικραίνει (βλέπε shrink)
+void map_reserve(Map map, size_t n) {
+	if (n > map->reserved)
+		map->reserved = n;
+	reserve(map, n);
+}
+
+// Μικραίνει τον πίνακα αν ο load factor έπεσε κάτω από MIN_LOAD_FACTOR
+static void shrink(Map map) {
+	if (map->size >= map->capacity * MIN_LOAD_FACTOR)
+		return;
+
+	size_t n = 2 * map->size > map->reserved ? 2 * map->size : map->reserved;
+	size_t capacity = capacity_for(map, n);
+	if (capacity < map->capacity)
+		rehash(map, capacity);
+}
+
+void map_compact(Map map) {
+	// Δεν υπάρχουν DELETED κόμβοι, οπότε το rehash χρειάζεται μόνο αν η χωρητικότητα μικραίνει
+	map->reserved = 0;
+	size_t capacity = capacity_for(map, map->size);
+	if (capacity < map->capacity)
+		rehash(map, capacity);
+}
+
+// Επιστρέφει τη θέση του key στον πίνακα, ή -1 αν δεν υπάρχει. Η αναζήτηση σταματάει σε EMPTY κόμβο,
+// αλλά και σε κόμβο με απόσταση μικρότερη από την τρέχουσα: αν το key υπήρχε, η place θα
+// το είχε τοποθετήσει σε εκείνη τη θέση. Η compare καλείται μόνο για keys με ίδιο hash code.
+static ptrdiff_t find_pos(Map map, Pointer key, uint64_t hash) {
+	size_t pos = home_pos(hash, map->capacity);
+	for (int dist = 0;
+		map->array[pos].state == OCCUPIED && map->array[pos].dist >= dist;
+		dist++, pos = wrap(pos + 1, map->capacity)) {
+
+		if (map->array[pos].hash == hash && map->compare(map->array[pos].key, key) == 0)
+			return pos;
+	}
+	return -1;
+}
+
+// Η map_find_or_insert για key με ήδη υπολογισμένο hash code: επιστρέφει τον κόμβο του key, ή αν δεν
+// υπάρχει το τοποθετεί με τιμή NULL. Η αναζήτηση (όπως στη find_pos) σταματάει ακριβώς στη θέση όπου
+// η place θα τοποθετούσε το key, οπότε η τοποθέτηση συνεχίζει από εκεί χωρίς δεύτερη διάσχιση.
+static MapNode find_or_insert_hashed(Map map, Pointer key, uint64_t hash, bool* inserted) {
+	size_t pos = home_pos(hash, map->capacity);
+	int dist = 0;
+	for (; map->array[pos].state == OCCUPIED && map->array[pos].dist >= dist; dist++, pos = wrap(pos + 1, map->capacity)) {
+		if (map->array[pos].hash == hash && map->compare(map->array[pos].key, key) == 0) {
+			*inserted = false;
+			return &map->array[pos];
+		}
+	}
+
+	// Νέο στοιχείο. Αν με την εισαγωγή ξεπερνάμε το μέγιστο load factor, κάνουμε πρώτα rehash,
+	// και τότε η θέση που βρήκαμε δεν ισχύει πλέον.
+	*inserted = true;
+	map->size++;
+	float load_factor = (float)map->size / map->capacity;
+	if (load_factor > MAX_LOAD_FACTOR) {
+		rehash(map, next_capacity(map, map->capacity));
+		return place(map, key, NULL, hash);
+	}
+
+	struct map_node entry = { .key = key, .value = NULL, .state = OCCUPIED, .dist = dist, .hash = hash };
+	return place_from(map, entry, pos);
+}
+
+// Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει,
+// ανανέωση του με ένα νέο value.
+// Η map_insert για key με ήδη υπολογισμένο hash code
+static void insert_hashed(Map map, Pointer key, Pointer value, uint64_t hash) {
+	bool inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash, &inserted);
+	if (!inserted) {
+		// Αν αντικαθιστούμε παλιά key/value, τa κάνουμε destroy
+		if (node->key != key && map->destroy_key != NULL)
+			map->destroy_key(node->key);
+
+		if (node->value != value && map->destroy_value != NULL)
+			map->destroy_value(node->value);
+
+		node->key = key;
+	}
+	node->value = value;
+}
+
+void map_insert(Map map, Pointer key, Pointer value) {
+	insert_hashed(map, key, value, hash_of(map, key));
+}
+
+// Η map_insert_batch υπολογίζει τα hash codes σε ομάδες των BATCH_SIZE keys, και φορτώνει στην cache
+// τη θέση κάθε key PREFETCH_DISTANCE εισαγωγές πριν από αυτή, ώστε οι αναμονές για τη μνήμη να επικαλύπτονται.
+#define BATCH_SIZE 64
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 8
+#endif
+
+// Φορτώνει στην cache (χωρίς να περιμένει) τον κόμβο από τον οποίο ξεκινάει η αναζήτηση του hash
+static inline void prefetch(Map map, uint64_t hash) {
+	__builtin_prefetch(&map->array[home_pos(hash, map->capacity)], 1);
+}
+
+void map_insert_batch(Map map, Pointer* keys, Pointer* values, size_t n) {
+	// Δεσμεύουμε μία φορά χώρο για όλα τα στοιχεία (αν κάποια keys υπάρχουν ήδη, απλά περισσεύει χώρος)
+	reserve(map, map->size + n);
+
+	uint64_t hashes[BATCH_SIZE];
+	for (size_t start = 0; start < n; start += BATCH_SIZE) {
+		size_t count = n - start < BATCH_SIZE ? n - start : BATCH_SIZE;
+		for (size_t i = 0; i < count; i++) {
+			hashes[i] = hash_of(map, keys[start + i]);
+			if (i < PREFETCH_DISTANCE)
+				prefetch(map, hashes[i]);
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			if (i + PREFETCH_DISTANCE < count)
+				prefetch(map, hashes[i + PREFETCH_DISTANCE]);
+
+			insert_hashed(map, keys[start + i], values != NULL ? values[start + i] : NULL, hashes[i]);
+		}
+	}
+}
+
+// Διαργραφή απο το Hash Table του κλειδιού με τιμή key
+bool map_remove(Map map, Pointer key) {
+	ptrdiff_t pos = find_pos(map, key, hash_of(map, key));
+	if (pos == -1)
+		return false;
+
+	// destroy
+	if (map->destroy_key != NULL)
+		map->destroy_key(map->array[pos].key);
+	if (map->destroy_value != NULL)
+		map->destroy_value(map->array[pos].value);
+
+	// Backward shift: οι επόμενοι κόμβοι που δεν είναι στη θέση τους μετακινούνται μία θέση πίσω,
+	// μέχρι να βρούμε EMPTY ή κόμβο που είναι ήδη στη θέση του (dist == 0). Έτσι δε χρειάζονται DELETED
+	// κόμβοι, και οι αποστάσεις μένουν ίδιες με το αν το key δεν είχε εισαχθεί ποτέ.
+	size_t next = wrap(pos + 1, map->capacity);
+	while (map->array[next].state == OCCUPIED && map->array[next].dist > 0) {
+		map->array[pos] = map->array[next];
+		map->array[pos].dist--;
+		pos = next;
+		next = wrap(next + 1, map->capacity);
+	}
+	map->array[pos].state = EMPTY;
+	bitmap_clear(map->occupied, pos);
+	map->size--;
+	shrink(map);
+
+	return true;
+}
+
+// Αναζήτηση στο map, με σκοπό να επιστραφεί το value του κλειδιού που περνάμε σαν όρισμα.
+Pointer map_find(Map map, Pointer key) {
+	MapNode node = map_find_node(map, key);
+	if (node != MAP_EOF)
+		return node->value;
+	else
+		return NULL;
+}
+
+// Στη map_find_batch (βλέπε ADTMap.h) ένα βήμα ελέγχει τις θέσεις ενός cache line του array, και η αναζήτηση
+// σταματάει όπως στη find_pos χωρίς να φτάσει σε EMPTY κόμβο.
+
+// Η κατάσταση μιας αναζήτησης της map_find_batch
+typedef struct {
+	size_t index;		// Η θέση του key στον πίνακα keys
+	uint64_t hash;
+	bool hashed;		// Έχει υπολογιστεί το hash code (στο πρώτο βήμα, αφού γίνει prefetch στο key)
+	size_t pos;			// Η θέση του array που ελέγχεται στο επόμενο βήμα (έχει ήδη γίνει prefetch)
+	int dist;			// Η απόσταση της pos από τη θέση που κάνει hash το key
+} Lookup;
+
+// Υπολογίζει το hash code του key της l και κάνει prefetch στη θέση του
+static void lookup_hash(Map map, Lookup* l, Pointer key) {
+	l->hash = hash_of(map, key);
+	l->pos = home_pos(l->hash, map->capacity);
+	l->dist = 0;
+	__builtin_prefetch(&map->array[l->pos]);
+}
+
+#include "../ADTMapFindBatch.h"
+
+// Ένα βήμα της αναζήτησης l: ελέγχει τις θέσεις του cache line στο οποίο βρίσκεται, επιστρέφει true αν ολοκληρώθηκε
+static bool lookup_step(Map map, Lookup* l, Pointer* keys, Pointer* out_values) {
+	for (;;) {
+		// Όπως στη find_pos, σταματάμε σε κόμβο πιο κοντά στη θέση του από ό,τι θα ήταν το key
+		MapNode node = &map->array[l->pos];
+		if (node->state != OCCUPIED || node->dist < l->dist)
+			return lookup_finish(l, out_values, MAP_EOF);
+
+		if (node->hash == l->hash && map->compare(node->key, keys[l->index]) == 0)
+			return lookup_finish(l, out_values, node);
+
+		// Όσο η επόμενη θέση είναι στο ίδιο cache line συνεχίζουμε, διαφορετικά περιμένουμε τον επόμενο γύρο
+		l->dist++;
+		l->pos = wrap(l->pos + 1, map->capacity);
+		if ((uintptr_t)&map->array[l->pos] / 64 != (uintptr_t)node / 64) {
+			__builtin_prefetch(&map->array[l->pos]);
+			return false;
+		}
+	}
+}
+
+
+DestroyFunc map_set_destroy_key(Map map, DestroyFunc destroy_key) {
+	DestroyFunc old = map->destroy_key;
+	map->destroy_key = destroy_key;
+	return old;
+}
+
+DestroyFunc map_set_destroy_value(Map map, DestroyFunc destroy_value) {
+	DestroyFunc old = map->destroy_value;
+	map->destroy_value = destroy_value;
+	return old;
+}
+
+// Απελευθέρωση μνήμης που δεσμεύει το map
+void map_destroy(Map map) {
+	if (map->destroy_key != NULL || map->destroy_value != NULL) {
+		for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node)) {
+			if (map->destroy_key != NULL)
+				map->destroy_key(node->key);
+			if (map->destroy_value != NULL)
+				map->destroy_value(node->value);
+		}
+	}
+
+	free(map->array);
+	free(map->occupied);
+	free(map);
+}
+
+/////////////////////// Διάσχιση του map μέσω κόμβων ///////////////////////////
+
+MapNode map_first(Map map) {
+	//Ξεκινάμε την επανάληψή μας απο το 1ο στοιχείο, μέχρι να βρούμε κάτι όντως τοποθετημένο
+	size_t pos = bitmap_next(map->occupied, map->capacity, 0);
+	return pos < map->capacity ? &map->array[pos] : MAP_EOF;
+}
+
+MapNode map_next(Map map, MapNode node) {
+	// Το node είναι pointer στο i-οστό στοιχείο του array, οπότε node - array == i  (pointer arithmetic!)
+	size_t pos = bitmap_next(map->occupied, map->capacity, node - map->array + 1);
+	return pos < map->capacity ? &map->array[pos] : MAP_EOF;
+}
+
+Pointer map_node_key(Map map, MapNode node) {
+	return node->key;
+}
+
+Pointer map_node_value(Map map, MapNode node) {
+	return node->value;
+}
+
+MapNode map_find_node(Map map, Pointer key) {
+	ptrdiff_t pos = find_pos(map, key, hash_of(map, key));
+	return pos != -1 ? &map->array[pos] : MAP_EOF;
+}
+
+MapNode map_find_or_insert(Map map, Pointer key, bool* inserted) {
+	bool was_inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash_of(map, key), &was_inserted);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+MapNode map_find_or_insert_with(Map map, Pointer key, CreateValueFunc create_value, bool* inserted) {
+	bool was_inserted;
+	MapNode node = map_find_or_insert(map, key, &was_inserted);
+	if (was_inserted)
+		node->value = create_value(key);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	node->value = value;
+}
+
+// Αρχικοποίηση της συνάρτησης κατακερματισμού του συγκεκριμένου map.
+void map_set_hash_function(Map map, HashFunc func) {
+	map->hash_function = func;
+	map->hash_function64 = NULL;
+}
+
+void map_set_hash_function64(Map map, HashFunc64 func) {
+	map->hash_function64 = func;
+}
+
+void map_set_capacity_policy(Map map, MapCapacityPolicy policy) {
+	// Τα στοιχεία ενός μη κενού map θα χάνονταν μαζί με τον πίνακα
+	if (map->size != 0)
+		return;
+
+	map->capacity_policy = policy;
+
+	// Το map είναι άδειο, οπότε απλά αντικαθιστούμε τον αρχικό πίνακα με έναν της νέας πολιτικής
+	// που χωράει όσα στοιχεία και ο παλιός (ώστε να διατηρείται ο χώρος της map_create_sized)
+	free(map->array);
+	free(map->occupied);
+	allocate_array(map, capacity_for(map, map->capacity * MAX_LOAD_FACTOR));
+}
+
+// Το Robin Hood probing δεν έχει γειτονιά σταθερού μεγέθους, οπότε η map_set_neighbourhood δεν αλλάζει κάτι
+void map_set_neighbourhood(Map map, int neighbourhood) {
+}
+
+#include "../ADTMapHash.h"
+
+/////////////////////// Στατιστικά ///////////////////////////
+
+void map_stats(Map map, MapStats* stats) {
+	*stats = (MapStats){
+		.size = map->size,
+		.capacity = map->capacity,
+		.load_factor = (double)map->size / map->capacity,
+		.displacements = map->displacements,
+		.rehashes = map->rehashes,
+		.bytes = sizeof(*map) + map->capacity * sizeof(struct map_node) + (map->capacity + 63) / 64 * sizeof(uint64_t),
+	};
+
+	// Το probe length κάθε κόμβου είναι ήδη αποθηκευμένο (dist)
+	for (size_t pos = 0; pos < map->capacity; pos++) {
+		int dist = map->array[pos].dist;
+		if (map->array[pos].state == OCCUPIED)
+			stats->probe_lengths[dist < MAP_STATS_HISTOGRAM ? dist : MAP_STATS_HISTOGRAM - 1]++;
+	}
+}
@@ -0,0 +1,639 @@
+/////////////////////////////////////////////////////////////////////////////
+//
+// Υλοποίηση του ADT Map μέσω "Swiss table": open addressing όπου κάθε θέση
+// έχει ένα control byte σε ξεχωριστό πίνακα, και η αναζήτηση ελέγχει 16
+// control bytes τη φορά (με SSE2 όπου είναι διαθέσιμο)
+//
+/////////////////////////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "ADTMap.h"
+
+
+// Κάθε θέση του πίνακα έχει ένα control byte, το οποίο είναι:
+//   EMPTY    αν η θέση δεν έχει χρησιμοποιηθεί (τερματίζει την αναζήτηση)
+//   DELETED  αν η θέση περιείχε στοιχείο που διαγράφηκε (η αναζήτηση συνεχίζει)
+//   0..127   αν η θέση είναι κατειλημμένη, οπότε το byte περιέχει 7 bits από το hash του key (H2)
+// Τα EMPTY και DELETED έχουν το υψηλότερο bit 1, οπότε οι ελεύθερες θέσεις ξεχωρίζουν απλά από το πρόσημο.
+#define EMPTY	((int8_t)-128)
+#define DELETED	((int8_t)-2)
+
+// Οι θέσεις χωρίζονται σε ομάδες των GROUP_SIZE θέσεων, τα control bytes μιας ομάδας
+// χωράνε σε έναν SSE2 καταχωρητή και ελέγχονται όλα μαζί με μία σύγκριση.
+#define GROUP_SIZE 16
+
+// Το μέγεθος του πίνακα είναι πάντα δύναμη του 2 (και πολλαπλάσιο του GROUP_SIZE),
+// ώστε η επιλογή ομάδας να γίνεται με & αντί για %.
+#define MIN_CAPACITY GROUP_SIZE
+
+// Επειδή η αναζήτηση φιλτράρει με τα control bytes, μπορούμε να γεμίσουμε τον πίνακα
+// πολύ περισσότερο από το 0.5 του linear probing. Μετράμε και τα DELETED, όπως στο UsingHashTable.
+#define MAX_LOAD_FACTOR 0.875
+
+// Το όριο για το μίκρεμα του πίνακα (βλέπε map_compact στο ADTMap.h). Σε αντίθεση με τον έλεγχο του
+// MAX_LOAD_FACTOR, εδώ δε μετράνε οι DELETED θέσεις, τις οποίες η resize αφαιρεί.
+#define MIN_LOAD_FACTOR 0.125
+
+// Δομή του κάθε κόμβου. Η κατάσταση του κόμβου δεν αποθηκεύεται εδώ αλλά στα control bytes,
+// οπότε ο κόμβος περιέχει μόνο τα δεδομένα και η αναζήτηση δεν τον αγγίζει παρά μόνο όταν το H2 ταιριάζει.
+struct map_node {
+	Pointer key;		// Το κλειδί που χρησιμοποιείται για να hash-αρουμε
+	Pointer value;		// Η τιμή που αντισοιχίζεται στο παραπάνω κλειδί
+	uint64_t hash;		// Το hash code του key (πριν τη mix), ώστε το rehash να μην ξανακαλεί την hash_function
+};
+
+// Δομή του Map
+struct map {
+	int8_t* ctrl;				// Τα control bytes, ένα για κάθε θέση του array
+	MapNode array;				// Οι κόμβοι (παράλληλος πίνακας με τον ctrl)
+	size_t capacity;			// Πόσο χώρο έχουμε δεσμεύσει (δύναμη του 2)
+	size_t size;				// Πόσα στοιχεία έχουμε προσθέσει
+	size_t reserved;			// Ο χώρος (σε στοιχεία) της map_reserve, κάτω από τον οποίο ο πίνακας δε μικραίνει
+	size_t deleted;				// Πόσα control bytes είναι DELETED
+	int rehashes;				// Πόσα rehash έχουν γίνει (για τη map_stats)
+	CompareFunc compare;		// Συνάρτηση για σύγκριση δεικτών, που πρέπει να δίνεται απο τον χρήστη
+	HashFunc hash_function;		// Συνάρτηση για να παίρνουμε το hash code του κάθε αντικειμένου.
+	HashFunc64 hash_function64;	// Η συνάρτηση 64 bits, αν έχει οριστεί (διαφορετικά NULL και χρησιμοποιείται η hash_function)
+	DestroyFunc destroy_key;	// Συναρτήσεις που καλούνται όταν διαγράφουμε έναν κόμβο απο το map.
+	DestroyFunc destroy_value;
+};
+
+
+//////////////////////// Πράξεις σε ομάδες από control bytes ////////////////////////
+//
+// Κάθε συνάρτηση επιστρέφει ένα bitmask 16 bits, όπου το bit i είναι 1 αν η θέση i της ομάδας ικανοποιεί τη συνθήκη.
+
+// Θέσεις με control byte ίσο με b
+static inline uint match_byte(const int8_t* group, int8_t b) {
+#ifdef __SSE2__
+	__m128i ctrl = _mm_load_si128((const __m128i*)group);
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(b), ctrl));
+#else
+	uint mask = 0;
+	for (int i = 0; i < GROUP_SIZE; i++)
+		if (group[i] == b)
+			mask |= 1u << i;
+	return mask;
+#endif
+}
+
+// Θέσεις που είναι EMPTY ή DELETED (υψηλότερο bit 1)
+static inline uint match_free(const int8_t* group) {
+#ifdef __SSE2__
+	return _mm_movemask_epi8(_mm_load_si128((const __m128i*)group));
+#else
+	uint mask = 0;
+	for (int i = 0; i < GROUP_SIZE; i++)
+		if (group[i] < 0)
+			mask |= 1u << i;
+	return mask;
+#endif
+}
+
+// Θέσεις που είναι κατειλημμένες
+static inline uint match_full(const int8_t* group) {
+	return ~match_free(group) & 0xFFFF;
+}
+
+// Θέσεις που είναι EMPTY
+static inline uint match_empty(const int8_t* group) {
+	return match_byte(group, EMPTY);
+}
+
+
+//////////////////////// Hashing και probing ////////////////////////
+
+// Το hash που δίνει ο χρήστης μπορεί να είναι πολύ "φτωχό" (πχ το hash_int είναι η ίδια η τιμή),
+// οπότε το ανακατεύουμε με έναν πολλαπλασιασμό (Fibonacci hashing) πριν το χωρίσουμε σε:
+//   H1: ποια ομάδα είναι η αρχική θέση του key (από τα μεσαία bits, και τα χαμηλά για πίνακες με > 2^32 ομάδες)
+//   H2: τα 7 bits που αποθηκεύονται στο control byte (από τα υψηλότερα bits)
+static inline uint64_t mix(uint64_t hash) {
+	return hash * 0x9E3779B97F4A7C15ull;
+}
+
+static inline size_t h1(uint64_t mixed) {
+	return (size_t)(mixed >> 32 | mixed << 32);
+}
+
+static inline int8_t h2(uint64_t mixed) {
+	return (int8_t)(mixed >> 57);
+}
+
+// Οι ομάδες διασχίζονται με triangular probing (βήμα 1, 2, 3, ...), το οποίο για πλήθος
+// ομάδων δύναμη του 2 επισκέπτεται όλες τις ομάδες πριν επαναληφθεί.
+static inline size_t group_mask(Map map) {
+	return map->capacity / GROUP_SIZE - 1;
+}
+
+// Βρίσκει την πρώτη ελεύθερη (EMPTY ή DELETED) θέση στην ακολουθία αναζήτησης του hash.
+// Ο load factor εγγυάται ότι υπάρχει τουλάχιστον μία EMPTY θέση, οπότε η επανάληψη τερματίζει.
+static size_t find_free_slot(Map map, uint64_t mixed) {
+	size_t mask = group_mask(map);
+	size_t group = h1(mixed) & mask;
+	for (size_t step = 1; ; step++) {
+		uint free_mask = match_free(&map->ctrl[group * GROUP_SIZE]);
+		if (free_mask != 0)
+			return group * GROUP_SIZE + __builtin_ctz(free_mask);
+
+		group = (group + step) & mask;
+	}
+}
+
+// Δεσμεύει πίνακες χωρητικότητας capacity, με όλα τα control bytes EMPTY
+static void allocate_arrays(Map map, size_t capacity) {
+	map->capacity = capacity;
+	map->ctrl = aligned_alloc(GROUP_SIZE, capacity);	// ευθυγράμμιση για το _mm_load_si128
+	map->array = malloc(capacity * sizeof(struct map_node));
+	for (size_t i = 0; i < capacity; i++)
+		map->ctrl[i] = EMPTY;
+}
+
+
+Map map_create(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value) {
+	// Δεσμεύουμε κατάλληλα τον χώρο που χρειαζόμαστε για το hash table
+	Map map = malloc(sizeof(*map));
+	allocate_arrays(map, MIN_CAPACITY);
+
+	map->size = 0;
+	map->deleted = 0;
+	map->reserved = 0;
+	map->rehashes = 0;
+	map->compare = compare;
+	map->hash_function = NULL;
+	map->hash_function64 = NULL;
+	map->destroy_key = destroy_key;
+	map->destroy_value = destroy_value;
+
+	return map;
+}
+
+Map map_create_sized(CompareFunc compare, DestroyFunc destroy_key, DestroyFunc destroy_value, size_t expected) {
+	Map map = map_create(compare, destroy_key, destroy_value);
+	map_reserve(map, expected);
+	return map;
+}
+
+// Επιστρέφει τον αριθμό των entries του map σε μία χρονική στιγμή.
+int map_size(Map map) {
+	return map->size;
+}
+
+size_t map_size64(Map map) {
+	return map->size;
+}
+
+// Το hash code του key, από όποια από τις δύο συναρτήσεις κατακερματισμού έχει οριστεί
+static inline uint64_t hash_of(Map map, Pointer key) {
+	return map->hash_function64 != NULL ? map->hash_function64(key) : map->hash_function(key);
+}
+
+// Ξαναχτίζει το hash table σε πίνακες new_capacity θέσεων (χωρίς τα DELETED)
+static void resize(Map map, size_t new_capacity) {
+	// Αποθήκευση των παλιών δεδομένων
+	size_t old_capacity = map->capacity;
+	int8_t* old_ctrl = map->ctrl;
+	MapNode old_array = map->array;
+	map->rehashes++;
+	allocate_arrays(map, new_capacity);
+
+	// Τοποθετούμε ΜΟΝΟ τα entries που όντως περιέχουν ένα στοιχείο. Τα keys είναι σίγουρα
+	// διαφορετικά μεταξύ τους, οπότε δε χρειάζεται η αναζήτηση (και η compare) της map_insert.
+	for (size_t i = 0; i < old_capacity; i++) {
+		if (old_ctrl[i] < 0)
+			continue;
+
+		uint64_t mixed = mix(old_array[i].hash);
+		size_t pos = find_free_slot(map, mixed);
+		map->ctrl[pos] = h2(mixed);
+		map->array[pos] = old_array[i];
+	}
+	map->deleted = 0;
+
+	//Αποδεσμεύουμε τους παλιούς πίνακες ώστε να μήν έχουμε leaks
+	free(old_ctrl);
+	free(old_array);
+}
+
+// Ξαναχτίζει το hash table. Αν η πληρότητα οφείλεται κυρίως σε DELETED θέσεις, κρατάμε την ίδια
+// χωρητικότητα (απλά καθαρίζουμε τα DELETED), διαφορετικά διπλασιάζουμε.
+static void rehash(Map map) {
+	if (map->size >= map->capacity * MAX_LOAD_FACTOR / 2)
+		resize(map, map->capacity * 2);
+	else
+		resize(map, map->capacity);
+}
+
+// Η μικρότερη δύναμη του 2 στην οποία χωράνε n στοιχεία χωρίς rehash
+static size_t capacity_for(size_t n) {
+	size_t capacity = MIN_CAPACITY;
+	while (n > capacity * MAX_LOAD_FACTOR)
+		capacity *= 2;
+	return capacity;
+}
+
+// Μεγαλώνει τον πίνακα (αν χρειάζεται) ώστε να χωράει n στοιχεία
+static void reserve(Map map, size_t n) {
+	size_t capacity = capacity_for(n);
+	if (capacity > map->capacity)
+		resize(map, capacity);
+}
+
+// Ο χώρος της map_reserve διατηρείται και όταν ο πίνακας μικραίνει (βλέπε shrink)
+void map_reserve(Map map, size_t n) {
+	if (n > map->reserved)
+		map->reserved = n;
+	reserve(map, n);
+}
+
+// Μικραίνει τον πίνακα αν ο load factor έπεσε κάτω από MIN_LOAD_FACTOR
+static void shrink(Map map) {
+	if (map->size >= map->capacity * MIN_LOAD_FACTOR)
+		return;
+
+	size_t capacity = capacity_for(2 * map->size > map->reserved ? 2 * map->size : map->reserved);
+	if (capacity < map->capacity)
+		resize(map, capacity);
+}
+
+void map_compact(Map map) {
+	// Ο νέος πίνακας (χωρίς DELETED θέσεις) δημιουργείται ακόμα και αν η χωρητικότητα δεν αλλάζει
+	map->reserved = 0;
+	resize(map, capacity_for(map->size));
+}
+
+// Αναζήτηση της θέσης του key (ή -1 αν δεν υπάρχει). Η compare καλείται μόνο για θέσεις
+// των οποίων το control byte ταιριάζει με το H2 του key και το hash code είναι ίδιο.
+static ptrdiff_t find_pos(Map map, Pointer key, uint64_t hash) {
+	uint64_t mixed = mix(hash);
+	size_t mask = group_mask(map);
+	size_t group = h1(mixed) & mask;
+	int8_t tag = h2(mixed);
+
+	for (size_t step = 1; ; step++) {
+		const int8_t* ctrl = &map->ctrl[group * GROUP_SIZE];
+
+		for (uint match = match_byte(ctrl, tag); match != 0; match &= match - 1) {
+			size_t pos = group * GROUP_SIZE + __builtin_ctz(match);
+			if (map->array[pos].hash == hash && map->compare(map->array[pos].key, key) == 0)
+				return pos;
+		}
+
+		// Αν η ομάδα έχει EMPTY θέση, το key θα είχε τοποθετηθεί το αργότερο εκεί
+		if (match_empty(ctrl) != 0)
+			return -1;
+
+		group = (group + step) & mask;
+	}
+}
+
+// Η map_find_or_insert για key με ήδη υπολογισμένο hash code: επιστρέφει τον κόμβο του key, ή αν δεν
+// υπάρχει το τοποθετεί με τιμή NULL. Η αναζήτηση (όπως στη find_pos) σημειώνει την πρώτη ελεύθερη θέση
+// της ακολουθίας, δηλαδή αυτή που θα έβρισκε η find_free_slot, οπότε η εισαγωγή γίνεται χωρίς δεύτερη διάσχιση.
+static MapNode find_or_insert_hashed(Map map, Pointer key, uint64_t hash, bool* inserted) {
+	uint64_t mixed = mix(hash);
+	size_t mask = group_mask(map);
+	size_t group = h1(mixed) & mask;
+	int8_t tag = h2(mixed);
+	ptrdiff_t pos = -1;
+
+	for (size_t step = 1; ; step++) {
+		const int8_t* ctrl = &map->ctrl[group * GROUP_SIZE];
+
+		for (uint match = match_byte(ctrl, tag); match != 0; match &= match - 1) {
+			size_t i = group * GROUP_SIZE + __builtin_ctz(match);
+			if (map->array[i].hash == hash && map->compare(map->array[i].key, key) == 0) {
+				*inserted = false;
+				return &map->array[i];
+			}
+		}
+
+		uint free_mask = match_free(ctrl);
+		if (pos == -1 && free_mask != 0)
+			pos = group * GROUP_SIZE + __builtin_ctz(free_mask);
+
+		// Αν η ομάδα έχει EMPTY θέση, το key θα είχε τοποθετηθεί το αργότερο εκεί
+		if (match_empty(ctrl) != 0)
+			break;
+
+		group = (group + step) & mask;
+	}
+
+	// Νέο στοιχείο. Αν η εισαγωγή σε EMPTY θέση θα ξεπερνούσε το μέγιστο load factor κάνουμε
+	// πρώτα rehash (η εισαγωγή σε DELETED θέση δεν αλλάζει τον load factor).
+	if (map->ctrl[pos] == EMPTY && map->size + map->deleted + 1 > map->capacity * MAX_LOAD_FACTOR) {
+		rehash(map);
+		pos = find_free_slot(map, mixed);
+	}
+
+	if (map->ctrl[pos] == DELETED)
+		map->deleted--;
+
+	map->ctrl[pos] = tag;
+	map->array[pos].key = key;
+	map->array[pos].value = NULL;
+	map->array[pos].hash = hash;
+	map->size++;
+	*inserted = true;
+	return &map->array[pos];
+}
+
+// Εισαγωγή στο hash table του ζευγαριού (key, item). Αν το key υπάρχει,
+// ανανέωση του με ένα νέο value.
+// Η map_insert για key με ήδη υπολογισμένο hash code
+static void insert_hashed(Map map, Pointer key, Pointer value, uint64_t hash) {
+	bool inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash, &inserted);
+	if (!inserted) {
+		// Αν αντικαθιστούμε παλιά key/value, τa κάνουμε destroy
+		if (node->key != key && map->destroy_key != NULL)
+			map->destroy_key(node->key);
+
+		if (node->value != value && map->destroy_value != NULL)
+			map->destroy_value(node->value);
+
+		node->key = key;
+	}
+	node->value = value;
+}
+
+void map_insert(Map map, Pointer key, Pointer value) {
+	insert_hashed(map, key, value, hash_of(map, key));
+}
+
+// Η map_insert_batch υπολογίζει τα hash codes σε ομάδες των BATCH_SIZE keys, και φορτώνει στην cache
+// τη θέση κάθε key PREFETCH_DISTANCE εισαγωγές πριν από αυτή, ώστε οι αναμονές για τη μνήμη να επικαλύπτονται.
+#define BATCH_SIZE 64
+#ifndef PREFETCH_DISTANCE
+#define PREFETCH_DISTANCE 8
+#endif
+
+// Φορτώνει στην cache (χωρίς να περιμένει) την πρώτη ομάδα της αναζήτησης του hash: control bytes και κόμβους
+static inline void prefetch(Map map, uint64_t hash) {
+	size_t pos = (h1(mix(hash)) & group_mask(map)) * GROUP_SIZE;
+	__builtin_prefetch(&map->ctrl[pos], 1);
+	__builtin_prefetch(&map->array[pos], 1);
+}
+
+void map_insert_batch(Map map, Pointer* keys, Pointer* values, size_t n) {
+	// Δεσμεύουμε μία φορά χώρο για όλα τα στοιχεία (αν κάποια keys υπάρχουν ήδη, απλά περισσεύει χώρος)
+	reserve(map, map->size + n);
+
+	uint64_t hashes[BATCH_SIZE];
+	for (size_t start = 0; start < n; start += BATCH_SIZE) {
+		size_t count = n - start < BATCH_SIZE ? n - start : BATCH_SIZE;
+		for (size_t i = 0; i < count; i++) {
+			hashes[i] = hash_of(map, keys[start + i]);
+			if (i < PREFETCH_DISTANCE)
+				prefetch(map, hashes[i]);
+		}
+
+		for (size_t i = 0; i < count; i++) {
+			if (i + PREFETCH_DISTANCE < count)
+				prefetch(map, hashes[i + PREFETCH_DISTANCE]);
+
+			insert_hashed(map, keys[start + i], values != NULL ? values[start + i] : NULL, hashes[i]);
+		}
+	}
+}
+
+// Διαργραφή απο το Hash Table του κλειδιού με τιμή key
+bool map_remove(Map map, Pointer key) {
+	ptrdiff_t pos = find_pos(map, key, hash_of(map, key));
+	if (pos == -1)
+		return false;
+
+	// destroy
+	if (map->destroy_key != NULL)
+		map->destroy_key(map->array[pos].key);
+	if (map->destroy_value != NULL)
+		map->destroy_value(map->array[pos].value);
+
+	// Αν η ομάδα της θέσης έχει ήδη EMPTY θέση, καμία αναζήτηση δεν προχωράει πέρα από αυτή,
+	// οπότε η θέση μπορεί να γίνει απευθείας EMPTY. Διαφορετικά χρειάζεται DELETED.
+	const int8_t* group = &map->ctrl[pos / GROUP_SIZE * GROUP_SIZE];
+	if (match_empty(group) != 0) {
+		map->ctrl[pos] = EMPTY;
+	} else {
+		map->ctrl[pos] = DELETED;
+		map->deleted++;
+	}
+	map->size--;
+	shrink(map);
+
+	return true;
+}
+
+// Αναζήτηση στο map, με σκοπό να επιστραφεί το value του κλειδιού που περνάμε σαν όρισμα.
+Pointer map_find(Map map, Pointer key) {
+	MapNode node = map_find_node(map, key);
+	if (node != MAP_EOF)
+		return node->value;
+	else
+		return NULL;
+}
+
+// Στη map_find_batch (βλέπε ADTMap.h) κάθε ομάδα ελέγχεται σε δύο βήματα: τα control bytes της (με prefetch
+// στους κόμβους με ίδιο H2) και οι κόμβοι αυτοί.
+
+// Η κατάσταση μιας αναζήτησης της map_find_batch
+typedef struct {
+	size_t index;		// Η θέση του key στον πίνακα keys
+	uint64_t hash;
+	bool hashed;		// Έχει υπολογιστεί το hash code (στο πρώτο βήμα, αφού γίνει prefetch στο key)
+	size_t group;		// Η ομάδα που ελέγχεται στο επόμενο βήμα (έχει ήδη γίνει prefetch στα control bytes της)
+	size_t step;
+	int8_t tag;			// Το H2 του key
+	uint match;			// Αν != 0, οι θέσεις της ομάδας με ίδιο H2 (έχει γίνει prefetch στους κόμβους τους)
+} Lookup;
+
+// Υπολογίζει το hash code του key της l και κάνει prefetch στη θέση του
+static void lookup_hash(Map map, Lookup* l, Pointer key) {
+	l->hash = hash_of(map, key);
+	uint64_t mixed = mix(l->hash);
+	l->group = h1(mixed) & group_mask(map);
+	l->step = 1;
+	l->tag = h2(mixed);
+	l->match = 0;
+	__builtin_prefetch(&map->ctrl[l->group * GROUP_SIZE]);
+}
+
+#include "../ADTMapFindBatch.h"
+
+// Ένα βήμα της αναζήτησης l (σε δύο γύρους για κάθε ομάδα: control bytes και κόμβοι), επιστρέφει true αν ολοκληρώθηκε
+static bool lookup_step(Map map, Lookup* l, Pointer* keys, Pointer* out_values) {
+	const int8_t* ctrl = &map->ctrl[l->group * GROUP_SIZE];
+
+	if (l->match == 0) {
+		// Πρώτος γύρος: βρίσκουμε τις θέσεις με ίδιο H2 και κάνουμε prefetch στους κόμβους τους
+		l->match = match_byte(ctrl, l->tag);
+		for (uint match = l->match; match != 0; match &= match - 1)
+			__builtin_prefetch(&map->array[l->group * GROUP_SIZE + __builtin_ctz(match)]);
+		if (l->match != 0)
+			return false;
+	} else {
+		// Δεύτερος γύρος: ελέγχουμε τους κόμβους
+		for (; l->match != 0; l->match &= l->match - 1) {
+			MapNode node = &map->array[l->group * GROUP_SIZE + __builtin_ctz(l->match)];
+			if (node->hash == l->hash && map->compare(node->key, keys[l->index]) == 0)
+				return lookup_finish(l, out_values, node);
+		}
+	}
+
+	// Αν η ομάδα έχει EMPTY θέση, το key θα είχε τοποθετηθεί το αργότερο εκεί
+	if (match_empty(ctrl) != 0)
+		return lookup_finish(l, out_values, MAP_EOF);
+
+	l->group = (l->group + l->step++) & group_mask(map);
+	__builtin_prefetch(&map->ctrl[l->group * GROUP_SIZE]);
+	return false;
+}
+
+
+DestroyFunc map_set_destroy_key(Map map, DestroyFunc destroy_key) {
+	DestroyFunc old = map->destroy_key;
+	map->destroy_key = destroy_key;
+	return old;
+}
+
+DestroyFunc map_set_destroy_value(Map map, DestroyFunc destroy_value) {
+	DestroyFunc old = map->destroy_value;
+	map->destroy_value = destroy_value;
+	return old;
+}
+
+// Απελευθέρωση μνήμης που δεσμεύει το map
+void map_destroy(Map map) {
+	if (map->destroy_key != NULL || map->destroy_value != NULL) {
+		for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node)) {
+			if (map->destroy_key != NULL)
+				map->destroy_key(node->key);
+			if (map->destroy_value != NULL)
+				map->destroy_value(node->value);
+		}
+	}
+
+	free(map->ctrl);
+	free(map->array);
+	free(map);
+}
+
+/////////////////////// Διάσχιση του map μέσω κόμβων ///////////////////////////
+
+// Επιστρέφει τον πρώτο κατειλημμένο κόμβο με θέση >= pos, ελέγχοντας μια ομάδα τη φορά
+static MapNode first_full_from(Map map, size_t pos) {
+	if (pos >= map->capacity)
+		return MAP_EOF;
+
+	// Η πρώτη ομάδα μπορεί να ελεγχθεί μερικώς, αγνοούμε τις θέσεις πριν το pos
+	size_t group = pos / GROUP_SIZE;
+	uint full = match_full(&map->ctrl[group * GROUP_SIZE]) & (0xFFFFu << (pos % GROUP_SIZE));
+
+	size_t groups = map->capacity / GROUP_SIZE;
+	while (full == 0) {
+		if (++group == groups)
+			return MAP_EOF;
+		full = match_full(&map->ctrl[group * GROUP_SIZE]);
+	}
+	return &map->array[group * GROUP_SIZE + __builtin_ctz(full)];
+}
+
+MapNode map_first(Map map) {
+	return first_full_from(map, 0);
+}
+
+MapNode map_next(Map map, MapNode node) {
+	// Το node είναι pointer στο i-οστό στοιχείο του array, οπότε node - array == i  (pointer arithmetic!)
+	return first_full_from(map, node - map->array + 1);
+}
+
+Pointer map_node_key(Map map, MapNode node) {
+	return node->key;
+}
+
+Pointer map_node_value(Map map, MapNode node) {
+	return node->value;
+}
+
+MapNode map_find_node(Map map, Pointer key) {
+	ptrdiff_t pos = find_pos(map, key, hash_of(map, key));
+	return pos != -1 ? &map->array[pos] : MAP_EOF;
+}
+
+MapNode map_find_or_insert(Map map, Pointer key, bool* inserted) {
+	bool was_inserted;
+	MapNode node = find_or_insert_hashed(map, key, hash_of(map, key), &was_inserted);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+MapNode map_find_or_insert_with(Map map, Pointer key, CreateValueFunc create_value, bool* inserted) {
+	bool was_inserted;
+	MapNode node = map_find_or_insert(map, key, &was_inserted);
+	if (was_inserted)
+		node->value = create_value(key);
+	if (inserted != NULL)
+		*inserted = was_inserted;
+	return node;
+}
+
+void map_node_set_value(Map map, MapNode node, Pointer value) {
+	if (node->value != value && map->destroy_value != NULL)
+		map->destroy_value(node->value);
+	node->value = value;
+}
+
+// Αρχικοποίηση της συνάρτησης κατακερματισμού του συγκεκριμένου map.
+void map_set_hash_function(Map map, HashFunc func) {
+	map->hash_function = func;
+	map->hash_function64 = NULL;
+}
+
+void map_set_hash_function64(Map map, HashFunc64 func) {
+	map->hash_function64 = func;
+}
+
+// Οι χωρητικότητες είναι πάντα δυνάμεις του 2 (με Fibonacci hashing), οπότε η πολιτική δεν αλλάζει κάτι
+void map_set_capacity_policy(Map map, MapCapacityPolicy policy) {
+}
+
+// Οι αναζητήσεις διασχίζουν ομάδες των GROUP_SIZE θέσεων, οπότε η map_set_neighbourhood δεν αλλάζει κάτι
+void map_set_neighbourhood(Map map, int neighbourhood) {
+}
+
+#include "../ADTMapHash.h"
+
+/////////////////////// Στατιστικά ///////////////////////////
+
+void map_stats(Map map, MapStats* stats) {
+	*stats = (MapStats){
+		.size = map->size,
+		.capacity = map->capacity,
+		.load_factor = (double)map->size / map->capacity,
+		.tombstones = map->deleted,
+		.rehashes = map->rehashes,
+		.bytes = sizeof(*map) + map->capacity * (1 + sizeof(struct map_node)),
+	};
+
+	// Το probe length κάθε στοιχείου είναι πόσες ομάδες εξετάζει η find_pos πριν φτάσει στην ομάδα του,
+	// ακολουθώντας την ίδια ακολουθία (triangular probing) από την αρχική ομάδα.
+	size_t mask = group_mask(map);
+	for (size_t pos = 0; pos < map->capacity; pos++) {
+		if (map->ctrl[pos] < 0)
+			continue;
+
+		size_t group = h1(mix(map->array[pos].hash)) & mask;
+		size_t steps = 0;
+		while (group != pos / GROUP_SIZE)
+			group = (group + ++steps) & mask;
+
+		stats->probe_lengths[steps < MAP_STATS_HISTOGRAM ? steps : MAP_STATS_HISTOGRAM - 1]++;
+	}
+}
@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////
+//
+// Υλοποίηση του Histogram με log-linear buckets
+//
+///////////////////////////////////////////////////////////
+
+#include <stdlib.h>
+
+#include "histogram.h"
+
+
+// Κάθε δύναμη του 2 χωρίζεται σε SUB_BUCKETS ίσα διαστήματα (buckets), οπότε μια τιμή
+// αντιστοιχίζεται σε bucket με σχετικό σφάλμα το πολύ 1 / SUB_BUCKETS.
+#define SUB_BUCKET_BITS 5
+#define SUB_BUCKETS (1 << SUB_BUCKET_BITS)
+
+// Οι τιμές < SUB_BUCKETS έχουν δικό τους bucket η καθεμία, και κάθε επόμενη δύναμη του 2 (μέχρι 2^64)
+// έχει SUB_BUCKETS buckets.
+#define BUCKETS ((64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS)
+
+struct histogram {
+	uint64_t counts[BUCKETS];	// Πόσες τιμές έχουν καταγραφεί σε κάθε bucket
+	uint64_t count;				// Πόσες τιμές έχουν καταγραφεί συνολικά
+	uint64_t max;
+};
+
+
+// Το bucket της τιμής value. Για value >= SUB_BUCKETS, τα SUB_BUCKET_BITS + 1 υψηλότερα bits της value
+// (μετά από shift θέσεις) επιλέγουν το bucket μέσα στη δύναμη του 2, και το shift τη δύναμη του 2.
+static int bucket_of(uint64_t value) {
+	if (value < SUB_BUCKETS)
+		return (int)value;
+
+	int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+	return shift * SUB_BUCKETS + (int)(value >> shift);
+}
+
+// Η μεγαλύτερη τιμή που αντιστοιχεί στο bucket
+static uint64_t bucket_value(int bucket) {
+	if (bucket < SUB_BUCKETS)
+		return bucket;
+
+	int shift = bucket / SUB_BUCKETS - 1;
+	uint64_t mantissa = bucket - shift * SUB_BUCKETS;		// στο [SUB_BUCKETS, 2 * SUB_BUCKETS)
+	return (mantissa << shift) + ((1ull << shift) - 1);
+}
+
+Histogram histogram_create(void) {
+	return calloc(1, sizeof(struct histogram));
+}
+
+void histogram_record(Histogram hist, uint64_t value) {
+	hist->counts[bucket_of(value)]++;
+	hist->count++;
+	if (value > hist->max)
+		hist->max = value;
+}
+
+uint64_t histogram_count(Histogram hist) {
+	return hist->count;
+}
+
+uint64_t histogram_percentile(Histogram hist, double percentile) {
+	// Η ζητούμενη τιμή είναι η rank-οστή μικρότερη (τουλάχιστον η 1η)
+	uint64_t rank = (uint64_t)(percentile / 100 * hist->count + 0.5);
+	if (rank == 0)
+		rank = 1;
+
+	uint64_t seen = 0;
+	for (int i = 0; i < BUCKETS; i++) {
+		seen += hist->counts[i];
+		if (seen >= rank) {
+			// Το όριο του bucket μπορεί να ξεπερνάει τη μέγιστη τιμή που έχει όντως καταγραφεί
+			uint64_t value = bucket_value(i);
+			return value < hist->max ? value : hist->max;
+		}
+	}
+	return 0;
+}
+
+uint64_t histogram_max(Histogram hist) {
+	return hist->max;
+}
+
+void histogram_destroy(Histogram hist) {
+	free(hist);
+}
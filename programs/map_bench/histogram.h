@@ -0,0 +1,46 @@
+///////////////////////////////////////////////////////////////////
+//
+// Histogram
+//
+// Καταγράφει μεγάλο πλήθος τιμών (πχ διάρκειες σε ns) και δίνει τα
+// ποσοστημόρια τους (p50, p99, p99.9, ...) χωρίς να τις αποθηκεύει.
+// Όπως στα HDR histograms, κάθε δύναμη του 2 χωρίζεται σε ίσα
+// διαστήματα, οπότε το σχετικό σφάλμα είναι σταθερό (< 3%) για
+// οποιαδήποτε τιμή, από 1 ns μέχρι και λεπτά.
+//
+///////////////////////////////////////////////////////////////////
+
+#pragma once // #include το πολύ μία φορά
+
+#include <stdint.h>
+
+
+// Ένα histogram αναπαριστάται από τον τύπο Histogram
+
+typedef struct histogram* Histogram;
+
+
+// Δημιουργεί και επιστρέφει ένα κενό histogram
+
+Histogram histogram_create(void);
+
+// Καταγράφει την τιμή value
+
+void histogram_record(Histogram hist, uint64_t value);
+
+// Επιστρέφει το πλήθος των τιμών που έχουν καταγραφεί
+
+uint64_t histogram_count(Histogram hist);
+
+// Επιστρέφει (κατά προσέγγιση) την τιμή κάτω από την οποία βρίσκεται το ποσοστό percentile (0..100)
+// των τιμών που έχουν καταγραφεί, πχ histogram_percentile(hist, 99.9). Αν δεν υπάρχουν τιμές επιστρέφει 0.
+
+uint64_t histogram_percentile(Histogram hist, double percentile);
+
+// Επιστρέφει (ακριβώς) τη μέγιστη τιμή που έχει καταγραφεί
+
+uint64_t histogram_max(Histogram hist);
+
+// Ελευθερώνει όλη τη μνήμη που δεσμεύει το histogram
+
+void histogram_destroy(Histogram hist);
@@ -0,0 +1,482 @@
+//////////////////////////////////////////////////////////////////
+//
+// Benchmark για τον ADT Map.
+//
+// Το ίδιο πρόγραμμα γίνεται link με κάθε υλοποίηση (βλέπε Makefile),
+// και μετράει το throughput των βασικών πράξεων για διάφορα μεγέθη
+// και τύπους κλειδιών. Τα αποτελέσματα τυπώνονται σε CSV ή JSON
+// (ένα object ανά γραμμή), ώστε να συγκρίνονται εύκολα μεταξύ εκδόσεων.
+//
+// Εκτός από το throughput, κάθε πράξη εκτελείται και με χρονομέτρηση
+// της κάθε κλήσης χωριστά (σε ξεχωριστούς γύρους, ώστε η χρονομέτρηση να
+// μην επηρεάζει το throughput), και τυπώνονται τα p50/p99/p99.9/max σε ns.
+// Αυτά δείχνουν το κόστος των rehash, που χάνεται στους μέσους όρους.
+// Οι χρόνοι περιλαμβάνουν το κόστος της clock_gettime (~20 ns).
+//
+// Τύποι κλειδιών:
+//   int      ακέραιοι χωρίς κάποια σειρά
+//   seq      διαδοχικοί ακέραιοι (0, 1, 2, ...), πχ αύξοντα ids
+//   strided  πολλαπλάσια του STRIDE (είναι ints, οπότε μόνο για μεγέθη μέχρι INT_MAX / (2 * STRIDE), ~16M)
+//   ptr      διευθύνσεις διαδοχικών αντικειμένων των 16 bytes
+//   string   strings της μορφής "k123"
+//   url      strings της μορφής URL, 70-90 bytes
+// Με --hash mixed, χρησιμοποιούνται οι hash_int_mixed / hash_pointer_mixed / hash_string_fast αντί για
+// τις hash_int / hash_pointer / hash_string. Με --capacity pow2, τα maps χρησιμοποιούν χωρητικότητες
+// δυνάμεις του 2 αντί για πρώτους (βλέπε map_set_capacity_policy). Οι στήλες avg_probe και max_probe
+// δείχνουν τα probe lengths (βλέπε map_stats) μετά τις εισαγωγές.
+//
+// Χρήση:
+//   ./map_bench_<Υλοποίηση> [--sizes 1K,10K,1M] [--keys int,seq,strided,ptr,string,url]
+//                           [--hash plain,mixed] [--capacity prime,pow2] [--format csv|json]
+//                           [--no-header] [--no-latency] [--name <όνομα>]
+//
+//////////////////////////////////////////////////////////////////
+
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ADTMap.h"
+#include "histogram.h"
+
+
+// Για μικρά μεγέθη οι πράξεις διαρκούν πολύ λίγο για να μετρηθούν αξιόπιστα, οπότε κάθε
+// μέγεθος n επαναλαμβάνεται (με νέο map) ώστε κάθε πράξη να εκτελεστεί τουλάχιστον MIN_OPS φορές.
+#define MIN_OPS 1000000
+
+// Μέγιστο μήκος των κλειδιών τύπου string και url (μαζί με το '\0')
+#define STRING_KEY_SIZE 12
+#define URL_KEY_SIZE 96
+
+// Η απόσταση των κλειδιών τύπου strided
+#define STRIDE 64
+
+// Πόσα keys αναζητούνται με κάθε κλήση της map_find_batch
+#define FIND_BATCH_KEYS 256
+
+// Τα αντικείμενα των οποίων οι διευθύνσεις είναι τα κλειδιά τύπου ptr (16 bytes, όπως η ευθυγράμμιση της malloc)
+typedef struct {
+	char bytes[16];
+} Object;
+
+// Οι πράξεις που μετράμε, με τη σειρά που εκτελούνται σε κάθε map
+typedef enum {
+	INSERT, FIND_HIT, FIND_MISS, ITERATE, MIXED, REMOVE, INSERT_BATCH, FIND_BATCH, OPERATIONS
+} Operation;
+
+static const char* operation_names[] = {
+	"insert", "find_hit", "find_miss", "iterate", "mixed", "remove", "insert_batch", "find_batch"
+};
+
+static const char* policy_names[] = {
+	[MAP_CAPACITY_PRIME] = "prime", [MAP_CAPACITY_POW2] = "pow2"
+};
+
+// Ένα σύνολο από 2n κλειδιά ενός τύπου. Τα keys[0..n) εισάγονται στο map, τα keys[n..2n) όχι
+// (χρησιμοποιούνται για τις αποτυχημένες αναζητήσεις). Το order περιέχει τα keys[0..n) ανακατεμένα,
+// ώστε οι αναζητήσεις να μη γίνονται με τη σειρά της εισαγωγής.
+typedef struct {
+	const char* name;
+	const char* hash_name;		// Το όνομα της συνάρτησης κατακερματισμού
+	CompareFunc compare;
+	HashFunc hash;
+	Pointer* keys;
+	Pointer* order;
+	void* storage;				// Η μνήμη των ίδιων των κλειδιών
+} KeySet;
+
+// Οι ρυθμίσεις από τη γραμμή εντολών
+typedef struct {
+	const char* engine;
+	bool json;
+	bool header;
+	bool latency;				// Αν θα μετρηθεί και η διάρκεια κάθε κλήσης
+} Output;
+
+
+static int compare_ints(Pointer a, Pointer b) {
+	int x = *(int*)a, y = *(int*)b;
+	return (x > y) - (x < y);		// όχι x - y, που μπορεί να κάνει overflow
+}
+
+static int compare_strings(Pointer a, Pointer b) {
+	return strcmp(a, b);
+}
+
+static int compare_pointers(Pointer a, Pointer b) {
+	return (a > b) - (a < b);
+}
+
+// Απλός και γρήγορος γεννήτορας ψευδοτυχαίων αριθμών (xorshift), ώστε το rand() να μην επηρεάζει τις μετρήσεις
+static uint random_next(uint* state) {
+	uint x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+static double now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t now_ns(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+// Εκτελεί την εντολή call. Αν hist != NULL, χρονομετρεί την κλήση και καταγράφει τη διάρκειά της στο hist.
+#define TIMED(hist, call)							\
+	do {											\
+		if ((hist) != NULL) {						\
+			uint64_t timed_start = now_ns();		\
+			call;									\
+			histogram_record((hist), now_ns() - timed_start);	\
+		} else {									\
+			call;									\
+		}											\
+	} while (0)
+
+
+//////////////////////// Κλειδιά ////////////////////////
+
+// Ο αριθμός i * 2654435761 (mod 2^32) είναι διαφορετικός για κάθε i, αλλά χωρίς κάποια προφανή σειρά,
+// οπότε δίνει 2n μοναδικά "τυχαία" κλειδιά.
+static uint key_number(int i) {
+	return (uint)i * 2654435761u;
+}
+
+static void create_order(KeySet* set, int n) {
+	set->order = malloc(n * sizeof(Pointer));
+	memcpy(set->order, set->keys, n * sizeof(Pointer));
+
+	uint state = 12345;
+	for (int i = n - 1; i > 0; i--) {
+		int j = random_next(&state) % (i + 1);
+		Pointer t = set->order[i];
+		set->order[i] = set->order[j];
+		set->order[j] = t;
+	}
+}
+
+// Δημιουργεί 2n κλειδιά τύπου type. Αν mixed == true, χρησιμοποιούνται οι hash_int_mixed / hash_pointer_mixed.
+static KeySet create_keys(const char* type, bool mixed, int n) {
+	KeySet set = { .name = type, .keys = malloc(2 * (size_t)n * sizeof(Pointer)) };
+
+	if (strcmp(type, "ptr") == 0) {
+		Object* objects = malloc(2 * (size_t)n * sizeof(Object));
+		for (int i = 0; i < 2 * n; i++)
+			set.keys[i] = &objects[i];
+		set.storage = objects;
+		set.compare = compare_pointers;
+		set.hash = mixed ? hash_pointer_mixed : hash_pointer;
+		set.hash_name = mixed ? "hash_pointer_mixed" : "hash_pointer";
+
+	} else if (strcmp(type, "string") != 0 && strcmp(type, "url") != 0) {
+		int* ints = malloc(2 * (size_t)n * sizeof(int));
+		for (int i = 0; i < 2 * n; i++) {
+			ints[i] = strcmp(type, "seq") == 0 ? i : strcmp(type, "strided") == 0 ? i * STRIDE : (int)key_number(i);
+			set.keys[i] = &ints[i];
+		}
+		set.storage = ints;
+		set.compare = compare_ints;
+		set.hash = mixed ? hash_int_mixed : hash_int;
+		set.hash_name = mixed ? "hash_int_mixed" : "hash_int";
+
+	} else {
+		// Τα κλειδιά τύπου url έχουν κοινό πρόθεμα, όπως τα πραγματικά URLs ενός site
+		bool url = strcmp(type, "url") == 0;
+		int size = url ? URL_KEY_SIZE : STRING_KEY_SIZE;
+		char* strings = malloc(2 * (size_t)n * size);
+		for (int i = 0; i < 2 * n; i++) {
+			char* key = &strings[(size_t)i * size];
+			if (url)
+				snprintf(key, size, "https://www.example.com/api/v2/users/%u/documents/%d?format=json", key_number(i), i);
+			else
+				snprintf(key, size, "k%u", key_number(i));
+			set.keys[i] = key;
+		}
+		set.storage = strings;
+		set.compare = compare_strings;
+		set.hash = mixed ? hash_string_fast : hash_string;
+		set.hash_name = mixed ? "hash_string_fast" : "hash_string";
+	}
+
+	create_order(&set, n);
+	return set;
+}
+
+static void destroy_keys(KeySet* set) {
+	free(set->keys);
+	free(set->order);
+	free(set->storage);
+}
+
+
+//////////////////////// Μετρήσεις ////////////////////////
+
+// Εκτελεί όλες τις πράξεις σε ένα νέο map με n στοιχεία και πολιτική χωρητικότητας policy, προσθέτοντας
+// τη διάρκεια της καθεμίας στο seconds.
+// Αν hists != NULL, η διάρκεια κάθε κλήσης της πράξης op καταγράφεται επιπλέον στο hists[op], και
+// αν stats != NULL, συμπληρώνεται με τα στατιστικά του map μετά τις εισαγωγές.
+// Επιστρέφει το άθροισμα των values που βρέθηκαν, ώστε ο compiler να μην μπορεί να παραλείψει τις αναζητήσεις.
+static size_t run_round(KeySet* set, MapCapacityPolicy policy, int n, double seconds[], Histogram hists[], MapStats* stats) {
+	Histogram hist[OPERATIONS] = { NULL };
+	if (hists != NULL)
+		for (Operation op = 0; op < OPERATIONS; op++)
+			hist[op] = hists[op];
+
+	size_t checksum = 0;
+	Map map = map_create(set->compare, NULL, NULL);
+	map_set_hash_function(map, set->hash);
+	map_set_capacity_policy(map, policy);
+
+	double start = now();
+	for (int i = 0; i < n; i++)
+		TIMED(hist[INSERT], map_insert(map, set->keys[i], set->keys[i]));
+	seconds[INSERT] += now() - start;
+
+	if (stats != NULL)
+		map_stats(map, stats);
+
+	start = now();
+	for (int i = 0; i < n; i++)
+		TIMED(hist[FIND_HIT], checksum += (size_t)map_find(map, set->order[i]));
+	seconds[FIND_HIT] += now() - start;
+
+	// Οι ίδιες αναζητήσεις με τη map_find_batch, σε ομάδες των FIND_BATCH_KEYS (χωρίς ιστόγραμμα)
+	Pointer values[FIND_BATCH_KEYS];
+	start = now();
+	for (int i = 0; i < n; i += FIND_BATCH_KEYS) {
+		int count = n - i < FIND_BATCH_KEYS ? n - i : FIND_BATCH_KEYS;
+		map_find_batch(map, &set->order[i], values, count);
+		for (int j = 0; j < count; j++)
+			checksum += (size_t)values[j];
+	}
+	seconds[FIND_BATCH] += now() - start;
+
+	start = now();
+	for (int i = n; i < 2 * n; i++)
+		TIMED(hist[FIND_MISS], checksum += (size_t)map_find(map, set->keys[i]));
+	seconds[FIND_MISS] += now() - start;
+
+	// Χρονομετρούνται οι κλήσεις της map_first και της map_next
+	start = now();
+	MapNode node;
+	TIMED(hist[ITERATE], node = map_first(map));
+	while (node != MAP_EOF) {
+		checksum += (size_t)map_node_value(map, node);
+		TIMED(hist[ITERATE], node = map_next(map, node));
+	}
+	seconds[ITERATE] += now() - start;
+
+	// Μικτό φορτίο: 80% αναζητήσεις (επιτυχημένες ή όχι), 10% διαγραφές και 10% εισαγωγές
+	// τυχαίων κλειδιών, οπότε το μέγεθος του map μένει περίπου n.
+	uint state = 67890;
+	start = now();
+	for (int i = 0; i < n; i++) {
+		uint r = random_next(&state);
+		Pointer key = set->order[(r >> 4) % n];
+		switch (r % 10) {
+			case 8:  TIMED(hist[MIXED], map_remove(map, key)); break;
+			case 9:  TIMED(hist[MIXED], map_insert(map, key, key)); break;
+			default: TIMED(hist[MIXED], checksum += (size_t)map_find(map, key)); break;
+		}
+	}
+	seconds[MIXED] += now() - start;
+
+	start = now();
+	for (int i = 0; i < n; i++)
+		TIMED(hist[REMOVE], map_remove(map, set->order[i]));
+	seconds[REMOVE] += now() - start;
+
+	map_destroy(map);
+
+	// Οι ίδιες εισαγωγές σε ένα νέο map, με μία κλήση της map_insert_batch (χωρίς ιστόγραμμα, είναι μία μόνο κλήση)
+	map = map_create(set->compare, NULL, NULL);
+	map_set_hash_function(map, set->hash);
+	map_set_capacity_policy(map, policy);
+
+	start = now();
+	map_insert_batch(map, set->keys, set->keys, n);
+	seconds[INSERT_BATCH] += now() - start;
+
+	map_destroy(map);
+	return checksum;
+}
+
+// Τυπώνει τα αποτελέσματα μιας πράξης. Αν hist == NULL (--no-latency), τα ποσοστημόρια παραλείπονται.
+static void print_result(Output* out, KeySet* set, MapCapacityPolicy policy, int n, Operation op, long ops, double seconds, Histogram hist, MapStats* stats) {
+	double ns_per_op = seconds * 1e9 / ops;
+	double mops = ops / seconds / 1e6;
+
+	if (out->json)
+		printf("{\"engine\":\"%s\",\"keys\":\"%s\",\"hash\":\"%s\",\"capacity\":\"%s\",\"size\":%d,\"op\":\"%s\",\"ops\":%ld,\"seconds\":%.6f,\"ns_per_op\":%.2f,\"mops\":%.3f",
+			out->engine, set->name, set->hash_name, policy_names[policy], n, operation_names[op], ops, seconds, ns_per_op, mops);
+	else
+		printf("%s,%s,%s,%s,%d,%s,%ld,%.6f,%.2f,%.3f", out->engine, set->name, set->hash_name, policy_names[policy], n, operation_names[op], ops, seconds, ns_per_op, mops);
+
+	if (hist != NULL) {
+		uint64_t p50 = histogram_percentile(hist, 50), p99 = histogram_percentile(hist, 99);
+		uint64_t p999 = histogram_percentile(hist, 99.9), max = histogram_max(hist);
+		if (out->json)
+			printf(",\"p50_ns\":%llu,\"p99_ns\":%llu,\"p999_ns\":%llu,\"max_ns\":%llu",
+				(unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999, (unsigned long long)max);
+		else
+			printf(",%llu,%llu,%llu,%llu", (unsigned long long)p50, (unsigned long long)p99, (unsigned long long)p999, (unsigned long long)max);
+	} else if (!out->json) {
+		printf(",,,,");
+	}
+
+	// Ο μέσος όρος και το μέγιστο των probe lengths (η τελευταία θέση του ιστογράμματος μετράει ως MAP_STATS_HISTOGRAM - 1)
+	long total = 0;
+	int max_probe = 0;
+	for (int i = 0; i < MAP_STATS_HISTOGRAM; i++) {
+		total += (long)i * stats->probe_lengths[i];
+		if (stats->probe_lengths[i] > 0)
+			max_probe = i;
+	}
+	double avg_probe = stats->size > 0 ? (double)total / stats->size : 0;
+
+	if (out->json)
+		printf(",\"avg_probe\":%.3f,\"max_probe\":%d}\n", avg_probe, max_probe);
+	else
+		printf(",%.3f,%d\n", avg_probe, max_probe);
+	fflush(stdout);
+}
+
+static void run_benchmark(Output* out, const char* keys, bool mixed, MapCapacityPolicy policy, int n) {
+	KeySet set = create_keys(keys, mixed, n);
+
+	int rounds = (MIN_OPS + n - 1) / n;
+	double seconds[OPERATIONS] = { 0 };
+	size_t checksum = 0;
+	MapStats stats;
+	for (int r = 0; r < rounds; r++)
+		checksum += run_round(&set, policy, n, seconds, NULL, r == 0 ? &stats : NULL);
+
+	// Οι γύροι με χρονομέτρηση κάθε κλήσης, με το ίδιο πλήθος πράξεων
+	Histogram hists[OPERATIONS] = { NULL };
+	if (out->latency) {
+		double ignored[OPERATIONS] = { 0 };
+		for (Operation op = 0; op < OPERATIONS; op++)
+			if (op != INSERT_BATCH && op != FIND_BATCH)
+				hists[op] = histogram_create();
+		for (int r = 0; r < rounds; r++)
+			checksum += run_round(&set, policy, n, ignored, hists, NULL);
+	}
+
+	for (Operation op = 0; op < OPERATIONS; op++) {
+		print_result(out, &set, policy, n, op, (long)n * rounds, seconds[op], hists[op], &stats);
+		if (hists[op] != NULL)
+			histogram_destroy(hists[op]);
+	}
+
+	// Ο έλεγχος δεν αποτυγχάνει ποτέ στην πράξη, απλά "χρησιμοποιεί" το checksum
+	if (checksum == 1)
+		fprintf(stderr, "checksum\n");		// LCOV_EXCL_LINE
+
+	destroy_keys(&set);
+}
+
+
+//////////////////////// Γραμμή εντολών ////////////////////////
+
+// Μετατρέπει ένα μέγεθος της μορφής 1000, 10K, 100M σε αριθμό
+static int parse_size(const char* s) {
+	char* end;
+	long n = strtol(s, &end, 10);
+	if (*end == 'K' || *end == 'k')
+		n *= 1000;
+	else if (*end == 'M' || *end == 'm')
+		n *= 1000000;
+	return (int)n;
+}
+
+static void usage(const char* prog) {
+	fprintf(stderr, "usage: %s [--sizes 1K,10K,1M] [--keys int,seq,strided,ptr,string,url] [--hash plain,mixed]\n"
+		"       [--capacity prime,pow2] [--format csv|json] [--no-header] [--no-latency] [--name <name>]\n", prog);
+	exit(1);
+}
+
+int main(int argc, char* argv[]) {
+	// Το όνομα της υλοποίησης προκύπτει από το όνομα του εκτελέσιμου (map_bench_<Υλοποίηση>)
+	const char* engine = strrchr(argv[0], '/') != NULL ? strrchr(argv[0], '/') + 1 : argv[0];
+	if (strncmp(engine, "map_bench_", 10) == 0)
+		engine += 10;
+
+	Output out = { .engine = engine, .json = false, .header = true, .latency = true };
+	char sizes[256] = "1K,10K,100K,1M";
+	char keys[256] = "int,string";
+	char hashes[256] = "plain";
+	char policies[256] = "prime";
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--no-header") == 0)
+			out.header = false;
+		else if (strcmp(argv[i], "--no-latency") == 0)
+			out.latency = false;
+		else if (i + 1 == argc)
+			usage(argv[0]);
+		else if (strcmp(argv[i], "--sizes") == 0)
+			snprintf(sizes, sizeof(sizes), "%s", argv[++i]);
+		else if (strcmp(argv[i], "--keys") == 0)
+			snprintf(keys, sizeof(keys), "%s", argv[++i]);
+		else if (strcmp(argv[i], "--hash") == 0)
+			snprintf(hashes, sizeof(hashes), "%s", argv[++i]);
+		else if (strcmp(argv[i], "--capacity") == 0)
+			snprintf(policies, sizeof(policies), "%s", argv[++i]);
+		else if (strcmp(argv[i], "--name") == 0)
+			out.engine = argv[++i];
+		else if (strcmp(argv[i], "--format") == 0)
+			out.json = strcmp(argv[++i], "json") == 0;
+		else
+			usage(argv[0]);
+	}
+
+	if (out.header && !out.json)
+		printf("engine,keys,hash,capacity,size,op,ops,seconds,ns_per_op,mops,p50_ns,p99_ns,p999_ns,max_ns,avg_probe,max_probe\n");
+
+	bool plain = strstr(hashes, "plain") != NULL, mixed = strstr(hashes, "mixed") != NULL;
+	if (!plain && !mixed)
+		usage(argv[0]);
+
+	bool prime = strstr(policies, "prime") != NULL, pow2 = strstr(policies, "pow2") != NULL;
+	if (!prime && !pow2)
+		usage(argv[0]);
+
+	for (char* type = strtok(keys, ","); type != NULL; type = strtok(NULL, ",")) {
+		if (strcmp(type, "int") != 0 && strcmp(type, "seq") != 0 && strcmp(type, "strided") != 0 &&
+			strcmp(type, "ptr") != 0 && strcmp(type, "string") != 0 && strcmp(type, "url") != 0)
+			usage(argv[0]);
+
+		// Το strtok δεν μπορεί να χρησιμοποιηθεί σε δύο strings ταυτόχρονα, οπότε τα μεγέθη διασχίζονται με strchr
+		for (char* size = sizes; size != NULL; size = strchr(size, ',') != NULL ? strchr(size, ',') + 1 : NULL) {
+			int n = parse_size(size);
+			if (n <= 0)
+				usage(argv[0]);
+
+			// Τα 2n κλειδιά strided είναι i * STRIDE, για μεγαλύτερα n δε χωράνε σε int (και θα επαναλαμβάνονταν)
+			if (strcmp(type, "strided") == 0 && 2 * (long)n * STRIDE > INT_MAX) {
+				fprintf(stderr, "%s: strided keys support sizes up to %d\n", argv[0], INT_MAX / (2 * STRIDE));
+				exit(1);
+			}
+
+			for (MapCapacityPolicy policy = MAP_CAPACITY_PRIME; policy <= MAP_CAPACITY_POW2; policy++) {
+				if (policy == MAP_CAPACITY_PRIME ? !prime : !pow2)
+					continue;
+				if (plain)
+					run_benchmark(&out, type, false, policy, n);
+				if (mixed)
+					run_benchmark(&out, type, true, policy, n);
+			}
+		}
+	}
+
+	return 0;
+}
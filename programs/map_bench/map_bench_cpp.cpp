@@ -0,0 +1,257 @@
+//////////////////////////////////////////////////////////////////
+//
+// Benchmark για το adt::HashMap (include/adt_map.hpp).
+//
+// Μετράει τις βασικές πράξεις ενός map int => int με κάθε Policy του
+// adt::HashMap, με το ADT Map σε C (η υλοποίηση CPP_BENCH_ENGINE, βλέπε
+// Makefile, με keys και values τύπου int* και hash_int_mixed), και με το
+// std::unordered_map. Τα κλειδιά είναι ακέραιοι χωρίς κάποια σειρά, όπως
+// τα κλειδιά int του map_bench, και τα αποτελέσματα τυπώνονται σε CSV ή JSON.
+//
+// Χρήση:
+//   ./map_bench_cpp [--sizes 1K,10K,1M] [--format csv|json] [--no-header]
+//
+//////////////////////////////////////////////////////////////////
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "adt_map.hpp"
+
+extern "C" {
+#include "ADTMap.h"
+}
+
+#ifndef CPP_BENCH_ENGINE
+#define CPP_BENCH_ENGINE "UsingHashTable"
+#endif
+
+
+// Όπως στο map_bench, κάθε μέγεθος n επαναλαμβάνεται ώστε κάθε πράξη να εκτελεστεί τουλάχιστον MIN_OPS φορές
+#define MIN_OPS 1000000
+
+// Οι πράξεις που μετράμε, με τη σειρά που εκτελούνται σε κάθε map
+enum Operation {
+	INSERT, FIND_HIT, FIND_MISS, ITERATE, REMOVE, OPERATIONS
+};
+
+static const char* operation_names[] = {
+	"insert", "find_hit", "find_miss", "iterate", "remove"
+};
+
+// Τα κλειδιά: τα keys[0..n) εισάγονται στο map, τα keys[n..2n) όχι, και το order περιέχει τα keys[0..n) ανακατεμένα
+struct KeySet {
+	std::vector<int> keys;
+	std::vector<int> order;
+};
+
+static uint key_number(int i) {
+	return (uint)i * 2654435761u;
+}
+
+static uint random_next(uint* state) {
+	uint x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+static double now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static KeySet create_keys(int n) {
+	KeySet set;
+	for (int i = 0; i < 2 * n; i++)
+		set.keys.push_back((int)key_number(i));
+
+	set.order.assign(set.keys.begin(), set.keys.begin() + n);
+	uint state = 12345;
+	for (int i = n - 1; i > 0; i--)
+		std::swap(set.order[i], set.order[random_next(&state) % (i + 1)]);
+	return set;
+}
+
+static int compare_ints(Pointer a, Pointer b) {
+	int x = *(int*)a, y = *(int*)b;
+	return (x > y) - (x < y);
+}
+
+// Οι πράξεις κάθε υλοποίησης, ώστε η run_rounds να είναι κοινή. Τα values είναι ίσα με τα keys, οπότε
+// το άθροισμα των τιμών που βρίσκουν οι αναζητήσεις (checksum) πρέπει να είναι ίδιο σε όλες τις υλοποιήσεις.
+
+template <class Policy>
+struct CppMap {
+	adt::HashMap<int, int, std::hash<int>, std::equal_to<int>, Policy> map;
+
+	void insert(int& key) { map.insert_or_assign(key, key); }
+	long find(int& key) { const int* value = map.find_value(key); return value != nullptr ? *value : 0; }
+	void remove(int& key) { map.erase(key); }
+
+	long iterate() {
+		long sum = 0;
+		for (auto& [key, value] : map)
+			sum += value;
+		return sum;
+	}
+};
+
+struct StdMap {
+	std::unordered_map<int, int> map;
+
+	void insert(int& key) { map.insert_or_assign(key, key); }
+	long find(int& key) { auto it = map.find(key); return it != map.end() ? it->second : 0; }
+	void remove(int& key) { map.erase(key); }
+
+	long iterate() {
+		long sum = 0;
+		for (auto& [key, value] : map)
+			sum += value;
+		return sum;
+	}
+};
+
+// Το ADT Map δεν αντιγράφει τα keys, οπότε χρησιμοποιεί απευθείας τους ακέραιους του KeySet ως key και value
+struct CMap {
+	Map map;
+
+	CMap() : map(map_create(compare_ints, NULL, NULL)) { map_set_hash_function(map, hash_int_mixed); }
+	~CMap() { map_destroy(map); }
+
+	void insert(int& key) { map_insert(map, &key, &key); }
+	long find(int& key) { int* value = (int*)map_find(map, &key); return value != NULL ? *value : 0; }
+	void remove(int& key) { map_remove(map, &key); }
+
+	long iterate() {
+		long sum = 0;
+		for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node))
+			sum += *(int*)map_node_value(map, node);
+		return sum;
+	}
+};
+
+// Εκτελεί όλες τις πράξεις σε rounds νέα maps, προσθέτει τους χρόνους στο seconds και επιστρέφει το checksum
+template <class M>
+static long run_rounds(KeySet& set, int n, int rounds, double seconds[]) {
+	long checksum = 0;
+	for (int round = 0; round < rounds; round++) {
+		M m;
+
+		double start = now();
+		for (int i = 0; i < n; i++)
+			m.insert(set.keys[i]);
+		seconds[INSERT] += now() - start;
+
+		start = now();
+		for (int i = 0; i < n; i++)
+			checksum += m.find(set.order[i]);
+		seconds[FIND_HIT] += now() - start;
+
+		start = now();
+		for (int i = n; i < 2 * n; i++)
+			checksum += m.find(set.keys[i]);
+		seconds[FIND_MISS] += now() - start;
+
+		start = now();
+		checksum += m.iterate();
+		seconds[ITERATE] += now() - start;
+
+		start = now();
+		for (int i = 0; i < n; i++)
+			m.remove(set.order[i]);
+		seconds[REMOVE] += now() - start;
+	}
+	return checksum;
+}
+
+static void print_result(const char* engine, bool json, int n, Operation op, long ops, double seconds) {
+	double ns_per_op = seconds * 1e9 / ops;
+	double mops = ops / seconds / 1e6;
+
+	if (json)
+		printf("{\"engine\":\"%s\",\"keys\":\"int\",\"size\":%d,\"op\":\"%s\",\"ops\":%ld,\"seconds\":%.6f,\"ns_per_op\":%.2f,\"mops\":%.3f}\n",
+			engine, n, operation_names[op], ops, seconds, ns_per_op, mops);
+	else
+		printf("%s,int,%d,%s,%ld,%.6f,%.2f,%.3f\n", engine, n, operation_names[op], ops, seconds, ns_per_op, mops);
+}
+
+template <class M>
+static void run_benchmark(const char* engine, bool json, KeySet& set, int n, long expected) {
+	int rounds = n >= MIN_OPS ? 1 : (MIN_OPS + n - 1) / n;
+	double seconds[OPERATIONS] = {0};
+
+	if (run_rounds<M>(set, n, rounds, seconds) != expected) {
+		fprintf(stderr, "%s: checksum\n", engine);		// LCOV_EXCL_LINE
+		exit(1);										// LCOV_EXCL_LINE
+	}
+
+	for (int op = 0; op < OPERATIONS; op++)
+		print_result(engine, json, n, (Operation)op, (long)rounds * n, seconds[op]);
+}
+
+static int parse_size(const char* str) {
+	char* end;
+	long n = strtol(str, &end, 10);
+	if (*end == 'K' || *end == 'k')
+		n *= 1000;
+	else if (*end == 'M' || *end == 'm')
+		n *= 1000000;
+	return (int)n;
+}
+
+static void usage(const char* prog) {
+	fprintf(stderr, "usage: %s [--sizes 1K,10K,1M] [--format csv|json] [--no-header]\n", prog);
+	exit(1);
+}
+
+int main(int argc, char* argv[]) {
+	std::string sizes = "1K,10K,100K,1M";
+	bool json = false, header = true;
+
+	for (int i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--no-header") == 0)
+			header = false;
+		else if (i + 1 == argc)
+			usage(argv[0]);
+		else if (strcmp(argv[i], "--sizes") == 0)
+			sizes = argv[++i];
+		else if (strcmp(argv[i], "--format") == 0)
+			json = strcmp(argv[++i], "json") == 0;
+		else
+			usage(argv[0]);
+	}
+
+	if (header && !json)
+		printf("engine,keys,size,op,ops,seconds,ns_per_op,mops\n");
+
+	for (const char* size = sizes.c_str(); size != NULL; size = strchr(size, ',') != NULL ? strchr(size, ',') + 1 : NULL) {
+		int n = parse_size(size);
+		if (n <= 0)
+			usage(argv[0]);
+
+		KeySet set = create_keys(n);
+		int rounds = n >= MIN_OPS ? 1 : (MIN_OPS + n - 1) / n;
+
+		// Σε κάθε γύρο: οι επιτυχημένες αναζητήσεις και η διάσχιση βρίσκουν όλα τα values (οι αποτυχημένες 0)
+		long expected = 0;
+		for (int i = 0; i < n; i++)
+			expected += set.keys[i];
+		expected *= 2L * rounds;
+
+		run_benchmark<CppMap<adt::LinearProbing>>("adt::LinearProbing", json, set, n, expected);
+		run_benchmark<CppMap<adt::Hopscotch>>("adt::Hopscotch", json, set, n, expected);
+		run_benchmark<CppMap<adt::Hybrid>>("adt::Hybrid", json, set, n, expected);
+		run_benchmark<CMap>(CPP_BENCH_ENGINE, json, set, n, expected);
+		run_benchmark<StdMap>("std::unordered_map", json, set, n, expected);
+	}
+
+	return 0;
+}
@@ -8,6 +8,7 @@
 #include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
 #include <stdio.h>
 #include "ADTMap.h"
+#include "ADTMapType.h"
 
 
 // Δημιουργούμε μια ειδική compare συνάρτηση
@@ -417,6 +418,589 @@ void test_combined2(void) {
 	free(inserted);
 }
 
+// Δημιουργούμε μια compare συνάρτηση για pointers (ίσοι μόνο αν δείχνουν στο ίδιο αντικείμενο)
+int compare_pointers(Pointer a, Pointer b) {
+	return (a > b) - (a < b);
+}
+
+void test_mixed_hash(void) {
+	// Διαδοχικοί ακέραιοι, που με την hash_int θα ήταν σε διαδοχικές θέσεις
+	int N = 1000;
+	int keys[N];
+	Map map = map_create(compare_ints, NULL, NULL);
+	map_set_hash_function(map, hash_int_mixed);
+	for (int i = 0; i < N; i++) {
+		keys[i] = i;
+		insert_and_test(map, &keys[i], &keys[i]);
+	}
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(map_find(map, &i) == &keys[i]);
+
+	// Ίδια τιμή σε διαφορετική μνήμη δίνει ίδιο hash code
+	TEST_ASSERT(hash_int_mixed(&keys[5]) == hash_int_mixed(&(int){5}));
+	map_destroy(map);
+
+	// Οι διευθύνσεις των στοιχείων του keys ως κλειδιά
+	map = map_create(compare_pointers, NULL, NULL);
+	map_set_hash_function(map, hash_pointer_mixed);
+	for (int i = 0; i < N; i++)
+		insert_and_test(map, &keys[i], &keys[i]);
+	TEST_ASSERT(map_size(map) == N);
+	map_destroy(map);
+}
+
+void test_string_hash(void) {
+	// Strings όλων των μηκών μέχρι 200, ώστε να ελεγχθούν όλες οι περιπτώσεις της hash_string_fast
+	int N = 200;
+	char* strings[N + 1];
+	Map map = map_create((CompareFunc)strcmp, free, NULL);
+	map_set_hash_function(map, hash_string_fast);
+	for (int i = 0; i <= N; i++) {
+		strings[i] = malloc(i + 1);
+		for (int j = 0; j < i; j++)
+			strings[i][j] = 'a' + (i + j) % 26;
+		strings[i][i] = '\0';
+		insert_and_test(map, strings[i], strings[i]);
+
+		TEST_ASSERT(hash_string_len(strings[i], i) == hash_string_fast(strings[i]));
+	}
+	TEST_ASSERT(map_size(map) == N + 1);
+
+	// Το hash code εξαρτάται μόνο από τα περιεχόμενα του string
+	char copy[] = "abcdefghijklmnopqrstuvwxyz";
+	TEST_ASSERT(hash_string_fast(copy) == hash_string_fast("abcdefghijklmnopqrstuvwxyz"));
+	TEST_ASSERT(map_find(map, "") == strings[0]);
+
+	map_destroy(map);
+}
+
+// Συνάρτηση κατακερματισμού 64 bits της οποίας τα χαμηλά 32 bits είναι ίδια για όλα τα keys, ώστε
+// το map να λειτουργεί σωστά μόνο αν χρησιμοποιεί και τα υψηλά bits
+uint64_t hash_int_high(Pointer value) {
+	return (uint64_t)hash_int_mixed(value) << 32;
+}
+
+void test_hash64(void) {
+	int N = 1000;
+	int keys[N];
+	HashFunc64 hash_funcs[] = { hash_int64, hash_int_high };
+	for (int f = 0; f < 2; f++) {
+		Map map = map_create(compare_ints, NULL, NULL);
+		map_set_hash_function64(map, hash_funcs[f]);
+		for (int i = 0; i < N; i++) {
+			keys[i] = i;
+			insert_and_test(map, &keys[i], &keys[i]);
+		}
+		TEST_ASSERT(map_size64(map) == N);
+		for (int i = 0; i < N; i++)
+			TEST_ASSERT(map_find(map, &i) == &keys[i]);
+
+		for (int i = 0; i < N; i += 2)
+			TEST_ASSERT(map_remove(map, &keys[i]));
+		TEST_ASSERT(map_size64(map) == N / 2 && map_size(map) == N / 2);
+		for (int i = 0; i < N; i++)
+			TEST_ASSERT(map_find(map, &i) == (i % 2 ? &keys[i] : NULL));
+		map_destroy(map);
+	}
+
+	// Ίδια τιμή σε διαφορετική μνήμη δίνει ίδιο hash code
+	TEST_ASSERT(hash_int64(&keys[5]) == hash_int64(&(int){5}));
+	char copy[] = "abcdefghijklmnopqrstuvwxyz";
+	TEST_ASSERT(hash_string64(copy) == hash_string64("abcdefghijklmnopqrstuvwxyz"));
+	TEST_ASSERT(hash_string_len64(copy, 26) == hash_string64(copy));
+
+	// Η map_set_hash_function αντικαθιστά τη συνάρτηση 64 bits
+	Map map = map_create(compare_pointers, NULL, NULL);
+	map_set_hash_function64(map, hash_int64);
+	map_set_hash_function(map, hash_pointer);
+	map_set_hash_function64(map, hash_pointer64);
+	for (int i = 0; i < N; i++)
+		insert_and_test(map, &keys[i], &keys[i]);
+	TEST_ASSERT(map_size64(map) == N);
+	map_destroy(map);
+
+	map = map_create(compare_ints, NULL, NULL);
+	map_set_hash_function64(map, hash_int64);
+	map_set_hash_function(map, hash_int);
+	insert_and_test(map, &keys[1], &keys[1]);
+	TEST_ASSERT(map_find(map, &keys[1]) == &keys[1]);
+	map_destroy(map);
+}
+
+// Ελέγχει ότι τα στατιστικά του map συμφωνούν με τα περιεχόμενά του
+void check_stats(Map map) {
+	MapStats stats;
+	map_stats(map, &stats);
+
+	TEST_ASSERT(stats.size == map_size(map));
+	TEST_ASSERT(stats.capacity >= stats.size);
+	TEST_ASSERT(stats.load_factor == (double)stats.size / stats.capacity);
+	TEST_ASSERT(stats.bytes > 0);
+
+	// Κάθε στοιχείο έχει ένα probe length
+	int total = 0;
+	for (int i = 0; i < MAP_STATS_HISTOGRAM; i++)
+		total += stats.probe_lengths[i];
+	TEST_ASSERT(total == stats.size);
+}
+
+void test_stats(void) {
+	Map map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_int);
+
+	MapStats stats;
+	map_stats(map, &stats);
+	TEST_ASSERT(stats.size == 0 && stats.rehashes == 0);
+	check_stats(map);
+
+	int N = 10000;
+	for (int i = 0; i < N; i++)
+		map_insert(map, create_int(i), NULL);
+	check_stats(map);
+
+	// Τόσα στοιχεία δε χωράνε στον αρχικό πίνακα
+	map_stats(map, &stats);
+	TEST_ASSERT(stats.rehashes > 0);
+
+	for (int i = 0; i < N; i += 2)
+		map_remove(map, &i);
+	check_stats(map);
+
+	map_destroy(map);
+}
+
+void test_capacity_policy(void) {
+	int N = 10000;
+	Map map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_int);
+	map_set_capacity_policy(map, MAP_CAPACITY_POW2);
+
+	// Διαδοχικοί ακέραιοι, που με την hash_int διαφέρουν μόνο στα χαμηλά bits
+	for (int i = 0; i < N; i++)
+		map_insert(map, create_int(i), NULL);
+	TEST_ASSERT(map_size(map) == N);
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(map_find_node(map, &i) != MAP_EOF);
+	check_stats(map);
+
+	MapStats stats;
+	map_stats(map, &stats);
+	TEST_ASSERT((stats.capacity & (stats.capacity - 1)) == 0);
+
+	// Σε map με στοιχεία η πολιτική δεν αλλάζει, και τα στοιχεία διατηρούνται
+	map_set_capacity_policy(map, MAP_CAPACITY_PRIME);
+	TEST_ASSERT(map_size(map) == N);
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(map_find_node(map, &i) != MAP_EOF);
+
+	for (int i = 0; i < N; i += 2)
+		TEST_ASSERT(map_remove(map, &i));
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT((map_find_node(map, &i) != MAP_EOF) == (i % 2 == 1));
+	check_stats(map);
+
+	map_destroy(map);
+}
+
+// Εισάγει στο map τους ακεραίους [from, to) και ελέγχει ότι δεν έγινε κανένα rehash
+void insert_without_rehash(Map map, int from, int to) {
+	MapStats before, after;
+	map_stats(map, &before);
+	for (int i = from; i < to; i++)
+		map_insert(map, create_int(i), NULL);
+	map_stats(map, &after);
+
+	TEST_ASSERT(after.rehashes == before.rehashes);
+	TEST_ASSERT(after.capacity == before.capacity);
+}
+
+void test_reserve(void) {
+	int N = 10000;
+	Map map = map_create_sized(compare_ints, free, NULL, N);
+	map_set_hash_function(map, hash_int_mixed);
+	insert_without_rehash(map, 0, N);
+	TEST_ASSERT(map_size(map) == N);
+	map_destroy(map);
+
+	// Ο χώρος διατηρείται και με αλλαγή πολιτικής χωρητικότητας
+	map = map_create_sized(compare_ints, free, NULL, N);
+	map_set_hash_function(map, hash_int_mixed);
+	map_set_capacity_policy(map, MAP_CAPACITY_POW2);
+	insert_without_rehash(map, 0, N);
+	map_destroy(map);
+
+	// map_reserve σε map που έχει ήδη στοιχεία
+	map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_int_mixed);
+	for (int i = 0; i < 100; i++)
+		map_insert(map, create_int(i), NULL);
+	map_reserve(map, N);
+	map_reserve(map, 10);		// μικρότερο μέγεθος, δεν αλλάζει τίποτα
+	for (int i = 0; i < 100; i++)
+		TEST_ASSERT(map_find_node(map, &i) != MAP_EOF);
+	check_stats(map);
+
+	insert_without_rehash(map, 100, N);
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(map_find_node(map, &i) != MAP_EOF);
+	check_stats(map);
+	map_destroy(map);
+}
+
+void test_insert_batch(void) {
+	int N = 1000;
+	Map map = map_create(compare_ints, free, free);
+	map_set_hash_function(map, hash_int_mixed);
+	map_insert(map, create_int(0), create_int(-1));		// θα αντικατασταθεί από τη map_insert_batch
+
+	// Το key 5 εμφανίζεται δύο φορές, ισχύει η τελευταία εισαγωγή
+	Pointer* keys = malloc((N + 1) * sizeof(Pointer));
+	Pointer* values = malloc((N + 1) * sizeof(Pointer));
+	for (int i = 0; i < N; i++) {
+		keys[i] = create_int(i);
+		values[i] = create_int(i);
+	}
+	keys[N] = create_int(5);
+	values[N] = create_int(-5);
+
+	map_insert_batch(map, keys, values, N + 1);
+	TEST_ASSERT(map_size(map) == N);
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(*(int*)map_find(map, &i) == (i == 5 ? -5 : i));
+	check_stats(map);
+	map_destroy(map);
+
+	// Χωρίς values, και με n == 0
+	map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_int);
+	for (int i = 0; i < N; i++)
+		keys[i] = create_int(i);
+	map_insert_batch(map, keys, NULL, N);
+	map_insert_batch(map, keys, NULL, 0);
+	TEST_ASSERT(map_size(map) == N);
+	for (int i = 0; i < N; i++) {
+		MapNode node = map_find_node(map, &i);
+		TEST_ASSERT(node != MAP_EOF && map_node_value(map, node) == NULL);
+	}
+	map_destroy(map);
+
+	free(keys);
+	free(values);
+}
+
+// Ελέγχει ότι τα αποτελέσματα της map_find_batch ταυτίζονται με αυτά της map_find
+void check_find_batch(Map map, Pointer* keys, int n) {
+	Pointer* values = malloc(n * sizeof(Pointer));
+	map_find_batch(map, keys, values, n);
+	for (int i = 0; i < n; i++)
+		TEST_ASSERT(values[i] == map_find(map, keys[i]));
+	free(values);
+}
+
+void test_find_batch(void) {
+	int N = 1000;
+	int* numbers = malloc(2 * N * sizeof(int));
+	Pointer* keys = malloc(2 * N * sizeof(Pointer));
+	for (int i = 0; i < 2 * N; i++) {
+		numbers[i] = i;
+		keys[i] = &numbers[i];
+	}
+
+	HashFunc hash_functions[] = { hash_int, hash_int_mixed };
+	for (int h = 0; h < 2; h++) {
+		Map map = map_create(compare_ints, free, NULL);
+		map_set_hash_function(map, hash_functions[h]);
+
+		// Τα keys [N, 2N) δεν υπάρχουν ποτέ στο map. Ελέγχουμε και ενώ γίνονται rehash.
+		for (int i = 0; i < N; i++) {
+			map_insert(map, create_int(i), &numbers[i]);
+			if (i % 97 == 0)
+				check_find_batch(map, keys, 2 * N);
+		}
+
+		// Με διαγραμμένα στοιχεία, και με n == 0
+		for (int i = 0; i < N; i += 2)
+			map_remove(map, &i);
+		check_find_batch(map, keys, 2 * N);
+		check_find_batch(map, keys, 0);
+
+		map_destroy(map);
+	}
+
+	free(keys);
+	free(numbers);
+}
+
+// Διασχίζει το map ελέγχοντας ότι κάθε key [0, n) εμφανίζεται μία φορά, και ότι η map_next
+// δίνει τον ίδιο επόμενο κόμβο και όταν καλείται για κόμβους εκτός σειράς
+void check_iteration(Map map, int n) {
+	MapNode* nodes = malloc(n * sizeof(MapNode));
+	bool* seen = calloc(n, sizeof(bool));
+	int count = 0;
+	for (MapNode node = map_first(map); node != MAP_EOF; node = map_next(map, node)) {
+		int key = *(int*)map_node_key(map, node);
+		TEST_ASSERT(key >= 0 && key < n && !seen[key]);
+		seen[key] = true;
+		nodes[count++] = node;
+	}
+	TEST_ASSERT(count == n);
+
+	for (int i = n - 2; i >= 0; i -= 7)
+		TEST_ASSERT(map_next(map, nodes[i]) == nodes[i + 1]);
+	TEST_ASSERT(map_next(map, nodes[n - 1]) == MAP_EOF);
+
+	free(nodes);
+	free(seen);
+}
+
+void test_iterate_cursor(void) {
+	Map map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_int_mixed);
+
+	// Τα 3080 στοιχεία είναι λίγο μετά από rehash (στις υλοποιήσεις με σταδιακό rehash, ενώ αυτό είναι σε εξέλιξη)
+	int sizes[] = { 1, 100, 3080, 5000 };
+	int n = 0;
+	for (int s = 0; s < 4; s++) {
+		for (; n < sizes[s]; n++)
+			map_insert(map, create_int(n), NULL);
+		check_iteration(map, n);
+	}
+
+	// Με διαγραμμένα στοιχεία
+	for (int i = n / 2; i < n; i++)
+		map_remove(map, &i);
+	check_iteration(map, n / 2);
+
+	map_destroy(map);
+}
+
+void test_iterate_sparse(void) {
+	Map map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_int_mixed);
+
+	// Ένας μεγάλος πίνακας με ελάχιστα στοιχεία (οι κενές θέσεις προσπερνιούνται από το bitmap)
+	int n = 20000;
+	for (int i = 0; i < n; i++)
+		map_insert(map, create_int(i), NULL);
+	for (int i = 10; i < n; i++)
+		map_remove(map, &i);
+	check_iteration(map, 10);
+
+	// Χωρίς κανένα στοιχείο
+	for (int i = 0; i < 10; i++)
+		map_remove(map, &i);
+	TEST_ASSERT(map_first(map) == MAP_EOF);
+
+	// Οι θέσεις που ξαναγεμίζουν εμφανίζονται πάλι στη διάσχιση
+	for (int i = 0; i < 100; i++)
+		map_insert(map, create_int(i), NULL);
+	check_iteration(map, 100);
+
+	map_destroy(map);
+}
+
+void test_shrink(void) {
+	int N = 10000;
+	Map map = map_create(compare_ints, free, NULL);
+	map_set_hash_function(map, hash_int_mixed);
+	for (int i = 0; i < N; i++)
+		map_insert(map, create_int(i), NULL);
+
+	MapStats full, stats;
+	map_stats(map, &full);
+
+	// Μετά από τη διαγραφή των περισσότερων στοιχείων ο πίνακας μικραίνει αυτόματα
+	int n = 500;
+	for (int i = n; i < N; i++)
+		TEST_ASSERT(map_remove(map, &i));
+	map_stats(map, &stats);
+	TEST_ASSERT(stats.capacity < full.capacity);
+	check_iteration(map, n);
+	check_stats(map);
+
+	// Η map_compact δε μεγαλώνει τον πίνακα, και αφαιρεί τις διαγραμμένες θέσεις
+	for (int i = n / 2; i < n; i++)
+		TEST_ASSERT(map_remove(map, &i));
+	n /= 2;
+	MapStats before;
+	map_stats(map, &before);
+	map_compact(map);
+	map_stats(map, &stats);
+	TEST_ASSERT(stats.capacity <= before.capacity);
+	TEST_ASSERT(stats.tombstones == 0);
+	for (int i = 0; i < n; i++)
+		TEST_ASSERT(map_find_node(map, &i) != MAP_EOF);
+	check_iteration(map, n);
+	check_stats(map);
+
+	// Το map λειτουργεί κανονικά μετά τη map_compact
+	for (int i = n; i < N; i++)
+		map_insert(map, create_int(i), NULL);
+	check_iteration(map, N);
+	map_destroy(map);
+
+	// Ο χώρος της map_reserve διατηρείται μετά από διαγραφές
+	map = map_create_sized(compare_ints, free, NULL, N);
+	map_set_hash_function(map, hash_int_mixed);
+	map_stats(map, &before);
+	for (int i = 0; i < 10; i++)
+		map_insert(map, create_int(i), NULL);
+	for (int i = 0; i < 5; i++)
+		TEST_ASSERT(map_remove(map, &i));
+	map_stats(map, &stats);
+	TEST_ASSERT(stats.capacity == before.capacity);
+
+	// Κενό map
+	for (int i = 5; i < 10; i++)
+		TEST_ASSERT(map_remove(map, &i));
+	map_compact(map);
+	TEST_ASSERT(map_size(map) == 0 && map_first(map) == MAP_EOF);
+	map_destroy(map);
+}
+
+// Ο typed map δεν εξαρτάται από την υλοποίηση του ADT Map, αλλά ελέγχεται μαζί του
+MAP_TYPE_DECLARE(IntMap, int, int, MAP_TYPE_HASH_INT, MAP_TYPE_EQ)
+
+void test_typed_map(void) {
+	int N = 10000;
+	IntMap map = IntMap_create();
+	TEST_ASSERT(IntMap_size(map) == 0);
+	TEST_ASSERT(IntMap_find(map, 0) == NULL);
+
+	for (int i = 0; i < N; i++)
+		IntMap_insert(map, i, i);
+	for (int i = 0; i < N; i++)
+		IntMap_insert(map, i, 2 * i);		// αντικατάσταση
+	TEST_ASSERT(IntMap_size(map) == N);
+
+	for (int i = 0; i < N; i++) {
+		int* value = IntMap_find(map, i);
+		TEST_ASSERT(value != NULL && *value == 2 * i);
+	}
+	TEST_ASSERT(IntMap_find(map, N) == NULL);
+
+	// Διαγραφή των περισσότερων στοιχείων, ο πίνακας μικραίνει
+	size_t capacity = map->capacity;
+	int n = 500;
+	for (int i = n; i < N; i++)
+		TEST_ASSERT(IntMap_remove(map, i));
+	TEST_ASSERT(!IntMap_remove(map, N));
+	TEST_ASSERT(IntMap_size(map) == n);
+	TEST_ASSERT(map->capacity < capacity);
+
+	// Η διάσχιση επισκέπτεται κάθε στοιχείο μία φορά
+	long sum = 0;
+	int count = 0;
+	for (IntMapNode node = IntMap_first(map); node != NULL; node = IntMap_next(map, node)) {
+		TEST_ASSERT(node->value == 2 * node->key && IntMap_find(map, node->key) != NULL);
+		sum += node->key;
+		count++;
+	}
+	TEST_ASSERT(count == n && sum == (long)n * (n - 1) / 2);
+
+	// Μετά από reserve δε γίνεται rehash ούτε προς τα πάνω ούτε προς τα κάτω
+	IntMap_reserve(map, N);
+	capacity = map->capacity;
+	for (int i = n; i < N; i++)
+		IntMap_insert(map, i, i);
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(IntMap_remove(map, i));
+	TEST_ASSERT(map->capacity == capacity && IntMap_size(map) == 0);
+	TEST_ASSERT(IntMap_first(map) == NULL);
+
+	IntMap_destroy(map);
+}
+
+
+// Με οποιαδήποτε γειτονιά (και τιμές εκτός ορίων) το map λειτουργεί κανονικά, αλλαγή μετά από εισαγωγές αγνοείται.
+// Ο load factor ελέγχεται, ώστε μια γειτονιά που χωράει λίγα keys να μη δεσμεύει αθόρυβα τεράστιο πίνακα.
+void test_neighbourhood(void) {
+	int sizes[] = { -1, 16, 24, 32, 100 };
+	int N = 20000;
+	for (int s = 0; s < 5; s++) {
+		Map map = map_create(compare_ints, free, NULL);
+		map_set_hash_function(map, hash_int_mixed);
+		map_set_neighbourhood(map, sizes[s]);
+
+		for (int i = 0; i < N; i++) {
+			map_insert(map, create_int(i), NULL);
+			if (i == N / 2)
+				map_set_neighbourhood(map, 1);
+		}
+		TEST_ASSERT(map_size(map) == N);
+
+		MapStats stats;
+		map_stats(map, &stats);
+		TEST_ASSERT(stats.load_factor >= 0.35);
+		for (int i = 0; i < N; i++)
+			TEST_ASSERT(map_find_node(map, &i) != MAP_EOF);
+		for (int i = 0; i < N; i += 2)
+			TEST_ASSERT(map_remove(map, &i));
+		TEST_ASSERT(map_size(map) == N / 2);
+		check_stats(map);
+		map_destroy(map);
+	}
+}
+
+// Η CreateValueFunc της test_find_or_insert: μετράει τις κλήσεις της
+static int created_values = 0;
+
+static Pointer create_zero(Pointer key) {
+	created_values++;
+	return create_int(0);
+}
+
+void test_find_or_insert(void) {
+	int N = 5000;
+	Map map = map_create(compare_ints, free, free);
+	map_set_hash_function(map, hash_int_mixed);
+
+	// Νέα keys: ο κόμβος περιέχει το ίδιο το key, και η create_value καλείται μία φορά για καθένα
+	created_values = 0;
+	for (int i = 0; i < N; i++) {
+		bool inserted = false;
+		int* key = create_int(i);
+		MapNode node = map_find_or_insert_with(map, key, create_zero, &inserted);
+		TEST_ASSERT(inserted);
+		TEST_ASSERT(map_node_key(map, node) == key);
+		TEST_ASSERT(*(int*)map_node_value(map, node) == 0);
+	}
+	TEST_ASSERT(created_values == N);
+	TEST_ASSERT(map_size(map) == N);
+
+	// Υπάρχοντα keys: ο κόμβος κρατάει το παλιό key, οπότε το νέο το αποδεσμεύουμε εμείς
+	for (int i = 0; i < N; i++) {
+		bool inserted = true;
+		int* key = create_int(i);
+		MapNode node = map_find_or_insert_with(map, key, create_zero, &inserted);
+		TEST_ASSERT(!inserted);
+		TEST_ASSERT(map_node_key(map, node) != key);
+		(*(int*)map_node_value(map, node))++;
+		free(key);
+	}
+	TEST_ASSERT(created_values == N);
+	TEST_ASSERT(map_size(map) == N);
+
+	// Διαγραφή των μισών και επανεισαγωγή με τη map_find_or_insert (χωρίς inserted), η τιμή είναι NULL
+	for (int i = 0; i < N; i += 2)
+		TEST_ASSERT(map_remove(map, &i));
+	for (int i = 0; i < N; i += 2) {
+		MapNode node = map_find_or_insert(map, create_int(i), NULL);
+		TEST_ASSERT(map_node_value(map, node) == NULL);
+		map_node_set_value(map, node, create_int(-i));
+	}
+
+	// Η map_node_set_value κάνει destroy την παλιά τιμή (τα leaks τα ελέγχει το valgrind/ASan)
+	for (int i = 1; i < N; i += 2)
+		map_node_set_value(map, map_find_node(map, &i), create_int(2 * i));
+
+	TEST_ASSERT(map_size(map) == N);
+	for (int i = 0; i < N; i++)
+		TEST_ASSERT(*(int*)map_find(map, &i) == (i % 2 == 0 ? -i : 2 * i));
+	check_stats(map);
+	map_destroy(map);
+}
+
 // Λίστα με όλα τα tests προς εκτέλεση
 TEST_LIST = {
 	{ "test_create",		test_create },
@@ -428,6 +1012,20 @@ TEST_LIST = {
 	{ "test_iterate",		test_iterate },
 	{ "test_combined",		test_combined },
 	{ "test_combined2",		test_combined2 },
+	{ "test_mixed_hash",	test_mixed_hash },
+	{ "test_string_hash",	test_string_hash },
+	{ "test_hash64",		test_hash64 },
+	{ "test_stats",			test_stats },
+	{ "test_capacity_policy", test_capacity_policy },
+	{ "test_reserve",		test_reserve },
+	{ "test_insert_batch",	test_insert_batch },
+	{ "test_find_batch",	test_find_batch },
+	{ "test_iterate_cursor", test_iterate_cursor },
+	{ "test_iterate_sparse", test_iterate_sparse },
+	{ "test_shrink",		test_shrink },
+	{ "test_typed_map",		test_typed_map },
+	{ "test_find_or_insert", test_find_or_insert },
+	{ "test_neighbourhood",	test_neighbourhood },
 
 	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
 }; 
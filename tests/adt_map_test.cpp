@@ -0,0 +1,240 @@
+//////////////////////////////////////////////////////////////////
+//
+// Unit tests για το adt::HashMap (include/adt_map.hpp).
+// Κάθε test εκτελείται με όλα τα Policy (LinearProbing, Hopscotch, Hybrid),
+// και συγκρίνει το map με ένα std::unordered_map που δέχεται τις ίδιες πράξεις.
+//
+//////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "acutest.h"			// Απλή βιβλιοθήκη για unit testing
+#include "adt_map.hpp"
+
+
+// Hash για strings που δίνει το ίδιο hash code σε πολλά keys, ώστε να ελέγχονται και οι συγκρούσεις. Με 1024 hash
+// codes, τα keys ανά hash code πρέπει να είναι λίγα ώστε να χωράνε στη γειτονιά του Hopscotch (βλέπε adt::Hopscotch)
+struct CollidingHash {
+	size_t operator()(const std::string& key) const { return std::hash<std::string>()(key) & 0x3FF; }
+};
+
+// Hash με "seed" που επιλέγεται στον default constructor, διαφορετικό για κάθε αντικείμενο.
+// Ένα αντίγραφο του map βρίσκει τα keys μόνο αν αντιγράφει και το hasher.
+static uint64_t next_seed = 1;
+
+struct SeededHash {
+	uint64_t seed = next_seed++ * 0x9E3779B97F4A7C15ull;
+	size_t operator()(int key) const { return std::hash<int>()(key) ^ seed; }
+};
+
+// Τα values είναι move-only, ώστε οι try_emplace / emplace να ελέγχονται χωρίς αντιγραφές
+using Value = std::unique_ptr<int>;
+
+template <class Policy, class Hash = CollidingHash>
+using StringMap = adt::HashMap<std::string, Value, Hash, std::equal_to<std::string>, Policy>;
+
+template <class Policy>
+using IntMap = adt::HashMap<int, std::string, SeededHash, std::equal_to<int>, Policy>;
+
+// Απλός ψευδοτυχαίος αριθμός (xorshift), ώστε τα tests να είναι ντετερμινιστικά
+static uint random_next(uint* state) {
+	uint x = *state;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return *state = x;
+}
+
+// Ελέγχει ότι το map περιέχει ακριβώς τα στοιχεία του expected, και με τη διάσχιση και με τη find
+template <class Policy>
+static void check_equal(StringMap<Policy>& map, const std::unordered_map<std::string, int>& expected) {
+	TEST_ASSERT(map.size() == expected.size());
+	TEST_ASSERT(map.empty() == expected.empty());
+
+	size_t count = 0;
+	for (auto& [key, value] : map) {
+		auto it = expected.find(key);
+		TEST_ASSERT(it != expected.end() && value != nullptr && *value == it->second);
+		count++;
+	}
+	TEST_ASSERT(count == expected.size());
+
+	for (auto& [key, value] : expected) {
+		auto it = map.find(key);
+		TEST_ASSERT(it != map.end() && it->key == key && *it->value == value);
+	}
+}
+
+// Τυχαίες πράξεις σε ένα map και σε ένα std::unordered_map, τα οποία πρέπει να έχουν πάντα τα ίδια στοιχεία.
+// Τα keys είναι λίγα (οπότε πολλές πράξεις βρίσκουν το key), και οι διαγραφές συχνές (DELETED θέσεις, shrink).
+template <class Policy>
+void test_differential(void) {
+	StringMap<Policy> map;
+	std::unordered_map<std::string, int> expected;
+	uint state = 12345;
+
+	for (int i = 0; i < 200000; i++) {
+		std::string key = std::to_string(random_next(&state) % 3000);
+		int value = (int)(random_next(&state) % 1000);
+		bool exists = expected.count(key) != 0;
+
+		switch (random_next(&state) % 7) {
+		case 0: {
+			auto [it, inserted] = map.try_emplace(key, std::make_unique<int>(value));
+			TEST_ASSERT(inserted == !exists && it->key == key);
+			expected.try_emplace(key, value);
+			break;
+		}
+		case 1: {
+			auto [it, inserted] = map.emplace(key, std::make_unique<int>(value));
+			TEST_ASSERT(inserted == !exists && it->key == key);
+			expected.emplace(key, value);
+			break;
+		}
+		case 2: {
+			auto [it, inserted] = map.insert_or_assign(key, std::make_unique<int>(value));
+			TEST_ASSERT(inserted == !exists && *it->value == value);
+			expected.insert_or_assign(key, value);
+			break;
+		}
+		case 3:
+			map[key] = std::make_unique<int>(value);
+			expected[key] = value;
+			break;
+		case 4:
+		case 5:
+			TEST_ASSERT(map.erase(key) == expected.erase(key));
+			break;
+		default: {
+			const Value* found = map.find_value(key);
+			TEST_ASSERT((found != nullptr) == exists);
+			TEST_ASSERT(!exists || **found == expected[key]);
+			TEST_ASSERT(map.contains(key) == exists);
+			break;
+		}
+		}
+
+		// Περιοδικά ολόκληρη η διάσχιση (μεταξύ των διαγραφών)
+		if (i % 20000 == 0)
+			check_equal(map, expected);
+	}
+	check_equal(map, expected);
+
+	// Διαγραφή όλων εκτός από λίγα, και η διάσχιση βλέπει μόνο αυτά
+	std::vector<std::string> keys;
+	for (auto& [key, value] : expected)
+		keys.push_back(key);
+	for (size_t i = 0; i < keys.size(); i++) {
+		if (i % 100 == 0)
+			continue;
+		TEST_ASSERT(map.erase(keys[i]) == 1);
+		expected.erase(keys[i]);
+	}
+	check_equal(map, expected);
+}
+
+template <class Policy>
+void test_copy_move(void) {
+	IntMap<Policy> map;
+	for (int i = 0; i < 1000; i++)
+		map.try_emplace(i, std::to_string(i));
+	map.reserve(5000);
+
+	// Το αντίγραφο έχει τα ίδια στοιχεία, το ίδιο hasher και τον ίδιο χώρο, και είναι ανεξάρτητο
+	IntMap<Policy> copy(map);
+	TEST_ASSERT(copy.size() == 1000);
+	TEST_ASSERT(copy.capacity() == map.capacity());
+	for (int i = 0; i < 1000; i++)
+		TEST_ASSERT(copy.contains(i) && *copy.find_value(i) == std::to_string(i));
+
+	copy.erase(0);
+	copy[1] = "one";
+	TEST_ASSERT(map.size() == 1000 && *map.find_value(1) == "1");
+
+	// Μετά από erase, ο πίνακας του αντιγράφου δε μικραίνει κάτω από τον χώρο της reserve
+	for (int i = 0; i < 1000; i++)
+		copy.erase(i);
+	TEST_ASSERT(copy.empty() && copy.capacity() == map.capacity());
+
+	// Το move δε δεσμεύει μνήμη (noexcept, οπότε πχ το std::vector μετακινεί αντί να αντιγράφει)
+	static_assert(std::is_nothrow_move_constructible<IntMap<Policy>>::value, "HashMap move must be noexcept");
+	IntMap<Policy> moved(std::move(map));
+	TEST_ASSERT(moved.size() == 1000 && *moved.find_value(999) == "999");
+
+	// Το map μετά το move είναι κενό και μπορεί να ξαναχρησιμοποιηθεί
+	TEST_ASSERT(map.empty() && map.begin() == map.end());
+	TEST_ASSERT(!map.contains(1) && map.erase(1) == 0);
+	map.try_emplace(7, "seven");
+	TEST_ASSERT(map.size() == 1 && *map.find_value(7) == "seven");
+
+	// Assignment με αντιγραφή και με move
+	map = moved;
+	TEST_ASSERT(map.size() == 1000 && *map.find_value(500) == "500");
+	copy = std::move(moved);
+	TEST_ASSERT(copy.size() == 1000 && moved.empty());
+
+	std::vector<IntMap<Policy>> maps(2);
+	maps[0].try_emplace(1, "a");
+	maps.resize(100);
+	TEST_ASSERT(maps[0].size() == 1 && *maps[0].find_value(1) == "a");
+}
+
+template <class Policy>
+void test_clear(void) {
+	StringMap<Policy, std::hash<std::string>> map;
+	map.reserve(10000);
+	size_t capacity = map.capacity();
+
+	for (int round = 0; round < 3; round++) {
+		for (int i = 0; i < 20000; i++)
+			map.try_emplace(std::to_string(i), std::make_unique<int>(i));
+		TEST_ASSERT(map.size() == 20000);
+
+		// Η clear καταστρέφει τα στοιχεία, και ο πίνακας επιστρέφει στον χώρο της reserve
+		map.clear();
+		TEST_ASSERT(map.empty() && map.begin() == map.end());
+		TEST_ASSERT(map.capacity() == capacity);
+		TEST_ASSERT(!map.contains("1"));
+	}
+}
+
+// Οι εισαγωγές και διαγραφές (πχ οι DELETED θέσεις του LinearProbing) δεν μικραίνουν τον πίνακα κάτω από τη reserve
+template <class Policy>
+void test_reserve_floor(void) {
+	adt::HashMap<int, int, std::hash<int>, std::equal_to<int>, Policy> map;
+	map.reserve(100000);
+	size_t capacity = map.capacity();
+
+	for (int i = 0; i < 200000; i++) {
+		map.try_emplace(i, i);
+		map.erase(i);
+		TEST_ASSERT(map.capacity() >= capacity);
+	}
+	TEST_ASSERT(map.empty());
+
+	for (int i = 0; i < 100000; i++)
+		map.try_emplace(i, i);
+	TEST_ASSERT(map.capacity() == capacity);
+}
+
+
+// Λίστα με όλα τα tests προς εκτέλεση
+TEST_LIST = {
+	{ "test_differential_linear",		test_differential<adt::LinearProbing> },
+	{ "test_differential_hopscotch",	test_differential<adt::Hopscotch> },
+	{ "test_differential_hybrid",		test_differential<adt::Hybrid> },
+	{ "test_copy_move_linear",			test_copy_move<adt::LinearProbing> },
+	{ "test_copy_move_hopscotch",		test_copy_move<adt::Hopscotch> },
+	{ "test_copy_move_hybrid",			test_copy_move<adt::Hybrid> },
+	{ "test_clear_linear",				test_clear<adt::LinearProbing> },
+	{ "test_clear_hopscotch",			test_clear<adt::Hopscotch> },
+	{ "test_clear_hybrid",				test_clear<adt::Hybrid> },
+	{ "test_reserve_floor_linear",		test_reserve_floor<adt::LinearProbing> },
+	{ "test_reserve_floor_hopscotch",	test_reserve_floor<adt::Hopscotch> },
+	{ "test_reserve_floor_hybrid",		test_reserve_floor<adt::Hybrid> },
+	{ NULL, NULL } // τερματίζουμε τη λίστα με NULL
+};